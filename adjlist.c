@@ -8,12 +8,20 @@
 
 #include <stdio.h>
 #include <malloc.h>
-#include "header.h"
+#include <string.h>
+#include "graphio.h"
 
 //Stores the number to vertices 
 extern int gNoOfVertex;
 //Stores the desity of graph in percentage
 extern int gGraphDensity;
+//Seed for the random graph generator. 0 seeds from the clock
+extern unsigned int gRandomSeed;
+//Bumped whenever the loaded graph changes
+extern volatile int gGraphVersion;
+
+extern GraphFile* openGraphFile(char *fileName);
+extern AdjList* graphFileToAdjList(GraphFile *pstGraphFile);
 //The output is stored here. For simplicity take static memory and that too for
 //the largest possible dist[] matrix
 extern int dist[MAX_VERTEX_NUM][MAX_VERTEX_NUM];
@@ -85,10 +93,39 @@ AdjList* addToAdjList(AdjList *pstAdjList, int index, int vertex, int distance)
 	}
 
 	pstTraverser->next = pstListNode;
+	__sync_fetch_and_add(&gGraphVersion, 1);
 
 	return pstAdjList;
 }
 
+/* Sets the weight of the edge vertex1 -> vertex2. Returns TRUE if the edge exists, FALSE
+if not and ERR on sanity check failure */
+int setAdjListWeight(AdjList *pstAdjList, int vertex1, int vertex2, int distance)
+{
+	AdjList *pstTraverser = NULL_PTR;
+
+	if ((NULL_PTR == pstAdjList)
+		|| (vertex1 < 0) || (vertex1 >= gNoOfVertex)
+		|| (distance < 0))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	for (pstTraverser = pstAdjList[vertex1].next; NULL_PTR != pstTraverser;
+		pstTraverser = pstTraverser->next)
+	{
+		if (vertex2 == pstTraverser->vertexNum)
+		{
+			pstTraverser->distance = distance;
+			__sync_fetch_and_add(&gGraphVersion, 1);
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
 /* Return TRUE if a pair exists and updates the output variable distance
 else return FALSE if not found. ERR on sanity check failure */
 int doesPairExistsInAdjList(AdjList *pstAdjList, int vertex1, int vertex2, int *distance)
@@ -174,7 +211,7 @@ int buildRandomAdjList(AdjList *pstAdjList)
 	}
 	#endif
 
-	srand(time(NULL));
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
 
 	// edges in graph = total edges * density%.
 	noOfEdges = ((gNoOfVertex) * (gNoOfVertex - 1));
@@ -349,3 +386,232 @@ void destroyAdjList(AdjList *pstAdjList)
 	free(pstAdjList);
 	pstAdjList = NULL_PTR;
 }
+
+/* Returns a new adj list with every edge reversed, as needed by searches from the target.
+Returns NULL on failure */
+AdjList* buildReverseAdjList(AdjList *pstAdjList)
+{
+	AdjList *pstReverseList = NULL_PTR, *pstTraverser = NULL_PTR, *pstListNode = NULL_PTR;
+	AdjList **ppstTail = NULL_PTR;
+	int i;
+
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	pstReverseList = initAdjList();
+	ppstTail = (AdjList **)malloc(sizeof(AdjList *) * gNoOfVertex);
+	if ((NULL_PTR == pstReverseList) || (NULL_PTR == ppstTail))
+	{
+		myLog(ERROR, "Failed to allocate the reverse list!");
+		free(ppstTail);
+		free(pstReverseList);
+		return NULL_PTR;
+	}
+
+	/* Remember the tails so that appending is O(1) instead of a walk like addToAdjList() */
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		ppstTail[i] = &pstReverseList[i];
+	}
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		for (pstTraverser = pstAdjList[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			pstListNode = (AdjList *)malloc(sizeof(AdjList));
+			if (NULL_PTR == pstListNode)
+			{
+				myLog(ERROR, "malloc failed!");
+				free(ppstTail);
+				destroyAdjList(pstReverseList);
+				return NULL_PTR;
+			}
+
+			pstListNode->vertexNum = i;
+			pstListNode->distance = pstTraverser->distance;
+			pstListNode->next = NULL_PTR;
+
+			ppstTail[pstTraverser->vertexNum]->next = pstListNode;
+			ppstTail[pstTraverser->vertexNum] = pstListNode;
+		}
+	}
+
+	free(ppstTail);
+
+	return pstReverseList;
+}
+
+/* Returns a new adj list holding every edge in both directions, for the modes which treat
+the graph as undirected. Returns NULL on failure */
+AdjList* buildUndirectedAdjList(AdjList *pstAdjList)
+{
+	AdjList *pstUndirected = NULL_PTR, *pstTraverser = NULL_PTR, *pstListNode = NULL_PTR, *pstTail = NULL_PTR;
+	int i;
+
+	pstUndirected = buildReverseAdjList(pstAdjList);
+	if (NULL_PTR == pstUndirected)
+	{
+		myLog(ERROR, "buildReverseAdjList failed!");
+		return NULL_PTR;
+	}
+
+	/* Append the forward edges behind the reversed ones */
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		for (pstTail = &pstUndirected[i]; NULL_PTR != pstTail->next; pstTail = pstTail->next)
+		{
+		}
+
+		for (pstTraverser = pstAdjList[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			pstListNode = (AdjList *)malloc(sizeof(AdjList));
+			if (NULL_PTR == pstListNode)
+			{
+				myLog(ERROR, "malloc failed!");
+				destroyAdjList(pstUndirected);
+				return NULL_PTR;
+			}
+
+			pstListNode->vertexNum = pstTraverser->vertexNum;
+			pstListNode->distance = pstTraverser->distance;
+			pstListNode->next = NULL_PTR;
+
+			pstTail->next = pstListNode;
+			pstTail = pstListNode;
+		}
+	}
+
+	return pstUndirected;
+}
+
+/* Reads one edge of the text format. Costs below minDistance are not valid. Returns TRUE
+for a valid edge, FALSE for a line to skip and ERR at the end of the input */
+int readTextEdge(FILE *pFile, int maxVertexNum, int minDistance, int *v1, int *v2, int *distance)
+{
+	char fileLine[50];
+
+	if ((NULL == fgets(fileLine, 50, pFile)) || ('*' == fileLine[0]))
+	{
+		return ERR;
+	}
+
+	if (3 != sscanf(fileLine, "%d %d %d", v1, v2, distance))
+	{
+		return FALSE;
+	}
+
+	/* Take into account only valid vertices and edges */
+	return ((*v1 >= 0) && (*v1 < maxVertexNum)
+		&& (*v2 >= 0) && (*v2 < maxVertexNum)
+		&& (*distance >= minDistance) && (*distance < MAX_EDGE_COST));
+}
+
+/* Reads a graph from fileName. The file is either a binary graph file or the text format
+of the interactive file modes (<V1> <V2> <Cost> per line, '*' ends the input). Text graphs
+may use vertices up to maxVertexNum - 1 and costs from minDistance. gNoOfVertex is set for
+the loaded graph. Returns NULL on failure */
+AdjList* loadAdjListWithMinCost(char *fileName, int maxVertexNum, int minDistance)
+{
+	FILE *pFile = NULL_PTR;
+	GraphFile *pstGraphFile = NULL_PTR;
+	AdjList *pstAdjList = NULL_PTR;
+	char magic[GRAPH_FILE_MAGIC_LEN];
+	int v1, v2, distance, retVal;
+
+	if (NULL_PTR == fileName)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	pFile = fopen(fileName, "r");
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "File [%s] does not exist!", fileName);
+		return NULL_PTR;
+	}
+
+	/* Binary graph files are recognised by their magic */
+	if ((GRAPH_FILE_MAGIC_LEN == fread(magic, 1, GRAPH_FILE_MAGIC_LEN, pFile))
+		&& (0 == memcmp(magic, GRAPH_FILE_MAGIC, GRAPH_FILE_MAGIC_LEN)))
+	{
+		fclose(pFile);
+
+		pstGraphFile = openGraphFile(fileName);
+		if (NULL_PTR == pstGraphFile)
+		{
+			myLog(ERROR, "openGraphFile failed!");
+			return NULL_PTR;
+		}
+
+		if (pstGraphFile->pstHeader->noOfVertex > maxVertexNum)
+		{
+			myLog(ERROR, "[%s] has [%d] vertices, at most [%d] are supported here!",
+				fileName, pstGraphFile->pstHeader->noOfVertex, maxVertexNum);
+			closeGraphFile(pstGraphFile);
+			return NULL_PTR;
+		}
+
+		pstAdjList = graphFileToAdjList(pstGraphFile);
+		closeGraphFile(pstGraphFile);
+
+		return pstAdjList;
+	}
+
+	/* First pass finds the number of vertices so that the list is not oversized */
+	rewind(pFile);
+	gNoOfVertex = 0;
+
+	while (ERR != (retVal = readTextEdge(pFile, maxVertexNum, minDistance, &v1, &v2, &distance)))
+	{
+		if (TRUE == retVal)
+		{
+			/* Get the upperbound on the no of vertex in graph */
+			gNoOfVertex = MAX(gNoOfVertex, v1+1);
+			gNoOfVertex = MAX(gNoOfVertex, v2+1);
+		}
+	}
+
+	if (0 == gNoOfVertex)
+	{
+		myLog(ERROR, "No valid edges in [%s]!", fileName);
+		fclose(pFile);
+		return NULL_PTR;
+	}
+
+	/* Allocate sufficient memory for adjacency list */
+	pstAdjList = initAdjList();
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "initAdjList failed!");
+		fclose(pFile);
+		return NULL_PTR;
+	}
+
+	/* Second pass adds the edges */
+	rewind(pFile);
+
+	while (ERR != (retVal = readTextEdge(pFile, maxVertexNum, minDistance, &v1, &v2, &distance)))
+	{
+		if ((TRUE == retVal)
+			&& (NULL_PTR == addToAdjList(pstAdjList, v1, v2, distance)))
+		{
+			myLog(ERROR, "addToAdjList failed!");
+		}
+	}
+
+	fclose(pFile);
+
+	return pstAdjList;
+}
+
+/* Same as loadAdjListWithMinCost() for the positive costs every other mode expects */
+AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum)
+{
+	return loadAdjListWithMinCost(fileName, maxVertexNum, 1);
+}
@@ -0,0 +1,588 @@
+/***************************************************************************************************/
+// ALT.C
+// Contains all functions for the ALT search: landmark selection, the landmark section of the
+// binary graph format and the triangle inequality potential used by A*
+/***************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "graphio.h"
+#include "sssp.h"
+#include "alt.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern AdjList* buildReverseAdjList(AdjList *pstAdjList);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern GraphFile* openGraphFile(char *fileName);
+extern void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size);
+extern long long getWallTimeMsec();
+extern long long getWallTimeUsec();
+
+char *landmarkSelectionString[TOTAL_LANDMARK_SELECTIONS] = {"farthest", "avoid"};
+
+/* Points the table into a landmark section of size bytes. Returns ERR if the section
+does not fit a graph with noOfVertex vertices */
+int attachLandmarkTable(LandmarkTable *pstTable, void *pSection, long long size, int noOfVertex)
+{
+	LandmarkSectionHeader *pstHeader = (LandmarkSectionHeader *)pSection;
+
+	if ((NULL_PTR == pstTable) || (NULL_PTR == pSection)
+		|| (size < (long long)sizeof(LandmarkSectionHeader)))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	if ((pstHeader->noOfLandmarks <= 0) || (pstHeader->noOfLandmarks > MAX_LANDMARKS)
+		|| (pstHeader->noOfVertex != noOfVertex)
+		|| (size != LANDMARK_SECTION_SIZE(pstHeader->noOfLandmarks, pstHeader->noOfVertex)))
+	{
+		myLog(ERROR, "Landmark section does not match the graph!");
+		return ERR;
+	}
+
+	pstTable->noOfLandmarks = pstHeader->noOfLandmarks;
+	pstTable->noOfVertex = pstHeader->noOfVertex;
+	pstTable->piLandmarks = (int *)(pstHeader + 1);
+	pstTable->piFrom = pstTable->piLandmarks + pstTable->noOfLandmarks;
+	pstTable->piTo = pstTable->piFrom + ((long long)pstTable->noOfLandmarks * pstTable->noOfVertex);
+
+	return OK;
+}
+
+/* The ALT potential: the best triangle inequality bound on d(vertex, target) over all
+landmarks. A vertex which provably cannot reach the target gets INFINITY, which keeps
+it at the back of the queue */
+int altPotential(void *pPotentialCtx, int vertex)
+{
+	AltPotential *pstAlt = (AltPotential *)pPotentialCtx;
+	LandmarkTable *pstTable = pstAlt->pstTable;
+	int *piFrom, *piTo;
+	int l, bound = 0;
+
+	for (l = 0; l < pstTable->noOfLandmarks; l++)
+	{
+		piFrom = pstTable->piFrom + ((long long)l * pstTable->noOfVertex);
+		piTo = pstTable->piTo + ((long long)l * pstTable->noOfVertex);
+
+		/* d(v, t) >= d(L, t) - d(L, v) */
+		if (INFINITY != piFrom[vertex])
+		{
+			if (INFINITY == piFrom[pstAlt->target])
+			{
+				return INFINITY;
+			}
+			bound = MAX(bound, piFrom[pstAlt->target] - piFrom[vertex]);
+		}
+
+		/* d(v, t) >= d(v, L) - d(t, L) */
+		if (INFINITY != piTo[pstAlt->target])
+		{
+			if (INFINITY == piTo[vertex])
+			{
+				return INFINITY;
+			}
+			bound = MAX(bound, piTo[vertex] - piTo[pstAlt->target]);
+		}
+	}
+
+	return bound;
+}
+
+/* Fills the distances from and to landmark l of the table */
+int computeLandmarkDistances(SsspWorkspace *pstWorkspace, AdjList *pstAdjList,
+	AdjList *pstReverseList, LandmarkTable *pstTable, int l)
+{
+	long long rowOffset = (long long)l * pstTable->noOfVertex;
+
+	if (OK != ssspComputeRow(pstWorkspace, pstAdjList, pstTable->piLandmarks[l]))
+	{
+		return ERR;
+	}
+	(void)memcpy(pstTable->piFrom + rowOffset, pstWorkspace->piDist, sizeof(int) * pstTable->noOfVertex);
+
+	if (OK != ssspComputeRow(pstWorkspace, pstReverseList, pstTable->piLandmarks[l]))
+	{
+		return ERR;
+	}
+	(void)memcpy(pstTable->piTo + rowOffset, pstWorkspace->piDist, sizeof(int) * pstTable->noOfVertex);
+
+	return OK;
+}
+
+/* Returns TRUE if vertex is one of the first noOfLandmarks landmarks */
+int isLandmark(LandmarkTable *pstTable, int noOfLandmarks, int vertex)
+{
+	int l;
+
+	for (l = 0; l < noOfLandmarks; l++)
+	{
+		if (vertex == pstTable->piLandmarks[l])
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/* Farthest selection. The first landmark is the vertex farthest from a random vertex,
+every further one maximises the smallest round trip to the landmarks already picked.
+Returns the vertex, ERR on failure */
+int selectFarthestLandmark(SsspWorkspace *pstWorkspace, AdjList *pstAdjList,
+	LandmarkTable *pstTable, int noOfLandmarks)
+{
+	long long roundTrip, closest, best = -1;
+	int v, l, landmark = ERR;
+
+	if (0 == noOfLandmarks)
+	{
+		if (OK != ssspComputeRow(pstWorkspace, pstAdjList, rand() % pstTable->noOfVertex))
+		{
+			return ERR;
+		}
+
+		for (v = 0; v < pstTable->noOfVertex; v++)
+		{
+			if ((INFINITY != pstWorkspace->piDist[v]) && (pstWorkspace->piDist[v] > best))
+			{
+				best = pstWorkspace->piDist[v];
+				landmark = v;
+			}
+		}
+
+		return landmark;
+	}
+
+	for (v = 0; v < pstTable->noOfVertex; v++)
+	{
+		if (TRUE == isLandmark(pstTable, noOfLandmarks, v))
+		{
+			continue;
+		}
+
+		/* Vertices no landmark reaches either way count as infinitely far */
+		closest = (long long)INFINITY * 2;
+		for (l = 0; l < noOfLandmarks; l++)
+		{
+			roundTrip = (long long)pstTable->piFrom[((long long)l * pstTable->noOfVertex) + v]
+				+ pstTable->piTo[((long long)l * pstTable->noOfVertex) + v];
+			closest = MIN(closest, roundTrip);
+		}
+
+		if (closest > best)
+		{
+			best = closest;
+			landmark = v;
+		}
+	}
+
+	return landmark;
+}
+
+/* Orders avoid tree entries by decreasing distance for qsort() */
+int compareByDecreasingDist(const void *pLeft, const void *pRight)
+{
+	int left = ((AvoidTreeEntry *)pLeft)->distance, right = ((AvoidTreeEntry *)pRight)->distance;
+
+	return (left < right) ? 1 : ((left > right) ? -1 : 0);
+}
+
+/* Walks the avoid tree of the search from root in pstWorkspace and returns the leaf
+reached by always going to the heaviest child. The arrays are scratch of V entries */
+int walkAvoidTree(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, LandmarkTable *pstTable,
+	int noOfLandmarks, int root, long long *plSize, int *piParent, int *piHeaviestChild,
+	AvoidTreeEntry *pstOrder, char *pHasLandmark)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	int *piDist = pstWorkspace->piDist, *piFrom, *piTo;
+	int i, l, u, v, noOfReached = 0, bound;
+
+	/* Tree edges are the tight edges, every vertex takes the first one into it */
+	for (u = 0; u < pstTable->noOfVertex; u++)
+	{
+		piParent[u] = -1;
+		piHeaviestChild[u] = -1;
+		if (INFINITY != piDist[u])
+		{
+			pstOrder[noOfReached].distance = piDist[u];
+			pstOrder[noOfReached].vertex = u;
+			noOfReached++;
+		}
+	}
+
+	for (i = 0; i < noOfReached; i++)
+	{
+		u = pstOrder[i].vertex;
+		for (pstTraverser = pstAdjList[u].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			v = pstTraverser->vertexNum;
+			if ((root != v) && (-1 == piParent[v]) && (piDist[u] + pstTraverser->distance == piDist[v]))
+			{
+				piParent[v] = u;
+			}
+		}
+	}
+
+	/* Weights are d(root, v) minus the landmark bound on it */
+	for (i = 0; i < noOfReached; i++)
+	{
+		v = pstOrder[i].vertex;
+		bound = 0;
+		for (l = 0; l < noOfLandmarks; l++)
+		{
+			piFrom = pstTable->piFrom + ((long long)l * pstTable->noOfVertex);
+			piTo = pstTable->piTo + ((long long)l * pstTable->noOfVertex);
+
+			if ((INFINITY != piFrom[v]) && (INFINITY != piFrom[root]))
+			{
+				bound = MAX(bound, piFrom[v] - piFrom[root]);
+			}
+			if ((INFINITY != piTo[root]) && (INFINITY != piTo[v]))
+			{
+				bound = MAX(bound, piTo[root] - piTo[v]);
+			}
+		}
+
+		plSize[v] = piDist[v] - MIN(bound, piDist[v]);
+		pHasLandmark[v] = isLandmark(pstTable, noOfLandmarks, v);
+	}
+
+	/* Children are farther than their parents since every weight is positive, so going
+	by decreasing distance finishes a subtree before its root */
+	qsort(pstOrder, noOfReached, sizeof(AvoidTreeEntry), compareByDecreasingDist);
+
+	for (i = 0; i < noOfReached; i++)
+	{
+		v = pstOrder[i].vertex;
+		if (TRUE == pHasLandmark[v])
+		{
+			plSize[v] = 0;
+		}
+
+		u = piParent[v];
+		if (-1 == u)
+		{
+			continue;
+		}
+
+		if (TRUE == pHasLandmark[v])
+		{
+			pHasLandmark[u] = TRUE;
+		}
+		plSize[u] += plSize[v];
+
+		if ((-1 == piHeaviestChild[u]) || (plSize[v] > plSize[piHeaviestChild[u]]))
+		{
+			piHeaviestChild[u] = v;
+		}
+	}
+
+	/* Follow the heaviest children down to a leaf */
+	v = root;
+	while ((-1 != piHeaviestChild[v]) && (plSize[piHeaviestChild[v]] > 0))
+	{
+		v = piHeaviestChild[v];
+	}
+
+	return v;
+}
+
+/* Avoid selection. Grows a shortest path tree from a random root and weighs every vertex
+by how much the current landmarks underestimate its distance from the root. Subtrees that
+contain a landmark weigh nothing. The new landmark is the leaf reached by always going to
+the heaviest child. Returns the vertex, ERR on failure */
+int selectAvoidLandmark(SsspWorkspace *pstWorkspace, AdjList *pstAdjList,
+	LandmarkTable *pstTable, int noOfLandmarks)
+{
+	long long *plSize = NULL_PTR;
+	int *piParent = NULL_PTR, *piHeaviestChild = NULL_PTR;
+	AvoidTreeEntry *pstOrder = NULL_PTR;
+	char *pHasLandmark = NULL_PTR;
+	int root, leaf = ERR;
+
+	if (0 == noOfLandmarks)
+	{
+		return selectFarthestLandmark(pstWorkspace, pstAdjList, pstTable, 0);
+	}
+
+	root = rand() % pstTable->noOfVertex;
+	if (OK != ssspComputeRow(pstWorkspace, pstAdjList, root))
+	{
+		return ERR;
+	}
+
+	plSize = (long long *)malloc(sizeof(long long) * pstTable->noOfVertex);
+	piParent = (int *)malloc(sizeof(int) * pstTable->noOfVertex);
+	piHeaviestChild = (int *)malloc(sizeof(int) * pstTable->noOfVertex);
+	pstOrder = (AvoidTreeEntry *)malloc(sizeof(AvoidTreeEntry) * pstTable->noOfVertex);
+	pHasLandmark = (char *)calloc(pstTable->noOfVertex, sizeof(char));
+
+	if ((NULL_PTR == plSize) || (NULL_PTR == piParent) || (NULL_PTR == piHeaviestChild)
+		|| (NULL_PTR == pstOrder) || (NULL_PTR == pHasLandmark))
+	{
+		myLog(ERROR, "Failed to allocate the avoid tree!");
+	}
+	else
+	{
+		leaf = walkAvoidTree(pstWorkspace, pstAdjList, pstTable, noOfLandmarks, root,
+			plSize, piParent, piHeaviestChild, pstOrder, pHasLandmark);
+	}
+
+	free(plSize);
+	free(piParent);
+	free(piHeaviestChild);
+	free(pstOrder);
+	free(pHasLandmark);
+
+	/* Everything around the root is covered already */
+	if ((root == leaf) || ((ERR != leaf) && (TRUE == isLandmark(pstTable, noOfLandmarks, leaf))))
+	{
+		return selectFarthestLandmark(pstWorkspace, pstAdjList, pstTable, noOfLandmarks);
+	}
+
+	return leaf;
+}
+
+/* Picks noOfLandmarks landmarks with the given selection and computes their distances.
+Returns a landmark section ready to be stored, NULL on failure. size gets its length */
+void* buildLandmarkSection(AdjList *pstAdjList, int noOfLandmarks, int selection, long long *size)
+{
+	LandmarkSectionHeader *pstHeader = NULL_PTR;
+	LandmarkTable stTable;
+	AdjList *pstReverseList = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int l, landmark, retVal = OK;
+
+	*size = LANDMARK_SECTION_SIZE(noOfLandmarks, gNoOfVertex);
+
+	pstHeader = (LandmarkSectionHeader *)malloc((size_t)*size);
+	pstReverseList = buildReverseAdjList(pstAdjList);
+	pstWorkspace = createSsspWorkspace(BINARY_SCHEME, gNoOfVertex);
+	if ((NULL_PTR == pstHeader) || (NULL_PTR == pstReverseList) || (NULL_PTR == pstWorkspace))
+	{
+		myLog(ERROR, "Failed to set up landmark selection!");
+		retVal = ERR;
+	}
+	else
+	{
+		pstHeader->noOfLandmarks = noOfLandmarks;
+		pstHeader->noOfVertex = gNoOfVertex;
+		pstHeader->selection = selection;
+		pstHeader->reserved = 0;
+
+		(void)attachLandmarkTable(&stTable, pstHeader, *size, gNoOfVertex);
+	}
+
+	for (l = 0; (OK == retVal) && (l < noOfLandmarks); l++)
+	{
+		landmark = (LANDMARK_AVOID == selection)
+			? selectAvoidLandmark(pstWorkspace, pstAdjList, &stTable, l)
+			: selectFarthestLandmark(pstWorkspace, pstAdjList, &stTable, l);
+		if (ERR == landmark)
+		{
+			myLog(ERROR, "Could not pick landmark [%d]!", l);
+			retVal = ERR;
+			break;
+		}
+
+		stTable.piLandmarks[l] = landmark;
+
+		if (OK != computeLandmarkDistances(pstWorkspace, pstAdjList, pstReverseList, &stTable, l))
+		{
+			myLog(ERROR, "computeLandmarkDistances failed!");
+			retVal = ERR;
+			break;
+		}
+
+		myLog(INFO, "Landmark [%d]: vertex [%d]", l, landmark);
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	if (NULL_PTR != pstReverseList)
+	{
+		destroyAdjList(pstReverseList);
+	}
+
+	if (OK != retVal)
+	{
+		free(pstHeader);
+		return NULL_PTR;
+	}
+
+	return pstHeader;
+}
+
+/* Entry function for landmark preprocessing. Picks the landmarks for the binary graph file
+fileName and stores them in it, replacing any landmarks it had */
+int landmarkProc(char *fileName, char *landmarksArg, char *selectionArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	void *pSection = NULL_PTR;
+	long long size, startTime;
+	int noOfLandmarks = DEFAULT_LANDMARKS, selection = LANDMARK_AVOID, retVal;
+
+	if (NULL_PTR != landmarksArg)
+	{
+		noOfLandmarks = atoi(landmarksArg);
+	}
+
+	if (NULL_PTR != selectionArg)
+	{
+		for (selection = 0; selection < TOTAL_LANDMARK_SELECTIONS; selection++)
+		{
+			if (0 == strcmp(selectionArg, landmarkSelectionString[selection]))
+			{
+				break;
+			}
+		}
+	}
+
+	if ((noOfLandmarks <= 0) || (noOfLandmarks > MAX_LANDMARKS)
+		|| (TOTAL_LANDMARK_SELECTIONS == selection))
+	{
+		myLog(ERROR, "Invalid Input! Landmarks: 1 to [%d], selection: farthest or avoid", MAX_LANDMARKS);
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	noOfLandmarks = MIN(noOfLandmarks, gNoOfVertex);
+
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+	startTime = getWallTimeMsec();
+	pSection = buildLandmarkSection(pstAdjList, noOfLandmarks, selection, &size);
+	destroyAdjList(pstAdjList);
+
+	if (NULL_PTR == pSection)
+	{
+		myLog(ERROR, "buildLandmarkSection failed!");
+		return ERR;
+	}
+
+	printf("\nPicked [%d] landmarks (%s) in [%lld] msec\n", noOfLandmarks,
+		landmarkSelectionString[selection], getWallTimeMsec() - startTime);
+
+	/* Only binary graph files have room for the table */
+	retVal = setGraphFileSection(fileName, GRAPH_SECTION_LANDMARKS, pSection, size);
+	free(pSection);
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "Could not store the landmarks in [%s]! Convert it with -g first", fileName);
+		return ERR;
+	}
+
+	printf("Stored [%lld] bytes of landmarks in [%s]\n", size, fileName);
+
+	return OK;
+}
+
+/* Entry function for ALT mode. Answers source -> destination with plain Dijkstra and with
+ALT on the same heap, using the landmarks stored in the binary graph file fileName */
+int altProc(int scheme, char *fileName, char *sourceArg, char *destinationArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	GraphFile *pstGraphFile = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	LandmarkTable stTable;
+	AltPotential stAlt;
+	void *pSection = NULL_PTR;
+	long long size, startTime, plainUsec, altUsec;
+	int source, destination, plainDistance, plainSettled, altDistance, retVal = ERR;
+
+	if ((NULL_PTR == sourceArg) || (NULL_PTR == destinationArg))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	source = atoi(sourceArg);
+	destination = atoi(destinationArg);
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR != pstGraphFile)
+	{
+		pSection = getGraphFileSection(pstGraphFile, GRAPH_SECTION_LANDMARKS, &size);
+	}
+
+	if ((NULL_PTR == pSection) || (OK != attachLandmarkTable(&stTable, pSection, size, gNoOfVertex)))
+	{
+		myLog(ERROR, "[%s] has no usable landmarks! Run -lp on it first", fileName);
+	}
+	else if ((source < 0) || (source >= gNoOfVertex) || (destination < 0) || (destination >= gNoOfVertex))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", gNoOfVertex);
+	}
+	else if (NULL_PTR == (pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex)))
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+	}
+	else
+	{
+		startTime = getWallTimeUsec();
+		plainDistance = ssspPointToPoint(pstWorkspace, pstAdjList, source, destination);
+		plainUsec = getWallTimeUsec() - startTime;
+		plainSettled = pstWorkspace->noOfSettled;
+
+		stAlt.pstTable = &stTable;
+		stAlt.target = destination;
+		ssspSetPotential(pstWorkspace, altPotential, &stAlt);
+
+		startTime = getWallTimeUsec();
+		altDistance = ssspPointToPoint(pstWorkspace, pstAdjList, source, destination);
+		altUsec = getWallTimeUsec() - startTime;
+
+		if ((ERR == plainDistance) || (ERR == altDistance))
+		{
+			myLog(ERROR, "Search failed!");
+		}
+		else if (plainDistance != altDistance)
+		{
+			myLog(ERROR, "Plain search found [%d], ALT [%d]!", plainDistance, altDistance);
+		}
+		else
+		{
+			if (INFINITY == altDistance)
+			{
+				printf("%d -> %d: -\n", source, destination);
+			}
+			else
+			{
+				printf("%d -> %d: %d\n", source, destination, altDistance);
+			}
+
+			printf("\n%s: [%d] landmarks\n"
+				"Plain:\tSettled: [%d] Time: [%lld] usec\n"
+				"ALT:\tSettled: [%d] Time: [%lld] usec\n",
+				schemeString[scheme], stTable.noOfLandmarks,
+				plainSettled, plainUsec, pstWorkspace->noOfSettled, altUsec);
+
+			retVal = OK;
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	closeGraphFile(pstGraphFile);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
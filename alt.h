@@ -0,0 +1,63 @@
+/***************************************************************************************************/
+// ALT.H
+// Contains the landmark table of the ALT (A*, Landmarks, Triangle inequality) search
+/***************************************************************************************************/
+
+#ifndef __ALT__
+#define __ALT__
+
+#include "header.h"
+
+#define MAX_LANDMARKS 64
+#define DEFAULT_LANDMARKS 16
+
+typedef enum LANDMARK_SELECTION_ENUM
+{
+	LANDMARK_FARTHEST = 0, // Each landmark is as far as possible from the ones picked before
+	LANDMARK_AVOID, // Goldberg and Werneck: the leaf of the shortest path tree branch that
+			// the current landmarks bound worst
+	TOTAL_LANDMARK_SELECTIONS
+}LANDMARK_SELECTION_E;
+
+/* Start of the landmark section of a binary graph file. It is followed by
+int landmarks[noOfLandmarks], int from[noOfLandmarks][noOfVertex] (d(L, v)) and
+int to[noOfLandmarks][noOfVertex] (d(v, L)). INFINITY marks unreachable pairs */
+typedef struct LandmarkSectionHeader
+{
+	int noOfLandmarks;
+	int noOfVertex;
+	int selection; // LANDMARK_SELECTION_E
+	int reserved;
+}LandmarkSectionHeader;
+
+/* The landmark table in memory. The arrays point into a landmark section, either one
+being built or one mapped from a graph file */
+typedef struct LandmarkTable
+{
+	int noOfLandmarks;
+	int noOfVertex;
+	int *piLandmarks;
+	int *piFrom; // piFrom[(l * noOfVertex) + v] = d(landmark l, v)
+	int *piTo; // piTo[(l * noOfVertex) + v] = d(v, landmark l)
+}LandmarkTable;
+
+/* Context of the ALT potential of one query */
+typedef struct AltPotential
+{
+	LandmarkTable *pstTable;
+	int target;
+}AltPotential;
+
+/* A vertex of the avoid tree, sorted by distance from the root */
+typedef struct AvoidTreeEntry
+{
+	int distance;
+	int vertex;
+}AvoidTreeEntry;
+
+/* Bytes of a landmark section */
+#define LANDMARK_SECTION_SIZE(noOfLandmarks, noOfVertex) \
+	((long long)sizeof(LandmarkSectionHeader) + ((long long)sizeof(int) * (noOfLandmarks)) \
+	+ ((long long)sizeof(int) * 2 * (noOfLandmarks) * (noOfVertex)))
+
+#endif
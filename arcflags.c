@@ -0,0 +1,575 @@
+/***************************************************************************************************/
+// ARCFLAGS.C
+// Contains all functions of the arc flags search: partitioning the graph into cells, the
+// flags computed by backward searches from the cell boundaries, the arc flags section of the
+// binary graph format and the pruned point to point search
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "arcflags.h"
+#include "sssp.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern GraphFile* openGraphFile(char *fileName);
+extern void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size);
+extern long long getWallTimeMsec();
+extern long long getWallTimeUsec();
+
+/* Frees the reverse arrays of the graph */
+void destroyArcFlagReverse(ArcFlagGraph *pstGraph)
+{
+	free(pstGraph->piReverseOffsets);
+	free(pstGraph->piReverseEdges);
+	free(pstGraph->piTails);
+
+	pstGraph->piReverseOffsets = NULL_PTR;
+	pstGraph->piReverseEdges = NULL_PTR;
+	pstGraph->piTails = NULL_PTR;
+}
+
+/* Points the graph into the CSR sections of an opened graph file. The flags and cells
+are left empty. Returns ERR if the file has no usable CSR */
+int openArcFlagGraph(ArcFlagGraph *pstGraph, GraphFile *pstGraphFile)
+{
+	long long offsetsSize = 0, edgesSize = 0;
+
+	memset(pstGraph, 0, sizeof(ArcFlagGraph));
+
+	pstGraph->noOfVertex = pstGraphFile->pstHeader->noOfVertex;
+	pstGraph->noOfEdges = pstGraphFile->pstHeader->noOfEdges;
+	pstGraph->piOffsets = (int *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_OFFSETS, &offsetsSize);
+	pstGraph->pstEdges = (GraphFileEdge *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_EDGES, &edgesSize);
+
+	if ((NULL_PTR == pstGraph->piOffsets) || (NULL_PTR == pstGraph->pstEdges)
+		|| (offsetsSize != (long long)sizeof(int) * (pstGraph->noOfVertex + 1))
+		|| (edgesSize != (long long)sizeof(GraphFileEdge) * pstGraph->noOfEdges))
+	{
+		myLog(ERROR, "Graph file has no usable CSR sections!");
+		return ERR;
+	}
+
+	return OK;
+}
+
+/* Builds the reverse CSR of the graph, so that the backward searches can walk the edges
+into a vertex. Returns ERR on failure */
+int buildArcFlagReverse(ArcFlagGraph *pstGraph)
+{
+	int *piFill = NULL_PTR;
+	int u, e, v;
+
+	pstGraph->piReverseOffsets = (int *)calloc(pstGraph->noOfVertex + 1, sizeof(int));
+	pstGraph->piReverseEdges = (int *)malloc(sizeof(int) * (pstGraph->noOfEdges + 1));
+	pstGraph->piTails = (int *)malloc(sizeof(int) * (pstGraph->noOfEdges + 1));
+	piFill = (int *)malloc(sizeof(int) * pstGraph->noOfVertex);
+
+	if ((NULL_PTR == pstGraph->piReverseOffsets) || (NULL_PTR == pstGraph->piReverseEdges)
+		|| (NULL_PTR == pstGraph->piTails) || (NULL_PTR == piFill))
+	{
+		myLog(ERROR, "Failed to allocate the reverse graph for [%d] edges!", pstGraph->noOfEdges);
+		free(piFill);
+		destroyArcFlagReverse(pstGraph);
+		return ERR;
+	}
+
+	/* Count the edges into every vertex, then turn the counts into offsets */
+	for (e = 0; e < pstGraph->noOfEdges; e++)
+	{
+		pstGraph->piReverseOffsets[pstGraph->pstEdges[e].vertexNum + 1]++;
+	}
+
+	for (v = 0; v < pstGraph->noOfVertex; v++)
+	{
+		pstGraph->piReverseOffsets[v + 1] += pstGraph->piReverseOffsets[v];
+		piFill[v] = pstGraph->piReverseOffsets[v];
+	}
+
+	for (u = 0; u < pstGraph->noOfVertex; u++)
+	{
+		for (e = pstGraph->piOffsets[u]; e < pstGraph->piOffsets[u + 1]; e++)
+		{
+			pstGraph->piTails[e] = u;
+			pstGraph->piReverseEdges[piFill[pstGraph->pstEdges[e].vertexNum]++] = e;
+		}
+	}
+
+	free(piFill);
+
+	return OK;
+}
+
+/* Splits the vertices into noOfCells cells by growing them breadth first, ignoring the
+edge directions, from random seeds at the same time. Vertices no seed reaches start
+cells of their own, numbered round robin */
+int partitionArcFlagGraph(ArcFlagGraph *pstGraph, int noOfCells)
+{
+	int *piQueue = NULL_PTR, *piCells = pstGraph->piCells;
+	int i, head = 0, tail = 0, u, v, e, vertex, nextCell = 0;
+
+	piQueue = (int *)malloc(sizeof(int) * pstGraph->noOfVertex);
+	if (NULL_PTR == piQueue)
+	{
+		myLog(ERROR, "malloc failed!");
+		return ERR;
+	}
+
+	for (v = 0; v < pstGraph->noOfVertex; v++)
+	{
+		piCells[v] = -1;
+	}
+
+	for (i = 0; i < noOfCells; i++)
+	{
+		vertex = rand() % pstGraph->noOfVertex;
+		if (-1 == piCells[vertex])
+		{
+			piCells[vertex] = nextCell++ % noOfCells;
+			piQueue[tail++] = vertex;
+		}
+	}
+
+	for (vertex = 0; vertex < pstGraph->noOfVertex; vertex++)
+	{
+		if (-1 == piCells[vertex])
+		{
+			piCells[vertex] = nextCell++ % noOfCells;
+			piQueue[tail++] = vertex;
+		}
+
+		while (head < tail)
+		{
+			u = piQueue[head++];
+
+			for (e = pstGraph->piOffsets[u]; e < pstGraph->piOffsets[u + 1]; e++)
+			{
+				v = pstGraph->pstEdges[e].vertexNum;
+				if (-1 == piCells[v])
+				{
+					piCells[v] = piCells[u];
+					piQueue[tail++] = v;
+				}
+			}
+
+			for (e = pstGraph->piReverseOffsets[u]; e < pstGraph->piReverseOffsets[u + 1]; e++)
+			{
+				v = pstGraph->piTails[pstGraph->piReverseEdges[e]];
+				if (-1 == piCells[v])
+				{
+					piCells[v] = piCells[u];
+					piQueue[tail++] = v;
+				}
+			}
+		}
+	}
+
+	free(piQueue);
+
+	return OK;
+}
+
+/* Dijkstra from boundary over the reverse graph, so piDist gets d(v, boundary). Then every
+edge u -> v with d(u, boundary) = w(u, v) + d(v, boundary) lies on a shortest path into
+the cell of boundary and gets its flag */
+int flagEdgesToBoundary(SsspWorkspace *pstWorkspace, ArcFlagGraph *pstGraph, int boundary)
+{
+	ArcFlagMask cellBit = ((ArcFlagMask)1) << pstGraph->piCells[boundary];
+	int i, u, e, vertex, distance;
+
+	resetSsspWorkspace(pstWorkspace);
+
+	if (OK != ssspRelax(pstWorkspace, boundary, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		pstWorkspace->noOfSettled++;
+
+		for (i = pstGraph->piReverseOffsets[vertex]; i < pstGraph->piReverseOffsets[vertex + 1]; i++)
+		{
+			e = pstGraph->piReverseEdges[i];
+			u = pstGraph->piTails[e];
+			if (TRUE == pstWorkspace->pSettled[u])
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, u, distance + pstGraph->pstEdges[e].distance))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	/* Only the reached vertices can start such an edge */
+	for (i = 0; i < pstWorkspace->noOfTouched; i++)
+	{
+		u = pstWorkspace->piTouched[i];
+
+		for (e = pstGraph->piOffsets[u]; e < pstGraph->piOffsets[u + 1]; e++)
+		{
+			if (pstWorkspace->piDist[u]
+				== pstGraph->pstEdges[e].distance + pstWorkspace->piDist[pstGraph->pstEdges[e].vertexNum])
+			{
+				pstGraph->pFlags[e] |= cellBit;
+			}
+		}
+	}
+
+	return OK;
+}
+
+/* Returns an arc flags section for noOfCells cells, its length in size. The reverse
+graph of pstGraph must be built. The caller frees it. NULL on failure */
+void* buildArcFlagSection(ArcFlagGraph *pstGraph, int noOfCells, long long *size)
+{
+	ArcFlagSectionHeader *pstHeader = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int u, e, v, isBoundary;
+
+	*size = ARC_FLAG_SECTION_SIZE(pstGraph->noOfVertex, pstGraph->noOfEdges);
+	pstHeader = (ArcFlagSectionHeader *)calloc(1, (size_t)*size);
+	pstWorkspace = createSsspWorkspace(BINARY_SCHEME, pstGraph->noOfVertex);
+	if ((NULL_PTR == pstHeader) || (NULL_PTR == pstWorkspace))
+	{
+		myLog(ERROR, "Failed to allocate [%lld] bytes of arc flags!", *size);
+		free(pstHeader);
+		destroySsspWorkspace(pstWorkspace);
+		return NULL_PTR;
+	}
+
+	pstHeader->noOfCells = noOfCells;
+	pstHeader->noOfVertex = pstGraph->noOfVertex;
+	pstHeader->noOfEdges = pstGraph->noOfEdges;
+
+	pstGraph->noOfCells = noOfCells;
+	pstGraph->pFlags = (ArcFlagMask *)(pstHeader + 1);
+	pstGraph->piCells = (int *)(pstGraph->pFlags + pstGraph->noOfEdges);
+
+	if (OK != partitionArcFlagGraph(pstGraph, noOfCells))
+	{
+		free(pstHeader);
+		destroySsspWorkspace(pstWorkspace);
+		return NULL_PTR;
+	}
+
+	/* An edge inside a cell leads into it */
+	for (u = 0; u < pstGraph->noOfVertex; u++)
+	{
+		for (e = pstGraph->piOffsets[u]; e < pstGraph->piOffsets[u + 1]; e++)
+		{
+			if (pstGraph->piCells[u] == pstGraph->piCells[pstGraph->pstEdges[e].vertexNum])
+			{
+				pstGraph->pFlags[e] |= ((ArcFlagMask)1) << pstGraph->piCells[u];
+			}
+		}
+	}
+
+	/* Every other shortest path into a cell enters it at a boundary vertex */
+	for (v = 0; v < pstGraph->noOfVertex; v++)
+	{
+		isBoundary = FALSE;
+		for (e = pstGraph->piReverseOffsets[v]; e < pstGraph->piReverseOffsets[v + 1]; e++)
+		{
+			if (pstGraph->piCells[pstGraph->piTails[pstGraph->piReverseEdges[e]]] != pstGraph->piCells[v])
+			{
+				isBoundary = TRUE;
+				break;
+			}
+		}
+
+		if (FALSE == isBoundary)
+		{
+			continue;
+		}
+
+		pstHeader->noOfBoundary++;
+
+		if (OK != flagEdgesToBoundary(pstWorkspace, pstGraph, v))
+		{
+			free(pstHeader);
+			destroySsspWorkspace(pstWorkspace);
+			return NULL_PTR;
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+
+	return pstHeader;
+}
+
+/* Points the flags and cells of the graph into an arc flags section of size bytes.
+Returns ERR if the section does not fit the graph */
+int attachArcFlags(ArcFlagGraph *pstGraph, void *pSection, long long size)
+{
+	ArcFlagSectionHeader *pstHeader = (ArcFlagSectionHeader *)pSection;
+
+	if ((NULL_PTR == pstGraph) || (NULL_PTR == pSection)
+		|| (size < (long long)sizeof(ArcFlagSectionHeader)))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	if ((pstHeader->noOfCells <= 0) || (pstHeader->noOfCells > MAX_ARC_FLAG_CELLS)
+		|| (pstHeader->noOfVertex != pstGraph->noOfVertex)
+		|| (pstHeader->noOfEdges != pstGraph->noOfEdges)
+		|| (size != ARC_FLAG_SECTION_SIZE(pstHeader->noOfVertex, pstHeader->noOfEdges)))
+	{
+		myLog(ERROR, "Arc flags section does not match the graph!");
+		return ERR;
+	}
+
+	pstGraph->noOfCells = pstHeader->noOfCells;
+	pstGraph->pFlags = (ArcFlagMask *)(pstHeader + 1);
+	pstGraph->piCells = (int *)(pstGraph->pFlags + pstGraph->noOfEdges);
+
+	return OK;
+}
+
+/* Dijkstra from source which stops when target is settled and skips every edge whose flag
+for the cell of target is not set. Returns the distance, INFINITY if target is not
+reachable and ERR on failure */
+int arcFlagPointToPoint(SsspWorkspace *pstWorkspace, ArcFlagGraph *pstGraph, int source, int target)
+{
+	ArcFlagMask targetBit;
+	int e, vertex, distance;
+
+	if ((NULL_PTR == pstWorkspace) || (NULL_PTR == pstGraph) || (NULL_PTR == pstGraph->pFlags)
+		|| (source < 0) || (source >= pstGraph->noOfVertex)
+		|| (target < 0) || (target >= pstGraph->noOfVertex))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	targetBit = ((ArcFlagMask)1) << pstGraph->piCells[target];
+
+	resetSsspWorkspace(pstWorkspace);
+
+	if (OK != ssspRelax(pstWorkspace, source, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		pstWorkspace->noOfSettled++;
+
+		if (target == vertex)
+		{
+			break;
+		}
+
+		for (e = pstGraph->piOffsets[vertex]; e < pstGraph->piOffsets[vertex + 1]; e++)
+		{
+			if ((0 == (pstGraph->pFlags[e] & targetBit))
+				|| (TRUE == pstWorkspace->pSettled[pstGraph->pstEdges[e].vertexNum]))
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, pstGraph->pstEdges[e].vertexNum,
+				distance + pstGraph->pstEdges[e].distance))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	return pstWorkspace->piDist[target];
+}
+
+/* Entry function for arc flags preprocessing. Partitions the binary graph file fileName
+into cells, computes the flags of its edges and stores them in it, replacing any flags
+it had */
+int arcFlagPrepProc(char *fileName, char *cellsArg)
+{
+	GraphFile *pstGraphFile = NULL_PTR;
+	ArcFlagGraph stGraph;
+	ArcFlagMask mask;
+	void *pSection = NULL_PTR;
+	long long size, startTime, noOfSetFlags = 0;
+	int e, noOfCells = DEFAULT_ARC_FLAG_CELLS, retVal;
+
+	if (NULL_PTR != cellsArg)
+	{
+		noOfCells = atoi(cellsArg);
+	}
+
+	if ((noOfCells <= 0) || (noOfCells > MAX_ARC_FLAG_CELLS))
+	{
+		myLog(ERROR, "Invalid Input! Cells: 1 to [%d]", MAX_ARC_FLAG_CELLS);
+		return ERR;
+	}
+
+	pstGraphFile = openGraphFile(fileName);
+	if ((NULL_PTR == pstGraphFile) || (OK != openArcFlagGraph(&stGraph, pstGraphFile)))
+	{
+		myLog(ERROR, "[%s] is not a binary graph file! Convert it with -g first", fileName);
+		closeGraphFile(pstGraphFile);
+		return ERR;
+	}
+
+	noOfCells = MIN(noOfCells, stGraph.noOfVertex);
+
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+	startTime = getWallTimeMsec();
+
+	if (OK == buildArcFlagReverse(&stGraph))
+	{
+		pSection = buildArcFlagSection(&stGraph, noOfCells, &size);
+		destroyArcFlagReverse(&stGraph);
+	}
+
+	/* The section has to be written after the mapping is gone */
+	closeGraphFile(pstGraphFile);
+
+	if (NULL_PTR == pSection)
+	{
+		myLog(ERROR, "buildArcFlagSection failed!");
+		return ERR;
+	}
+
+	for (e = 0; e < stGraph.noOfEdges; e++)
+	{
+		for (mask = stGraph.pFlags[e]; 0 != mask; mask &= (mask - 1))
+		{
+			noOfSetFlags++;
+		}
+	}
+
+	printf("\nFlagged [%d] edges for [%d] cells in [%lld] msec, [%d] boundary vertices, "
+		"[%lld] of [%lld] flags set\n", stGraph.noOfEdges, noOfCells, getWallTimeMsec() - startTime,
+		((ArcFlagSectionHeader *)pSection)->noOfBoundary, noOfSetFlags,
+		(long long)stGraph.noOfEdges * noOfCells);
+
+	retVal = setGraphFileSection(fileName, GRAPH_SECTION_ARC_FLAGS, pSection, size);
+	free(pSection);
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "Could not store the arc flags in [%s]!", fileName);
+		return ERR;
+	}
+
+	printf("Stored [%lld] bytes of arc flags in [%s]\n", size, fileName);
+
+	return OK;
+}
+
+/* Entry function for arc flags mode. Answers source -> destination with plain Dijkstra
+and with the arc flags stored in the binary graph file fileName on the same heap */
+int arcFlagProc(int scheme, char *fileName, char *sourceArg, char *destinationArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	GraphFile *pstGraphFile = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	ArcFlagGraph stGraph;
+	void *pSection = NULL_PTR;
+	long long size, startTime, plainUsec, flagUsec;
+	int source, destination, plainDistance, plainSettled, flagDistance, retVal = ERR;
+
+	if ((NULL_PTR == sourceArg) || (NULL_PTR == destinationArg))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	source = atoi(sourceArg);
+	destination = atoi(destinationArg);
+
+	pstGraphFile = openGraphFile(fileName);
+	if ((NULL_PTR != pstGraphFile) && (OK == openArcFlagGraph(&stGraph, pstGraphFile)))
+	{
+		pSection = getGraphFileSection(pstGraphFile, GRAPH_SECTION_ARC_FLAGS, &size);
+	}
+
+	if ((NULL_PTR == pSection) || (OK != attachArcFlags(&stGraph, pSection, size)))
+	{
+		myLog(ERROR, "[%s] has no usable arc flags! Run -fp on it first", fileName);
+	}
+	else if ((source < 0) || (source >= gNoOfVertex) || (destination < 0) || (destination >= gNoOfVertex))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", gNoOfVertex);
+	}
+	else if (NULL_PTR == (pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex)))
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+	}
+	else
+	{
+		startTime = getWallTimeUsec();
+		plainDistance = ssspPointToPoint(pstWorkspace, pstAdjList, source, destination);
+		plainUsec = getWallTimeUsec() - startTime;
+		plainSettled = pstWorkspace->noOfSettled;
+
+		startTime = getWallTimeUsec();
+		flagDistance = arcFlagPointToPoint(pstWorkspace, &stGraph, source, destination);
+		flagUsec = getWallTimeUsec() - startTime;
+
+		if ((ERR == plainDistance) || (ERR == flagDistance))
+		{
+			myLog(ERROR, "Search failed!");
+		}
+		else if (plainDistance != flagDistance)
+		{
+			myLog(ERROR, "Plain search found [%d], arc flags [%d]!", plainDistance, flagDistance);
+		}
+		else
+		{
+			if (INFINITY == flagDistance)
+			{
+				printf("%d -> %d: -\n", source, destination);
+			}
+			else
+			{
+				printf("%d -> %d: %d\n", source, destination, flagDistance);
+			}
+
+			printf("\n%s: [%d] cells\n"
+				"Plain:\tSettled: [%d] Time: [%lld] usec\n"
+				"Flags:\tSettled: [%d] Time: [%lld] usec\n",
+				schemeString[scheme], stGraph.noOfCells,
+				plainSettled, plainUsec, pstWorkspace->noOfSettled, flagUsec);
+
+			retVal = OK;
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	closeGraphFile(pstGraphFile);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
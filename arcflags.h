@@ -0,0 +1,48 @@
+/***************************************************************************************************/
+// ARCFLAGS.H
+// Contains the partition and the edge flags of the arc flags search
+/***************************************************************************************************/
+
+#ifndef __ARCFLAGS__
+#define __ARCFLAGS__
+
+#include "graphio.h"
+
+#define MAX_ARC_FLAG_CELLS 64 // One bit per cell in an ArcFlagMask
+#define DEFAULT_ARC_FLAG_CELLS 32
+
+/* Bit c of the mask of an edge is set if the edge starts a shortest path into cell c */
+typedef unsigned long long ArcFlagMask;
+
+/* Start of the arc flags section of a binary graph file. It is followed by
+ArcFlagMask flags[noOfEdges], in the order of the edge section, and int cells[noOfVertex] */
+typedef struct ArcFlagSectionHeader
+{
+	int noOfCells;
+	int noOfVertex;
+	int noOfEdges;
+	int noOfBoundary; // Vertices with an edge coming in from another cell
+}ArcFlagSectionHeader;
+
+/* A graph file opened for the arc flags search. The CSR arrays point into the mapping.
+The reverse arrays are only built for the preprocessing */
+typedef struct ArcFlagGraph
+{
+	int noOfVertex;
+	int noOfEdges;
+	int noOfCells;
+	int *piOffsets;
+	GraphFileEdge *pstEdges;
+	ArcFlagMask *pFlags;
+	int *piCells;
+	int *piReverseOffsets; // Edges into v are piReverseEdges[piReverseOffsets[v] ...]
+	int *piReverseEdges; // Index into pstEdges
+	int *piTails; // piTails[e] is the vertex edge e starts at
+}ArcFlagGraph;
+
+/* Bytes of an arc flags section */
+#define ARC_FLAG_SECTION_SIZE(noOfVertex, noOfEdges) \
+	((long long)sizeof(ArcFlagSectionHeader) + ((long long)sizeof(ArcFlagMask) * (noOfEdges)) \
+	+ ((long long)sizeof(int) * (noOfVertex)))
+
+#endif
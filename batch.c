@@ -0,0 +1,522 @@
+/***************************************************************************************************/
+// BATCH.C
+// Contains all functions for the batched query mode. The queries of a file are grouped by
+// source and every group is answered by one search which stops at its last target
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sssp.h"
+#include "stream.h"
+#include "batch.h"
+
+extern int gNoOfVertex;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeMsec();
+
+/* Shared by the workers of one batch */
+typedef struct BatchCtx
+{
+	int scheme;
+	AdjList *pstAdjList;
+	BatchQuery *pstQueries; // Sorted by source
+	int *piGroupStarts; // Group g is [piGroupStarts[g], piGroupStarts[g + 1]) of pstQueries
+	int noOfGroups;
+	int *piAnswers; // In the order of the file
+	int **ppiPaths; // Path of every query in the order of the file, NULL unless asked for
+	int *piPathLengths;
+	volatile int nextGroup; // Next group to hand out
+	volatile long long noOfSettled;
+	volatile int hasFailed;
+}BatchCtx;
+
+/* Reads the "s t" lines of fileName. Other lines are skipped. noOfQueries gets the count.
+Returns NULL on failure */
+BatchQuery* readBatchQueries(char *fileName, int *noOfQueries)
+{
+	BatchQuery *pstQueries = NULL_PTR, *pstResized = NULL_PTR;
+	FILE *pFile = NULL_PTR;
+	char fileLine[128];
+	int source, target, capacity = 1024;
+
+	pFile = fopen(fileName, "r");
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "Could not open [%s]!", fileName);
+		return NULL_PTR;
+	}
+
+	pstQueries = (BatchQuery *)malloc(sizeof(BatchQuery) * capacity);
+	*noOfQueries = 0;
+
+	while ((NULL_PTR != pstQueries) && (NULL_PTR != fgets(fileLine, sizeof(fileLine), pFile)))
+	{
+		if (2 != sscanf(fileLine, "%d %d", &source, &target))
+		{
+			continue;
+		}
+
+		if ((source < 0) || (source >= gNoOfVertex) || (target < 0) || (target >= gNoOfVertex))
+		{
+			myLog(ERROR, "Query [%d -> %d] out of range! Vertices: [%d]", source, target, gNoOfVertex);
+			free(pstQueries);
+			pstQueries = NULL_PTR;
+			break;
+		}
+
+		if (*noOfQueries == capacity)
+		{
+			capacity *= 2;
+			pstResized = (BatchQuery *)realloc(pstQueries, sizeof(BatchQuery) * capacity);
+			if (NULL_PTR == pstResized)
+			{
+				myLog(ERROR, "realloc failed!");
+				free(pstQueries);
+				pstQueries = NULL_PTR;
+				break;
+			}
+			pstQueries = pstResized;
+		}
+
+		pstQueries[*noOfQueries].source = source;
+		pstQueries[*noOfQueries].target = target;
+		pstQueries[*noOfQueries].index = *noOfQueries;
+		(*noOfQueries)++;
+	}
+
+	fclose(pFile);
+
+	if ((NULL_PTR != pstQueries) && (0 == *noOfQueries))
+	{
+		myLog(ERROR, "No \"s t\" queries in [%s]!", fileName);
+		free(pstQueries);
+		pstQueries = NULL_PTR;
+	}
+
+	return pstQueries;
+}
+
+/* qsort comparator which orders queries by source, then target */
+int compareBatchQueries(const void *pLeft, const void *pRight)
+{
+	BatchQuery *pstLeft = (BatchQuery *)pLeft, *pstRight = (BatchQuery *)pRight;
+
+	if (pstLeft->source != pstRight->source)
+	{
+		return (pstLeft->source > pstRight->source) - (pstLeft->source < pstRight->source);
+	}
+
+	return (pstLeft->target > pstRight->target) - (pstLeft->target < pstRight->target);
+}
+
+/* Answers the noOfQueries queries of one source with one search, which stops once every
+target of the group is settled. piWanted[v] is stamp for the targets still to settle */
+int batchSearch(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, BatchQuery *pstQueries,
+	int noOfQueries, int *piWanted, int stamp, int *piAnswers)
+{
+	int i, closestVertex, noOfRemaining = 0;
+
+	resetSsspWorkspace(pstWorkspace);
+
+	for (i = 0; i < noOfQueries; i++)
+	{
+		if (stamp != piWanted[pstQueries[i].target])
+		{
+			piWanted[pstQueries[i].target] = stamp;
+			noOfRemaining++;
+		}
+	}
+
+	if (OK != ssspRelax(pstWorkspace, pstQueries[0].source, 0))
+	{
+		return ERR;
+	}
+
+	while ((noOfRemaining > 0) && (FALSE == pqIsEmpty(pstWorkspace->pstQueue)))
+	{
+		if (OK != ssspSettleNext(pstWorkspace, pstAdjList, NULL_PTR, NULL_PTR, &closestVertex))
+		{
+			return ERR;
+		}
+
+		noOfRemaining -= (stamp == piWanted[closestVertex]);
+	}
+
+	/* A target left unsettled is unreachable, so its distance is INFINITY */
+	for (i = 0; i < noOfQueries; i++)
+	{
+		piAnswers[pstQueries[i].index] = (TRUE == pstWorkspace->pSettled[pstQueries[i].target])
+			? pstWorkspace->piDist[pstQueries[i].target] : INFINITY;
+	}
+
+	return OK;
+}
+
+/* Copies the paths of the noOfQueries queries of one group out of the last search, each
+rebuilt from the predecessors in O(path length) */
+int storeBatchPaths(BatchCtx *pstCtx, SsspWorkspace *pstWorkspace, BatchQuery *pstQueries,
+	int noOfQueries, int *piPath)
+{
+	int i, length;
+
+	for (i = 0; i < noOfQueries; i++)
+	{
+		length = ssspGetPath(pstWorkspace, pstQueries[i].source, pstQueries[i].target, piPath);
+		if (ERR == length)
+		{
+			return ERR;
+		}
+
+		pstCtx->ppiPaths[pstQueries[i].index] = (int *)malloc(sizeof(int) * MAX(length, 1));
+		if (NULL_PTR == pstCtx->ppiPaths[pstQueries[i].index])
+		{
+			myLog(ERROR, "malloc failed!");
+			return ERR;
+		}
+
+		(void)memcpy(pstCtx->ppiPaths[pstQueries[i].index], piPath, sizeof(int) * length);
+		pstCtx->piPathLengths[pstQueries[i].index] = length;
+	}
+
+	return OK;
+}
+
+/* Worker loop. Takes the next source group until all are answered */
+void* batchWorker(void *pArg)
+{
+	BatchCtx *pstCtx = (BatchCtx *)pArg;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int *piWanted = NULL_PTR, *piPath = NULL_PTR;
+	long long noOfSettled = 0;
+	int group, start;
+
+	pstWorkspace = createSsspWorkspace(pstCtx->scheme, gNoOfVertex);
+	piWanted = (int *)calloc(gNoOfVertex, sizeof(int));
+
+	if ((NULL_PTR != pstCtx->ppiPaths) && (NULL_PTR != pstWorkspace)
+		&& (OK == ssspEnablePredecessors(pstWorkspace)))
+	{
+		piPath = (int *)malloc(sizeof(int) * gNoOfVertex);
+	}
+
+	if ((NULL_PTR == pstWorkspace) || (NULL_PTR == piWanted)
+		|| ((NULL_PTR != pstCtx->ppiPaths) && (NULL_PTR == piPath)))
+	{
+		myLog(ERROR, "Failed to allocate the worker state!");
+		pstCtx->hasFailed = TRUE;
+	}
+
+	while (FALSE == pstCtx->hasFailed)
+	{
+		group = __sync_fetch_and_add(&pstCtx->nextGroup, 1);
+		if (group >= pstCtx->noOfGroups)
+		{
+			break;
+		}
+
+		/* Groups are numbered from 1 in piWanted, which starts zeroed */
+		start = pstCtx->piGroupStarts[group];
+		if (OK != batchSearch(pstWorkspace, pstCtx->pstAdjList, pstCtx->pstQueries + start,
+			pstCtx->piGroupStarts[group + 1] - start, piWanted, group + 1, pstCtx->piAnswers))
+		{
+			myLog(ERROR, "batchSearch failed for source [%d]!", pstCtx->pstQueries[start].source);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+
+		if ((NULL_PTR != pstCtx->ppiPaths) && (OK != storeBatchPaths(pstCtx, pstWorkspace,
+			pstCtx->pstQueries + start, pstCtx->piGroupStarts[group + 1] - start, piPath)))
+		{
+			myLog(ERROR, "storeBatchPaths failed for source [%d]!", pstCtx->pstQueries[start].source);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+
+		noOfSettled += pstWorkspace->noOfSettled;
+	}
+
+	__sync_fetch_and_add(&pstCtx->noOfSettled, noOfSettled);
+
+	free(piPath);
+	free(piWanted);
+	destroySsspWorkspace(pstWorkspace);
+
+	return NULL_PTR;
+}
+
+/* Answers every group of pstCtx with noOfThreads workers. Returns the time taken in
+msec, INVALID_TIME on failure */
+int runBatchQueries(BatchCtx *pstCtx, int noOfThreads)
+{
+	pthread_t aThreads[MAX_WORKER_THREADS];
+	long long startTime;
+	int i, noOfStarted = 0;
+
+	pstCtx->nextGroup = 0;
+	pstCtx->noOfSettled = 0;
+	pstCtx->hasFailed = FALSE;
+
+	startTime = getWallTimeMsec();
+
+	for (i = 0; i < noOfThreads; i++)
+	{
+		if (0 != pthread_create(&aThreads[i], NULL, batchWorker, pstCtx))
+		{
+			myLog(ERROR, "pthread_create failed for worker [%d]!", i);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+		noOfStarted++;
+	}
+
+	for (i = 0; i < noOfStarted; i++)
+	{
+		pthread_join(aThreads[i], NULL);
+	}
+
+	if (TRUE == pstCtx->hasFailed)
+	{
+		return INVALID_TIME;
+	}
+
+	return (int)(getWallTimeMsec() - startTime);
+}
+
+/* Writes the answers as "s -> t: d" lines in the order of the file, "-" for unreachable.
+With paths each line goes on with "Path:" and the vertices of the path */
+int writeBatchAnswers(FILE *pFile, BatchCtx *pstCtx, int noOfQueries, int *piOrder)
+{
+	int i, j;
+	BatchQuery *pstQuery = NULL_PTR;
+
+	for (i = 0; i < noOfQueries; i++)
+	{
+		pstQuery = &pstCtx->pstQueries[piOrder[i]];
+		if (INFINITY == pstCtx->piAnswers[i])
+		{
+			fprintf(pFile, "%d -> %d: -\n", pstQuery->source, pstQuery->target);
+			continue;
+		}
+
+		fprintf(pFile, "%d -> %d: %d", pstQuery->source, pstQuery->target, pstCtx->piAnswers[i]);
+		if (NULL_PTR != pstCtx->ppiPaths)
+		{
+			fprintf(pFile, " Path:");
+			for (j = 0; j < pstCtx->piPathLengths[i]; j++)
+			{
+				fprintf(pFile, " %d", pstCtx->ppiPaths[i][j]);
+			}
+		}
+		fprintf(pFile, "\n");
+	}
+
+	return (0 == ferror(pFile)) ? OK : ERR;
+}
+
+/* Returns the length of a path as the sum of its lightest edges, INFINITY if two of its
+vertices are not joined by an edge */
+int getBatchPathDistance(AdjList *pstAdjList, int *piPath, int pathLength)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	int i, edgeDistance, distance = 0;
+
+	for (i = 1; i < pathLength; i++)
+	{
+		edgeDistance = INFINITY;
+		for (pstTraverser = pstAdjList[piPath[i - 1]].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			if (piPath[i] == pstTraverser->vertexNum)
+			{
+				edgeDistance = MIN(edgeDistance, pstTraverser->distance);
+			}
+		}
+
+		if (INFINITY == edgeDistance)
+		{
+			return INFINITY;
+		}
+		distance += edgeDistance;
+	}
+
+	return distance;
+}
+
+/* Checks the first answers against a point to point search each, and their paths against
+the edges of the graph. Returns the number of wrong answers, ERR on failure */
+int checkBatchAnswers(int scheme, AdjList *pstAdjList, BatchCtx *pstCtx, int noOfQueries, int *piOrder)
+{
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	BatchQuery *pstQueries = pstCtx->pstQueries;
+	int *piAnswers = pstCtx->piAnswers;
+	int i, distance, noOfWrong = 0;
+
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+		return ERR;
+	}
+
+	for (i = 0; (i < noOfQueries) && (i < BATCH_CHECKED_QUERIES); i++)
+	{
+		distance = ssspPointToPoint(pstWorkspace, pstAdjList, pstQueries[piOrder[i]].source,
+			pstQueries[piOrder[i]].target);
+		if (ERR == distance)
+		{
+			noOfWrong = ERR;
+			break;
+		}
+
+		noOfWrong += (distance != piAnswers[i]);
+
+		/* A path starts at the source, ends at the target and is as long as the answer */
+		if ((NULL_PTR != pstCtx->ppiPaths) && (INFINITY != piAnswers[i]))
+		{
+			noOfWrong += ((pstCtx->piPathLengths[i] < 1)
+				|| (pstCtx->ppiPaths[i][0] != pstQueries[piOrder[i]].source)
+				|| (pstCtx->ppiPaths[i][pstCtx->piPathLengths[i] - 1] != pstQueries[piOrder[i]].target)
+				|| (getBatchPathDistance(pstAdjList, pstCtx->ppiPaths[i], pstCtx->piPathLengths[i]) != piAnswers[i]));
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+
+	return noOfWrong;
+}
+
+/* Entry function for batch mode. Answers the "s t" queries of queryFile on the graph in
+fileName. outName is "none" (default) for the totals only, "-" for stdout or a file name.
+With pathsArg "paths" the path of every query is kept and written too */
+int batchProc(int scheme, char *fileName, char *queryFile, char *outName, char *threadsArg,
+	char *pathsArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	BatchQuery *pstQueries = NULL_PTR;
+	FILE *pFile = NULL_PTR;
+	BatchCtx stCtx;
+	int *piOrder = NULL_PTR;
+	int i, noOfQueries = 0, noOfThreads, timeMsec, noOfWrong, retVal = OK;
+
+	if ((NULL_PTR != pathsArg) && (0 != strcmp(pathsArg, BATCH_PATHS_NAME)))
+	{
+		myLog(ERROR, "Invalid Input! Expected [%s], got [%s]", BATCH_PATHS_NAME, pathsArg);
+		return ERR;
+	}
+
+	noOfThreads = getWorkerThreadCount(threadsArg);
+	outName = (NULL_PTR != outName) ? outName : BATCH_OUTPUT_NONE_NAME;
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	pstQueries = readBatchQueries(queryFile, &noOfQueries);
+	if (NULL_PTR == pstQueries)
+	{
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	(void)memset(&stCtx, 0, sizeof(stCtx));
+	stCtx.scheme = scheme;
+	stCtx.pstAdjList = pstAdjList;
+	stCtx.pstQueries = pstQueries;
+	stCtx.piGroupStarts = (int *)malloc(sizeof(int) * (noOfQueries + 1));
+	stCtx.piAnswers = (int *)malloc(sizeof(int) * noOfQueries);
+	piOrder = (int *)malloc(sizeof(int) * noOfQueries);
+
+	if (NULL_PTR != pathsArg)
+	{
+		stCtx.ppiPaths = (int **)calloc(noOfQueries, sizeof(int *));
+		stCtx.piPathLengths = (int *)calloc(noOfQueries, sizeof(int));
+	}
+
+	if ((NULL_PTR == stCtx.piGroupStarts) || (NULL_PTR == stCtx.piAnswers) || (NULL_PTR == piOrder)
+		|| ((NULL_PTR != pathsArg) && ((NULL_PTR == stCtx.ppiPaths) || (NULL_PTR == stCtx.piPathLengths))))
+	{
+		myLog(ERROR, "Failed to allocate [%d] queries!", noOfQueries);
+		retVal = ERR;
+	}
+
+	if (OK == retVal)
+	{
+		qsort(pstQueries, noOfQueries, sizeof(BatchQuery), compareBatchQueries);
+
+		for (i = 0; i < noOfQueries; i++)
+		{
+			if ((0 == i) || (pstQueries[i].source != pstQueries[i - 1].source))
+			{
+				stCtx.piGroupStarts[stCtx.noOfGroups++] = i;
+			}
+
+			/* Where the i-th query of the file ended up after the sort */
+			piOrder[pstQueries[i].index] = i;
+		}
+		stCtx.piGroupStarts[stCtx.noOfGroups] = noOfQueries;
+
+		timeMsec = runBatchQueries(&stCtx, noOfThreads);
+		if (INVALID_TIME == timeMsec)
+		{
+			retVal = ERR;
+		}
+	}
+
+	if ((OK == retVal) && (0 != strcmp(outName, BATCH_OUTPUT_NONE_NAME)))
+	{
+		pFile = (0 == strcmp(outName, ROW_SINK_STDOUT_NAME)) ? stdout : fopen(outName, "w");
+		if ((NULL_PTR == pFile)
+			|| (OK != writeBatchAnswers(pFile, &stCtx, noOfQueries, piOrder)))
+		{
+			myLog(ERROR, "Could not write the answers to [%s]!", outName);
+			retVal = ERR;
+		}
+
+		if ((NULL_PTR != pFile) && (stdout != pFile))
+		{
+			fclose(pFile);
+		}
+	}
+
+	if (OK == retVal)
+	{
+		noOfWrong = checkBatchAnswers(scheme, pstAdjList, &stCtx, noOfQueries, piOrder);
+
+		printf("\n%s: [%d] queries from [%d] sources, [%d] threads, [%d] msec\n"
+			"Settled: [%lld] of up to [%lld] for full rows of the same sources\n"
+			"[%d] of the first [%d] answers differ from a point to point search\n",
+			schemeString[scheme], noOfQueries, stCtx.noOfGroups, noOfThreads, timeMsec,
+			stCtx.noOfSettled, (long long)stCtx.noOfGroups * gNoOfVertex,
+			noOfWrong, MIN(noOfQueries, BATCH_CHECKED_QUERIES));
+
+		if (0 != noOfWrong)
+		{
+			myLog(ERROR, "checkBatchAnswers failed!");
+			retVal = ERR;
+		}
+	}
+
+	if (NULL_PTR != stCtx.ppiPaths)
+	{
+		for (i = 0; i < noOfQueries; i++)
+		{
+			free(stCtx.ppiPaths[i]);
+		}
+	}
+
+	free(stCtx.ppiPaths);
+	free(stCtx.piPathLengths);
+	free(piOrder);
+	free(stCtx.piAnswers);
+	free(stCtx.piGroupStarts);
+	free(pstQueries);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
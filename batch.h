@@ -0,0 +1,24 @@
+/***************************************************************************************************/
+// BATCH.H
+// Contains the queries of the batched query mode
+/***************************************************************************************************/
+
+#ifndef __BATCH__
+#define __BATCH__
+
+#include "header.h"
+
+#define BATCH_CHECKED_QUERIES 100 // Answers checked against a point to point search
+#define BATCH_OUTPUT_NONE_NAME "none" // Only the totals are printed
+#define BATCH_PATHS_NAME "paths" // Keep and write the path of every query
+
+/* One (s, t) query of the batch file. index is its line among the valid queries, which is
+where its answer goes once the queries are sorted by source */
+typedef struct BatchQuery
+{
+	int source;
+	int target;
+	int index;
+}BatchQuery;
+
+#endif
@@ -19,9 +19,9 @@ int gTestEV;
 
 extern int gBCombine;
 
-/* Pointer Flags. Assuming maximum 500 nodes, the maxdegree of the binomial tree can
-go only to maximum of log_2 (500) <= 9 */
-int *binoPtrFlags[MAX_BINO_DEGREE] = {NULL_PTR};
+/* Pointer Flags. The maxdegree of the binomial tree can go only to maximum of
+log_2 (vertices). Kept per thread as the streaming modes run one heap per worker */
+__thread int *binoPtrFlags[MAX_BINO_DEGREE] = {NULL_PTR};
 
 /* Entry function for user input */
 int binoProc()
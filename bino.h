@@ -6,6 +6,9 @@
 // Year: 2011
 /***************************************************************************************************/
 
+#ifndef __BINO__
+#define __BINO__
+
 #include "header.h"
 #include <malloc.h>
 
@@ -14,7 +17,8 @@ The insert can be done in O(1) time
 Meld can be done in O(1) time
 Remove min can be done in O(n) time -- Amortized is O(log(n)) */
 
-#define MAX_BINO_DEGREE 10
+/* The degree of a binomial tree is at most log_2 of the vertices in the heap */
+#define MAX_BINO_DEGREE 32
 
 /* Node defination of a Binomial Tree */
 typedef struct BinoHeap
@@ -26,3 +30,5 @@ typedef struct BinoHeap
 	struct BinoHeap *child; // Points only to any one child
 	struct BinoHeap *next; //Useful for circular linked list. Points to itself if alone
 }BinoHeap;
+
+#endif
@@ -0,0 +1,429 @@
+/***************************************************************************************************/
+// BRANDES.C
+// Contains all functions for the betweenness centrality mode. Brandes' algorithm runs one
+// search per source on worker threads, each adding the dependencies into its own
+// accumulator. The accumulators are merged once all sources are done
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include "sssp.h"
+#include "stream.h"
+#include "brandes.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern AdjList* buildReverseAdjList(AdjList *pstAdjList);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeMsec();
+
+/* Shared by the workers of one run */
+typedef struct BrandesCtx
+{
+	AdjList *pstAdjList;
+	AdjList *pstReverseList; // To walk the shortest path DAG backwards
+	int *piSources;
+	int noOfSources;
+	volatile int nextSource;
+	volatile int hasFailed;
+}BrandesCtx;
+
+/* State of one worker. pdCentrality and pdSquares are its own accumulators */
+typedef struct BrandesWorker
+{
+	BrandesCtx *pstCtx;
+	SsspWorkspace *pstWorkspace; // Counts the shortest paths
+	int *piOrder; // Vertices in the order they were settled
+	double *pdDependency;
+	double *pdCentrality;
+	double *pdSquares; // Sum of the squared dependencies, for the error of a sample. NULL if exact
+	long long noOfSettled;
+}BrandesWorker;
+
+/* One source of Brandes' algorithm: a search which counts the shortest paths, then the
+settled vertices in reverse order push their dependency back over the DAG edges. A
+predecessor v of w gets paths(v) / paths(w) * (1 + dependency(w)). Returns OK or ERR */
+int brandesAccumulate(BrandesWorker *pstWorker, int source)
+{
+	SsspWorkspace *pstWorkspace = pstWorker->pstWorkspace;
+	AdjList *pstTraverser = NULL_PTR;
+	int i, vertex, previous, noOfOrdered = 0;
+	double share;
+
+	/* Stops right after settling the source */
+	if (OK != ssspSearch(pstWorkspace, pstWorker->pstCtx->pstAdjList, source, source))
+	{
+		return ERR;
+	}
+
+	pstWorker->piOrder[noOfOrdered++] = source;
+	pstWorker->pdDependency[source] = 0;
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != ssspSettleNext(pstWorkspace, pstWorker->pstCtx->pstAdjList, NULL_PTR, NULL_PTR, &vertex))
+		{
+			return ERR;
+		}
+
+		pstWorker->piOrder[noOfOrdered++] = vertex;
+		pstWorker->pdDependency[vertex] = 0;
+	}
+
+	pstWorker->noOfSettled += noOfOrdered;
+
+	for (i = noOfOrdered - 1; i > 0; i--)
+	{
+		vertex = pstWorker->piOrder[i];
+		share = (1 + pstWorker->pdDependency[vertex]) / pstWorkspace->pdPathCount[vertex];
+
+		for (pstTraverser = pstWorker->pstCtx->pstReverseList[vertex].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			previous = pstTraverser->vertexNum;
+			if ((INFINITY != pstWorkspace->piDist[previous])
+				&& (pstWorkspace->piDist[previous] + pstTraverser->distance == pstWorkspace->piDist[vertex]))
+			{
+				pstWorker->pdDependency[previous] += pstWorkspace->pdPathCount[previous] * share;
+			}
+		}
+
+		pstWorker->pdCentrality[vertex] += pstWorker->pdDependency[vertex];
+		if (NULL_PTR != pstWorker->pdSquares)
+		{
+			pstWorker->pdSquares[vertex] += pstWorker->pdDependency[vertex] * pstWorker->pdDependency[vertex];
+		}
+	}
+
+	return OK;
+}
+
+/* Worker loop. Takes the next source until all are done */
+void* brandesWorker(void *pArg)
+{
+	BrandesWorker *pstWorker = (BrandesWorker *)pArg;
+	BrandesCtx *pstCtx = pstWorker->pstCtx;
+	int index;
+
+	while (FALSE == pstCtx->hasFailed)
+	{
+		index = __sync_fetch_and_add(&pstCtx->nextSource, 1);
+		if (index >= pstCtx->noOfSources)
+		{
+			break;
+		}
+
+		if (OK != brandesAccumulate(pstWorker, pstCtx->piSources[index]))
+		{
+			myLog(ERROR, "brandesAccumulate failed for source [%d]!", pstCtx->piSources[index]);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+	}
+
+	return NULL_PTR;
+}
+
+/* Runs every source of pstCtx over noOfThreads workers. Returns the time taken in msec,
+INVALID_TIME on failure */
+int runBrandes(BrandesCtx *pstCtx, BrandesWorker *pstWorkers, int noOfThreads)
+{
+	pthread_t aThreads[MAX_WORKER_THREADS];
+	long long startTime;
+	int i, noOfStarted = 0;
+
+	pstCtx->nextSource = 0;
+	pstCtx->hasFailed = FALSE;
+
+	startTime = getWallTimeMsec();
+
+	for (i = 0; i < noOfThreads; i++)
+	{
+		if (0 != pthread_create(&aThreads[i], NULL, brandesWorker, &pstWorkers[i]))
+		{
+			myLog(ERROR, "pthread_create failed for worker [%d]!", i);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+		noOfStarted++;
+	}
+
+	for (i = 0; i < noOfStarted; i++)
+	{
+		pthread_join(aThreads[i], NULL);
+	}
+
+	if (TRUE == pstCtx->hasFailed)
+	{
+		return INVALID_TIME;
+	}
+
+	return (int)(getWallTimeMsec() - startTime);
+}
+
+/* Adds the accumulators of the other workers into those of the first. For a sample of k of
+the n sources the sum is scaled by n / k, and pdError gets the standard error of that
+estimate from the spread of the dependencies over the sample, without replacement */
+void mergeBrandesWorkers(BrandesWorker *pstWorkers, int noOfThreads, int noOfSources, double *pdError)
+{
+	double *pdCentrality = pstWorkers[0].pdCentrality, *pdSquares = pstWorkers[0].pdSquares;
+	double scale, variance;
+	int i, j;
+
+	for (i = 1; i < noOfThreads; i++)
+	{
+		for (j = 0; j < gNoOfVertex; j++)
+		{
+			pdCentrality[j] += pstWorkers[i].pdCentrality[j];
+			if (NULL_PTR != pdSquares)
+			{
+				pdSquares[j] += pstWorkers[i].pdSquares[j];
+			}
+		}
+	}
+
+	if (NULL_PTR == pdSquares)
+	{
+		return;
+	}
+
+	scale = (double)gNoOfVertex / noOfSources;
+	for (j = 0; j < gNoOfVertex; j++)
+	{
+		variance = (noOfSources > 1)
+			? ((pdSquares[j] - (pdCentrality[j] * pdCentrality[j]) / noOfSources) / (noOfSources - 1)) : 0;
+		variance = MAX(variance, 0);
+
+		pdCentrality[j] *= scale;
+		pdError[j] = (gNoOfVertex > 1) ? (gNoOfVertex * sqrt((variance / noOfSources)
+			* ((double)(gNoOfVertex - noOfSources) / (gNoOfVertex - 1)))) : 0;
+	}
+}
+
+/* Writes "v: centrality", followed by the standard error for a sample */
+int writeBrandesCentrality(FILE *pFile, double *pdCentrality, double *pdError)
+{
+	int i;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		if (NULL_PTR != pdError)
+		{
+			fprintf(pFile, "%d: %.2f %.2f\n", i, pdCentrality[i], pdError[i]);
+		}
+		else
+		{
+			fprintf(pFile, "%d: %.2f\n", i, pdCentrality[i]);
+		}
+	}
+
+	return (0 == ferror(pFile)) ? OK : ERR;
+}
+
+/* Prints the most central vertices, with the standard error for a sample */
+void printBrandesTop(double *pdCentrality, double *pdError)
+{
+	char *pPrinted = NULL_PTR;
+	int i, j, best;
+
+	pPrinted = (char *)calloc(gNoOfVertex, sizeof(char));
+	if (NULL_PTR == pPrinted)
+	{
+		myLog(ERROR, "calloc failed!");
+		return;
+	}
+
+	for (i = 0; i < MIN(BRANDES_TOP_VERTICES, gNoOfVertex); i++)
+	{
+		best = -1;
+		for (j = 0; j < gNoOfVertex; j++)
+		{
+			if ((FALSE == pPrinted[j]) && ((-1 == best) || (pdCentrality[j] > pdCentrality[best])))
+			{
+				best = j;
+			}
+		}
+
+		pPrinted[best] = TRUE;
+		if (NULL_PTR != pdError)
+		{
+			printf("%d: %.2f +- %.2f\n", best, pdCentrality[best], pdError[best]);
+		}
+		else
+		{
+			printf("%d: %.2f\n", best, pdCentrality[best]);
+		}
+	}
+
+	free(pPrinted);
+}
+
+/* Entry function for betweenness mode. sourcesArg 0 (default) gives the exact betweenness
+from every source, k > 0 estimates it from k random sources with a standard error per
+vertex. The values go to stdout for "-" or to outName, with "none" (default) only the most
+central vertices are printed */
+int brandesProc(int scheme, char *fileName, char *sourcesArg, char *threadsArg, char *outName)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	BrandesWorker aWorkers[MAX_WORKER_THREADS];
+	BrandesCtx stCtx;
+	FILE *pFile = NULL_PTR;
+	double *pdError = NULL_PTR;
+	long long noOfSettled = 0;
+	int i, other, swap, noOfSamples, noOfThreads, timeMsec, retVal = OK;
+
+	noOfSamples = (NULL_PTR != sourcesArg) ? atoi(sourcesArg) : BRANDES_ALL_SOURCES;
+	noOfThreads = getWorkerThreadCount(threadsArg);
+	outName = (NULL_PTR != outName) ? outName : BRANDES_OUTPUT_NONE_NAME;
+
+	if (noOfSamples < 0)
+	{
+		myLog(ERROR, "Invalid Input! Sources must not be negative");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	/* A sample as large as the graph is the exact run */
+	if (noOfSamples >= gNoOfVertex)
+	{
+		noOfSamples = BRANDES_ALL_SOURCES;
+	}
+
+	(void)memset(aWorkers, 0, sizeof(aWorkers));
+	(void)memset(&stCtx, 0, sizeof(stCtx));
+	stCtx.pstAdjList = pstAdjList;
+	stCtx.pstReverseList = buildReverseAdjList(pstAdjList);
+	stCtx.noOfSources = (BRANDES_ALL_SOURCES == noOfSamples) ? gNoOfVertex : noOfSamples;
+	stCtx.piSources = (int *)malloc(sizeof(int) * gNoOfVertex);
+
+	if ((NULL_PTR == stCtx.pstReverseList) || (NULL_PTR == stCtx.piSources))
+	{
+		myLog(ERROR, "Failed to set up the sources!");
+		retVal = ERR;
+	}
+
+	if ((OK == retVal) && (BRANDES_ALL_SOURCES != noOfSamples))
+	{
+		pdError = (double *)malloc(sizeof(double) * gNoOfVertex);
+		if (NULL_PTR == pdError)
+		{
+			myLog(ERROR, "malloc failed!");
+			retVal = ERR;
+		}
+	}
+
+	for (i = 0; (i < noOfThreads) && (OK == retVal); i++)
+	{
+		aWorkers[i].pstCtx = &stCtx;
+		aWorkers[i].pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+		aWorkers[i].piOrder = (int *)malloc(sizeof(int) * gNoOfVertex);
+		aWorkers[i].pdDependency = (double *)malloc(sizeof(double) * gNoOfVertex);
+		aWorkers[i].pdCentrality = (double *)calloc(gNoOfVertex, sizeof(double));
+		if (NULL_PTR != pdError)
+		{
+			aWorkers[i].pdSquares = (double *)calloc(gNoOfVertex, sizeof(double));
+		}
+
+		if ((NULL_PTR == aWorkers[i].pstWorkspace) || (NULL_PTR == aWorkers[i].piOrder)
+			|| (NULL_PTR == aWorkers[i].pdDependency) || (NULL_PTR == aWorkers[i].pdCentrality)
+			|| ((NULL_PTR != pdError) && (NULL_PTR == aWorkers[i].pdSquares))
+			|| (OK != ssspEnablePathCounts(aWorkers[i].pstWorkspace)))
+		{
+			myLog(ERROR, "Failed to allocate worker [%d]!", i);
+			retVal = ERR;
+		}
+	}
+
+	if (OK == retVal)
+	{
+		for (i = 0; i < gNoOfVertex; i++)
+		{
+			stCtx.piSources[i] = i;
+		}
+
+		/* The sample is the head of a partial shuffle, so no source is drawn twice */
+		srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+		for (i = 0; (BRANDES_ALL_SOURCES != noOfSamples) && (i < noOfSamples); i++)
+		{
+			other = i + (rand() % (gNoOfVertex - i));
+			swap = stCtx.piSources[i];
+			stCtx.piSources[i] = stCtx.piSources[other];
+			stCtx.piSources[other] = swap;
+		}
+
+		timeMsec = runBrandes(&stCtx, aWorkers, noOfThreads);
+		if (INVALID_TIME == timeMsec)
+		{
+			retVal = ERR;
+		}
+	}
+
+	if (OK == retVal)
+	{
+		mergeBrandesWorkers(aWorkers, noOfThreads, stCtx.noOfSources, pdError);
+
+		for (i = 0; i < noOfThreads; i++)
+		{
+			noOfSettled += aWorkers[i].noOfSettled;
+		}
+	}
+
+	if ((OK == retVal) && (0 != strcmp(outName, BRANDES_OUTPUT_NONE_NAME)))
+	{
+		pFile = (0 == strcmp(outName, ROW_SINK_STDOUT_NAME)) ? stdout : fopen(outName, "w");
+		if ((NULL_PTR == pFile) || (OK != writeBrandesCentrality(pFile, aWorkers[0].pdCentrality, pdError)))
+		{
+			myLog(ERROR, "Could not write the centrality to [%s]!", outName);
+			retVal = ERR;
+		}
+
+		if ((NULL_PTR != pFile) && (stdout != pFile))
+		{
+			fclose(pFile);
+		}
+	}
+
+	if (OK == retVal)
+	{
+		printf("\n%s: [%d] of [%d] sources, [%d] threads, [%d] msec, [%lld] vertices settled\n",
+			schemeString[scheme], stCtx.noOfSources, gNoOfVertex, noOfThreads, timeMsec, noOfSettled);
+		if (NULL_PTR != pdError)
+		{
+			printf("Estimated from a sample, scaled by [%.2f], with the standard error\n",
+				(double)gNoOfVertex / stCtx.noOfSources);
+		}
+
+		printBrandesTop(aWorkers[0].pdCentrality, pdError);
+	}
+
+	for (i = 0; i < noOfThreads; i++)
+	{
+		destroySsspWorkspace(aWorkers[i].pstWorkspace);
+		free(aWorkers[i].piOrder);
+		free(aWorkers[i].pdDependency);
+		free(aWorkers[i].pdCentrality);
+		free(aWorkers[i].pdSquares);
+	}
+
+	if (NULL_PTR != stCtx.pstReverseList)
+	{
+		destroyAdjList(stCtx.pstReverseList);
+	}
+	free(stCtx.piSources);
+	free(pdError);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
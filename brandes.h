@@ -0,0 +1,15 @@
+/***************************************************************************************************/
+// BRANDES.H
+// Contains the limits of the betweenness centrality mode
+/***************************************************************************************************/
+
+#ifndef __BRANDES__
+#define __BRANDES__
+
+#include "header.h"
+
+#define BRANDES_TOP_VERTICES 10 // Most central vertices printed
+#define BRANDES_OUTPUT_NONE_NAME "none" // Only the most central vertices are printed
+#define BRANDES_ALL_SOURCES 0 // Exact betweenness from every source
+
+#endif
@@ -0,0 +1,923 @@
+/***************************************************************************************************/
+// CH.C
+// Contains all functions of Contraction Hierarchies: node ordering by edge difference,
+// contraction with witness searches, the upward bidirectional query with stall-on-demand,
+// path unpacking and the hierarchy section of the binary graph format
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graphio.h"
+#include "ch.h"
+
+extern int gNoOfVertex;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern PQueue* createPQueue(int scheme, int noOfVertex);
+extern GraphFile* openGraphFile(char *fileName);
+extern void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size);
+extern long long getWallTimeMsec();
+extern long long getWallTimeUsec();
+
+/* Adds the arc to vertex, or lowers the distance of the arc which is already there.
+Returns TRUE if the list changed, FALSE if not and ERR on failure */
+int chAddArc(ChArcList *pstList, int vertex, int distance, int middle)
+{
+	ChArc *pstArcs = NULL_PTR;
+	int i;
+
+	for (i = 0; i < pstList->noOfArcs; i++)
+	{
+		if (vertex == pstList->pstArcs[i].vertex)
+		{
+			if (distance >= pstList->pstArcs[i].distance)
+			{
+				return FALSE;
+			}
+
+			pstList->pstArcs[i].distance = distance;
+			pstList->pstArcs[i].middle = middle;
+			return TRUE;
+		}
+	}
+
+	if (pstList->noOfArcs == pstList->capacity)
+	{
+		pstArcs = (ChArc *)realloc(pstList->pstArcs,
+			sizeof(ChArc) * ((0 == pstList->capacity) ? 4 : (2 * pstList->capacity)));
+		if (NULL_PTR == pstArcs)
+		{
+			myLog(ERROR, "realloc failed!");
+			return ERR;
+		}
+
+		pstList->pstArcs = pstArcs;
+		pstList->capacity = (0 == pstList->capacity) ? 4 : (2 * pstList->capacity);
+	}
+
+	pstList->pstArcs[pstList->noOfArcs].vertex = vertex;
+	pstList->pstArcs[pstList->noOfArcs].distance = distance;
+	pstList->pstArcs[pstList->noOfArcs].middle = middle;
+	pstList->noOfArcs++;
+
+	return TRUE;
+}
+
+/* Removes the arc to vertex if there is one. The last arc takes its place */
+void chRemoveArc(ChArcList *pstList, int vertex)
+{
+	int i;
+
+	for (i = 0; i < pstList->noOfArcs; i++)
+	{
+		if (vertex == pstList->pstArcs[i].vertex)
+		{
+			pstList->pstArcs[i] = pstList->pstArcs[--pstList->noOfArcs];
+			return;
+		}
+	}
+}
+
+/* Frees the builder */
+void destroyChBuilder(ChBuilder *pstBuilder)
+{
+	int i;
+
+	if (NULL_PTR == pstBuilder)
+	{
+		return;
+	}
+
+	for (i = 0; i < pstBuilder->noOfVertex; i++)
+	{
+		if (NULL_PTR != pstBuilder->pstOut)
+		{
+			free(pstBuilder->pstOut[i].pstArcs);
+		}
+		if (NULL_PTR != pstBuilder->pstIn)
+		{
+			free(pstBuilder->pstIn[i].pstArcs);
+		}
+	}
+
+	free(pstBuilder->pstOut);
+	free(pstBuilder->pstIn);
+	free(pstBuilder->pContracted);
+	free(pstBuilder->piDeletedNeighbours);
+	free(pstBuilder->piRank);
+	destroySsspWorkspace(pstBuilder->pstWitness);
+	free(pstBuilder);
+}
+
+/* Returns a builder holding a copy of the graph. Self loops are dropped and of parallel
+edges only the shortest is kept. The witness searches use the heap of scheme */
+ChBuilder* createChBuilder(int scheme, AdjList *pstAdjList)
+{
+	ChBuilder *pstBuilder = NULL_PTR;
+	AdjList *pstTraverser = NULL_PTR;
+	int u, v;
+
+	pstBuilder = (ChBuilder *)calloc(1, sizeof(ChBuilder));
+	if (NULL_PTR == pstBuilder)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstBuilder->noOfVertex = gNoOfVertex;
+	pstBuilder->pstOut = (ChArcList *)calloc(gNoOfVertex, sizeof(ChArcList));
+	pstBuilder->pstIn = (ChArcList *)calloc(gNoOfVertex, sizeof(ChArcList));
+	pstBuilder->pContracted = (char *)calloc(gNoOfVertex, sizeof(char));
+	pstBuilder->piDeletedNeighbours = (int *)calloc(gNoOfVertex, sizeof(int));
+	pstBuilder->piRank = (int *)malloc(sizeof(int) * gNoOfVertex);
+	pstBuilder->pstWitness = createSsspWorkspace(scheme, gNoOfVertex);
+
+	if ((NULL_PTR == pstBuilder->pstOut) || (NULL_PTR == pstBuilder->pstIn)
+		|| (NULL_PTR == pstBuilder->pContracted) || (NULL_PTR == pstBuilder->piDeletedNeighbours)
+		|| (NULL_PTR == pstBuilder->piRank) || (NULL_PTR == pstBuilder->pstWitness))
+	{
+		myLog(ERROR, "Failed to allocate the builder for [%d] vertices!", gNoOfVertex);
+		destroyChBuilder(pstBuilder);
+		return NULL_PTR;
+	}
+
+	for (u = 0; u < gNoOfVertex; u++)
+	{
+		for (pstTraverser = pstAdjList[u].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			v = pstTraverser->vertexNum;
+			if (u == v)
+			{
+				continue;
+			}
+
+			if ((ERR == chAddArc(&pstBuilder->pstOut[u], v, pstTraverser->distance, CH_NO_MIDDLE))
+				|| (ERR == chAddArc(&pstBuilder->pstIn[v], u, pstTraverser->distance, CH_NO_MIDDLE)))
+			{
+				destroyChBuilder(pstBuilder);
+				return NULL_PTR;
+			}
+		}
+	}
+
+	return pstBuilder;
+}
+
+/* Local Dijkstra from source over the vertices not contracted yet, leaving out excluded.
+It gives up past maxDistance or CH_WITNESS_SETTLE_LIMIT settled vertices, so the
+distances in the witness workspace are upper bounds: a path of that length exists */
+int chWitnessSearch(ChBuilder *pstBuilder, int source, int excluded, int maxDistance)
+{
+	SsspWorkspace *pstWitness = pstBuilder->pstWitness;
+	ChArcList *pstList = NULL_PTR;
+	int i, vertex, distance, nextVertex;
+
+	resetSsspWorkspace(pstWitness);
+
+	if (OK != ssspRelax(pstWitness, source, 0))
+	{
+		return ERR;
+	}
+
+	while ((FALSE == pqIsEmpty(pstWitness->pstQueue))
+		&& (pstWitness->noOfSettled < CH_WITNESS_SETTLE_LIMIT))
+	{
+		if (OK != pqRemoveMin(pstWitness->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		if (distance > maxDistance)
+		{
+			break;
+		}
+
+		pstWitness->pSettled[vertex] = TRUE;
+		pstWitness->noOfSettled++;
+
+		pstList = &pstBuilder->pstOut[vertex];
+		for (i = 0; i < pstList->noOfArcs; i++)
+		{
+			nextVertex = pstList->pstArcs[i].vertex;
+			if ((excluded == nextVertex) || (TRUE == pstWitness->pSettled[nextVertex]))
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWitness, nextVertex, distance + pstList->pstArcs[i].distance))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	return OK;
+}
+
+/* Contracts vertex: every u -> vertex -> w which has no witness path of at most the same
+length becomes a shortcut u -> w. With isSimulation nothing is changed, the shortcuts are
+only counted. Returns the number of shortcuts, ERR on failure */
+int chContractVertex(ChBuilder *pstBuilder, int vertex, int isSimulation)
+{
+	ChArcList *pstIn = &pstBuilder->pstIn[vertex];
+	ChArcList *pstOut = &pstBuilder->pstOut[vertex];
+	int i, j, u, w, viaDistance, maxDistance, noOfShortcuts = 0;
+
+	for (i = 0; i < pstIn->noOfArcs; i++)
+	{
+		u = pstIn->pstArcs[i].vertex;
+
+		maxDistance = -1;
+		for (j = 0; j < pstOut->noOfArcs; j++)
+		{
+			if (u != pstOut->pstArcs[j].vertex)
+			{
+				maxDistance = MAX(maxDistance, pstIn->pstArcs[i].distance + pstOut->pstArcs[j].distance);
+			}
+		}
+
+		/* vertex has no way out apart from back to u */
+		if (maxDistance < 0)
+		{
+			continue;
+		}
+
+		if (OK != chWitnessSearch(pstBuilder, u, vertex, maxDistance))
+		{
+			return ERR;
+		}
+
+		for (j = 0; j < pstOut->noOfArcs; j++)
+		{
+			w = pstOut->pstArcs[j].vertex;
+			viaDistance = pstIn->pstArcs[i].distance + pstOut->pstArcs[j].distance;
+
+			if ((u == w) || (pstBuilder->pstWitness->piDist[w] <= viaDistance))
+			{
+				continue;
+			}
+
+			noOfShortcuts++;
+
+			if ((FALSE == isSimulation)
+				&& ((ERR == chAddArc(&pstBuilder->pstOut[u], w, viaDistance, vertex))
+				|| (ERR == chAddArc(&pstBuilder->pstIn[w], u, viaDistance, vertex))))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	if (TRUE == isSimulation)
+	{
+		return noOfShortcuts;
+	}
+
+	/* The lists of vertex are frozen from here on, the neighbours forget it */
+	for (i = 0; i < pstIn->noOfArcs; i++)
+	{
+		chRemoveArc(&pstBuilder->pstOut[pstIn->pstArcs[i].vertex], vertex);
+		pstBuilder->piDeletedNeighbours[pstIn->pstArcs[i].vertex]++;
+	}
+
+	for (j = 0; j < pstOut->noOfArcs; j++)
+	{
+		chRemoveArc(&pstBuilder->pstIn[pstOut->pstArcs[j].vertex], vertex);
+		pstBuilder->piDeletedNeighbours[pstOut->pstArcs[j].vertex]++;
+	}
+
+	pstBuilder->pContracted[vertex] = TRUE;
+
+	return noOfShortcuts;
+}
+
+/* Ordering key of a vertex: twice its edge difference (shortcuts added minus arcs removed)
+plus its contracted neighbours, which spreads the contraction over the graph.
+Returns ERR on failure */
+int chGetPriority(ChBuilder *pstBuilder, int vertex)
+{
+	int noOfShortcuts;
+
+	noOfShortcuts = chContractVertex(pstBuilder, vertex, TRUE);
+	if (ERR == noOfShortcuts)
+	{
+		return ERR;
+	}
+
+	return CH_PRIORITY_BIAS + 2 * (noOfShortcuts - pstBuilder->pstIn[vertex].noOfArcs
+		- pstBuilder->pstOut[vertex].noOfArcs) + pstBuilder->piDeletedNeighbours[vertex];
+}
+
+/* Contracts every vertex in the order of their priorities. The priorities are updated
+lazily: a vertex whose recomputed priority is no longer the smallest goes back into
+the queue */
+int chBuildHierarchy(ChBuilder *pstBuilder, int scheme)
+{
+	PQueue *pstOrder = NULL_PTR;
+	int vertex, key, minVertex, minKey, priority, rank = 0, retVal = OK;
+
+	pstOrder = createPQueue(scheme, pstBuilder->noOfVertex);
+	if (NULL_PTR == pstOrder)
+	{
+		myLog(ERROR, "createPQueue failed!");
+		return ERR;
+	}
+
+	for (vertex = 0; (vertex < pstBuilder->noOfVertex) && (OK == retVal); vertex++)
+	{
+		priority = chGetPriority(pstBuilder, vertex);
+		if ((ERR == priority) || (OK != pqInsert(pstOrder, vertex, priority)))
+		{
+			retVal = ERR;
+		}
+	}
+
+	while ((OK == retVal) && (FALSE == pqIsEmpty(pstOrder)))
+	{
+		if (OK != pqRemoveMin(pstOrder, &vertex, &key))
+		{
+			retVal = ERR;
+			break;
+		}
+
+		priority = chGetPriority(pstBuilder, vertex);
+		if (ERR == priority)
+		{
+			retVal = ERR;
+			break;
+		}
+
+		if ((OK == pqPeekMin(pstOrder, &minVertex, &minKey)) && (minKey < priority))
+		{
+			retVal = pqInsert(pstOrder, vertex, priority);
+			continue;
+		}
+
+		if (ERR == chContractVertex(pstBuilder, vertex, FALSE))
+		{
+			retVal = ERR;
+			break;
+		}
+
+		pstBuilder->piRank[vertex] = rank++;
+	}
+
+	destroyPQueue(pstOrder);
+
+	return retVal;
+}
+
+/* Writes the frozen lists of a contracted builder as one CSR array: piOffsets gets the
+offsets, pstArcs the arcs. Returns the number of arcs */
+int chFlattenArcLists(ChArcList *pstLists, int noOfVertex, int *piOffsets, ChArc *pstArcs)
+{
+	int i, noOfArcs = 0;
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		piOffsets[i] = noOfArcs;
+		if (NULL_PTR != pstArcs)
+		{
+			memcpy(pstArcs + noOfArcs, pstLists[i].pstArcs, sizeof(ChArc) * pstLists[i].noOfArcs);
+		}
+		noOfArcs += pstLists[i].noOfArcs;
+	}
+
+	piOffsets[noOfVertex] = noOfArcs;
+
+	return noOfArcs;
+}
+
+/* Returns a hierarchy section for a contracted builder, its length in size.
+The caller frees it. NULL on failure */
+void* buildChSection(ChBuilder *pstBuilder, long long *size)
+{
+	ChSectionHeader *pstHeader = NULL_PTR;
+	int *piRank = NULL_PTR, *piUpOffsets = NULL_PTR, *piDownOffsets = NULL_PTR;
+	ChArc *pstUpArcs = NULL_PTR, *pstDownArcs = NULL_PTR;
+	int i, noOfVertex = pstBuilder->noOfVertex, noOfUpArcs = 0, noOfDownArcs = 0;
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		noOfUpArcs += pstBuilder->pstOut[i].noOfArcs;
+		noOfDownArcs += pstBuilder->pstIn[i].noOfArcs;
+	}
+
+	*size = CH_SECTION_SIZE(noOfVertex, noOfUpArcs, noOfDownArcs);
+	pstHeader = (ChSectionHeader *)malloc((size_t)*size);
+	if (NULL_PTR == pstHeader)
+	{
+		myLog(ERROR, "Failed to allocate [%lld] bytes for the hierarchy!", *size);
+		return NULL_PTR;
+	}
+
+	pstHeader->noOfVertex = noOfVertex;
+	pstHeader->noOfUpArcs = noOfUpArcs;
+	pstHeader->noOfDownArcs = noOfDownArcs;
+	pstHeader->noOfShortcuts = 0;
+
+	piRank = (int *)(pstHeader + 1);
+	piUpOffsets = piRank + noOfVertex;
+	pstUpArcs = (ChArc *)(piUpOffsets + noOfVertex + 1);
+	piDownOffsets = (int *)(pstUpArcs + noOfUpArcs);
+	pstDownArcs = (ChArc *)(piDownOffsets + noOfVertex + 1);
+
+	memcpy(piRank, pstBuilder->piRank, sizeof(int) * noOfVertex);
+	(void)chFlattenArcLists(pstBuilder->pstOut, noOfVertex, piUpOffsets, pstUpArcs);
+	(void)chFlattenArcLists(pstBuilder->pstIn, noOfVertex, piDownOffsets, pstDownArcs);
+
+	/* Every arc sits in exactly one frozen list, the one of its lower end */
+	for (i = 0; i < noOfUpArcs; i++)
+	{
+		pstHeader->noOfShortcuts += (CH_NO_MIDDLE != pstUpArcs[i].middle);
+	}
+	for (i = 0; i < noOfDownArcs; i++)
+	{
+		pstHeader->noOfShortcuts += (CH_NO_MIDDLE != pstDownArcs[i].middle);
+	}
+
+	return pstHeader;
+}
+
+/* Points the hierarchy into a hierarchy section of size bytes. Returns ERR if the section
+does not fit a graph with noOfVertex vertices */
+int attachChGraph(ChGraph *pstGraph, void *pSection, long long size, int noOfVertex)
+{
+	ChSectionHeader *pstHeader = (ChSectionHeader *)pSection;
+
+	if ((NULL_PTR == pstGraph) || (NULL_PTR == pSection)
+		|| (size < (long long)sizeof(ChSectionHeader)))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	if ((pstHeader->noOfVertex != noOfVertex) || (pstHeader->noOfUpArcs < 0)
+		|| (pstHeader->noOfDownArcs < 0)
+		|| (size != CH_SECTION_SIZE(pstHeader->noOfVertex, pstHeader->noOfUpArcs, pstHeader->noOfDownArcs)))
+	{
+		myLog(ERROR, "Hierarchy section does not match the graph!");
+		return ERR;
+	}
+
+	pstGraph->noOfVertex = pstHeader->noOfVertex;
+	pstGraph->noOfShortcuts = pstHeader->noOfShortcuts;
+	pstGraph->piRank = (int *)(pstHeader + 1);
+	pstGraph->piUpOffsets = pstGraph->piRank + noOfVertex;
+	pstGraph->pstUpArcs = (ChArc *)(pstGraph->piUpOffsets + noOfVertex + 1);
+	pstGraph->piDownOffsets = (int *)(pstGraph->pstUpArcs + pstHeader->noOfUpArcs);
+	pstGraph->pstDownArcs = (ChArc *)(pstGraph->piDownOffsets + noOfVertex + 1);
+
+	return OK;
+}
+
+/* Frees the query */
+void destroyChQuery(ChQuery *pstQuery)
+{
+	if (NULL_PTR == pstQuery)
+	{
+		return;
+	}
+
+	destroySsspWorkspace(pstQuery->pstForward);
+	destroySsspWorkspace(pstQuery->pstBackward);
+	free(pstQuery->piForwardArc);
+	free(pstQuery->piBackwardArc);
+	free(pstQuery->piForwardParent);
+	free(pstQuery->piBackwardParent);
+	free(pstQuery->piPath);
+	free(pstQuery);
+}
+
+/* Returns the working memory for queries on pstGraph using the heap of scheme */
+ChQuery* createChQuery(int scheme, ChGraph *pstGraph)
+{
+	ChQuery *pstQuery = NULL_PTR;
+	int noOfVertex = pstGraph->noOfVertex;
+
+	pstQuery = (ChQuery *)calloc(1, sizeof(ChQuery));
+	if (NULL_PTR == pstQuery)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstQuery->pstGraph = pstGraph;
+	pstQuery->pstForward = createSsspWorkspace(scheme, noOfVertex);
+	pstQuery->pstBackward = createSsspWorkspace(scheme, noOfVertex);
+	pstQuery->piForwardArc = (int *)malloc(sizeof(int) * noOfVertex);
+	pstQuery->piBackwardArc = (int *)malloc(sizeof(int) * noOfVertex);
+	pstQuery->piForwardParent = (int *)malloc(sizeof(int) * noOfVertex);
+	pstQuery->piBackwardParent = (int *)malloc(sizeof(int) * noOfVertex);
+	pstQuery->piPath = (int *)malloc(sizeof(int) * noOfVertex);
+
+	if ((NULL_PTR == pstQuery->pstForward) || (NULL_PTR == pstQuery->pstBackward)
+		|| (NULL_PTR == pstQuery->piForwardArc) || (NULL_PTR == pstQuery->piBackwardArc)
+		|| (NULL_PTR == pstQuery->piForwardParent) || (NULL_PTR == pstQuery->piBackwardParent)
+		|| (NULL_PTR == pstQuery->piPath))
+	{
+		myLog(ERROR, "Failed to allocate the query for [%d] vertices!", noOfVertex);
+		destroyChQuery(pstQuery);
+		return NULL_PTR;
+	}
+
+	return pstQuery;
+}
+
+/* Settles the closest vertex of one side of the query. The forward side walks the upward
+arcs, the backward side the downward arcs in reverse. A vertex which a higher vertex
+already reaches on a shorter way is stalled: its arcs are not relaxed */
+int chSettleNext(ChQuery *pstQuery, int isForward)
+{
+	ChGraph *pstGraph = pstQuery->pstGraph;
+	SsspWorkspace *pstWorkspace = (TRUE == isForward) ? pstQuery->pstForward : pstQuery->pstBackward;
+	SsspWorkspace *pstOpposite = (TRUE == isForward) ? pstQuery->pstBackward : pstQuery->pstForward;
+	int *piOffsets = (TRUE == isForward) ? pstGraph->piUpOffsets : pstGraph->piDownOffsets;
+	ChArc *pstArcs = (TRUE == isForward) ? pstGraph->pstUpArcs : pstGraph->pstDownArcs;
+	int *piStallOffsets = (TRUE == isForward) ? pstGraph->piDownOffsets : pstGraph->piUpOffsets;
+	ChArc *pstStallArcs = (TRUE == isForward) ? pstGraph->pstDownArcs : pstGraph->pstUpArcs;
+	int *piParentArc = (TRUE == isForward) ? pstQuery->piForwardArc : pstQuery->piBackwardArc;
+	int *piParent = (TRUE == isForward) ? pstQuery->piForwardParent : pstQuery->piBackwardParent;
+	int i, vertex, distance, nextVertex;
+
+	if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+	{
+		myLog(ERROR, "pqRemoveMin failed!");
+		return ERR;
+	}
+
+	pstWorkspace->pSettled[vertex] = TRUE;
+	pstWorkspace->noOfSettled++;
+
+	if ((INFINITY != pstOpposite->piDist[vertex])
+		&& (distance + pstOpposite->piDist[vertex] < pstQuery->stMeeting.bestDistance))
+	{
+		pstQuery->stMeeting.bestDistance = distance + pstOpposite->piDist[vertex];
+		pstQuery->stMeeting.meetingVertex = vertex;
+	}
+
+	/* Stall-on-demand */
+	for (i = piStallOffsets[vertex]; i < piStallOffsets[vertex + 1]; i++)
+	{
+		if (pstWorkspace->piDist[pstStallArcs[i].vertex] + pstStallArcs[i].distance < distance)
+		{
+			pstQuery->noOfStalled++;
+			return OK;
+		}
+	}
+
+	for (i = piOffsets[vertex]; i < piOffsets[vertex + 1]; i++)
+	{
+		nextVertex = pstArcs[i].vertex;
+		if ((TRUE == pstWorkspace->pSettled[nextVertex])
+			|| (distance + pstArcs[i].distance >= pstWorkspace->piDist[nextVertex]))
+		{
+			continue;
+		}
+
+		if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstArcs[i].distance))
+		{
+			return ERR;
+		}
+
+		piParent[nextVertex] = vertex;
+		piParentArc[nextVertex] = i;
+	}
+
+	return OK;
+}
+
+/* Returns the arc of owner's CSR list which leads to vertex, NULL if there is none */
+ChArc* chFindArc(int *piOffsets, ChArc *pstArcs, int owner, int vertex)
+{
+	int i;
+
+	for (i = piOffsets[owner]; i < piOffsets[owner + 1]; i++)
+	{
+		if (vertex == pstArcs[i].vertex)
+		{
+			return &pstArcs[i];
+		}
+	}
+
+	return NULL_PTR;
+}
+
+/* Appends the original vertices of the arc tail -> head (without tail) to the path.
+tail -> middle sits in the downward list of middle, middle -> head in its upward list */
+int chUnpackArc(ChQuery *pstQuery, int tail, int head, int middle)
+{
+	ChGraph *pstGraph = pstQuery->pstGraph;
+	ChArc *pstFirst = NULL_PTR, *pstSecond = NULL_PTR;
+
+	if (CH_NO_MIDDLE == middle)
+	{
+		if (pstQuery->pathLength >= pstGraph->noOfVertex)
+		{
+			myLog(ERROR, "Path longer than the graph!");
+			return ERR;
+		}
+
+		pstQuery->piPath[pstQuery->pathLength++] = head;
+		return OK;
+	}
+
+	pstFirst = chFindArc(pstGraph->piDownOffsets, pstGraph->pstDownArcs, middle, tail);
+	pstSecond = chFindArc(pstGraph->piUpOffsets, pstGraph->pstUpArcs, middle, head);
+	if ((NULL_PTR == pstFirst) || (NULL_PTR == pstSecond))
+	{
+		myLog(ERROR, "Shortcut [%d] -> [%d] via [%d] has no parts!", tail, head, middle);
+		return ERR;
+	}
+
+	if (OK != chUnpackArc(pstQuery, tail, middle, pstFirst->middle))
+	{
+		return ERR;
+	}
+
+	return chUnpackArc(pstQuery, middle, head, pstSecond->middle);
+}
+
+/* Unpacks the forward search tree path from the source to vertex */
+int chUnpackForward(ChQuery *pstQuery, int source, int vertex)
+{
+	int parent;
+
+	if (source == vertex)
+	{
+		return OK;
+	}
+
+	parent = pstQuery->piForwardParent[vertex];
+	if (OK != chUnpackForward(pstQuery, source, parent))
+	{
+		return ERR;
+	}
+
+	return chUnpackArc(pstQuery, parent, vertex,
+		pstQuery->pstGraph->pstUpArcs[pstQuery->piForwardArc[vertex]].middle);
+}
+
+/* Puts the path of the last query into piPath, pathLength vertices from source to
+target. An unreachable target gives an empty path */
+int chUnpackPath(ChQuery *pstQuery, int source, int target)
+{
+	int vertex, parent;
+
+	pstQuery->pathLength = 0;
+
+	if (INFINITY == pstQuery->stMeeting.bestDistance)
+	{
+		return OK;
+	}
+
+	pstQuery->piPath[pstQuery->pathLength++] = source;
+
+	vertex = pstQuery->stMeeting.meetingVertex;
+	if (OK != chUnpackForward(pstQuery, source, vertex))
+	{
+		return ERR;
+	}
+
+	/* The backward tree leads from the meeting vertex down to the target */
+	while (target != vertex)
+	{
+		parent = pstQuery->piBackwardParent[vertex];
+		if (OK != chUnpackArc(pstQuery, vertex, parent,
+			pstQuery->pstGraph->pstDownArcs[pstQuery->piBackwardArc[vertex]].middle))
+		{
+			return ERR;
+		}
+		vertex = parent;
+	}
+
+	return OK;
+}
+
+/* Answers source -> target with an upward search from both ends. A side stops once its
+queue minimum reaches the best meeting. Returns the distance, INFINITY if target is not
+reachable and ERR on failure. The path is unpacked into the query */
+int chPointToPoint(ChQuery *pstQuery, int source, int target)
+{
+	int vertex, forwardKey, backwardKey;
+
+	if ((NULL_PTR == pstQuery) || (source < 0) || (source >= pstQuery->pstGraph->noOfVertex)
+		|| (target < 0) || (target >= pstQuery->pstGraph->noOfVertex))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	resetSsspWorkspace(pstQuery->pstForward);
+	resetSsspWorkspace(pstQuery->pstBackward);
+	pstQuery->noOfStalled = 0;
+
+	pstQuery->stMeeting.bestDistance = INFINITY;
+	pstQuery->stMeeting.meetingVertex = -1;
+
+	if ((OK != ssspRelax(pstQuery->pstForward, source, 0))
+		|| (OK != ssspRelax(pstQuery->pstBackward, target, 0)))
+	{
+		return ERR;
+	}
+
+	while (TRUE)
+	{
+		if ((OK != pqPeekMin(pstQuery->pstForward->pstQueue, &vertex, &forwardKey))
+			|| (forwardKey >= pstQuery->stMeeting.bestDistance))
+		{
+			forwardKey = INFINITY;
+		}
+
+		if ((OK != pqPeekMin(pstQuery->pstBackward->pstQueue, &vertex, &backwardKey))
+			|| (backwardKey >= pstQuery->stMeeting.bestDistance))
+		{
+			backwardKey = INFINITY;
+		}
+
+		if ((INFINITY == forwardKey) && (INFINITY == backwardKey))
+		{
+			break;
+		}
+
+		if (OK != chSettleNext(pstQuery, (forwardKey <= backwardKey) ? TRUE : FALSE))
+		{
+			return ERR;
+		}
+	}
+
+	if (OK != chUnpackPath(pstQuery, source, target))
+	{
+		myLog(ERROR, "chUnpackPath failed!");
+		return ERR;
+	}
+
+	return pstQuery->stMeeting.bestDistance;
+}
+
+/* Entry function for hierarchy preprocessing. Contracts the binary graph file fileName and
+stores the hierarchy in it, replacing any hierarchy it had */
+int chPrepProc(char *fileName)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	ChBuilder *pstBuilder = NULL_PTR;
+	void *pSection = NULL_PTR;
+	long long size, startTime;
+	int retVal;
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	startTime = getWallTimeMsec();
+
+	pstBuilder = createChBuilder(BINARY_SCHEME, pstAdjList);
+	destroyAdjList(pstAdjList);
+
+	if (NULL_PTR == pstBuilder)
+	{
+		myLog(ERROR, "createChBuilder failed!");
+		return ERR;
+	}
+
+	if (OK != chBuildHierarchy(pstBuilder, BINARY_SCHEME))
+	{
+		myLog(ERROR, "chBuildHierarchy failed!");
+		destroyChBuilder(pstBuilder);
+		return ERR;
+	}
+
+	pSection = buildChSection(pstBuilder, &size);
+	destroyChBuilder(pstBuilder);
+
+	if (NULL_PTR == pSection)
+	{
+		myLog(ERROR, "buildChSection failed!");
+		return ERR;
+	}
+
+	printf("\nContracted [%d] vertices in [%lld] msec, [%d] shortcuts\n", gNoOfVertex,
+		getWallTimeMsec() - startTime, ((ChSectionHeader *)pSection)->noOfShortcuts);
+
+	retVal = setGraphFileSection(fileName, GRAPH_SECTION_CH, pSection, size);
+	free(pSection);
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "Could not store the hierarchy in [%s]! Convert it with -g first", fileName);
+		return ERR;
+	}
+
+	printf("Stored [%lld] bytes of hierarchy in [%s]\n", size, fileName);
+
+	return OK;
+}
+
+/* Entry function for hierarchy mode. Answers source -> destination with plain Dijkstra and
+with the hierarchy stored in the binary graph file fileName on the same heap, and prints
+the unpacked path */
+int chQueryProc(int scheme, char *fileName, char *sourceArg, char *destinationArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	GraphFile *pstGraphFile = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	ChQuery *pstQuery = NULL_PTR;
+	ChGraph stGraph;
+	void *pSection = NULL_PTR;
+	long long size, startTime, plainUsec, chUsec;
+	int i, source, destination, plainDistance, chDistance, retVal = ERR;
+
+	if ((NULL_PTR == sourceArg) || (NULL_PTR == destinationArg))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	source = atoi(sourceArg);
+	destination = atoi(destinationArg);
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR != pstGraphFile)
+	{
+		pSection = getGraphFileSection(pstGraphFile, GRAPH_SECTION_CH, &size);
+	}
+
+	if ((NULL_PTR == pSection) || (OK != attachChGraph(&stGraph, pSection, size, gNoOfVertex)))
+	{
+		myLog(ERROR, "[%s] has no usable hierarchy! Run -hp on it first", fileName);
+	}
+	else if ((source < 0) || (source >= gNoOfVertex) || (destination < 0) || (destination >= gNoOfVertex))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", gNoOfVertex);
+	}
+	else if ((NULL_PTR == (pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex)))
+		|| (NULL_PTR == (pstQuery = createChQuery(scheme, &stGraph))))
+	{
+		myLog(ERROR, "Failed to allocate the searches!");
+	}
+	else
+	{
+		startTime = getWallTimeUsec();
+		plainDistance = ssspPointToPoint(pstWorkspace, pstAdjList, source, destination);
+		plainUsec = getWallTimeUsec() - startTime;
+
+		startTime = getWallTimeUsec();
+		chDistance = chPointToPoint(pstQuery, source, destination);
+		chUsec = getWallTimeUsec() - startTime;
+
+		if ((ERR == plainDistance) || (ERR == chDistance))
+		{
+			myLog(ERROR, "Search failed!");
+		}
+		else if (plainDistance != chDistance)
+		{
+			myLog(ERROR, "Plain search found [%d], CH [%d]!", plainDistance, chDistance);
+		}
+		else
+		{
+			if (INFINITY == chDistance)
+			{
+				printf("%d -> %d: -\n", source, destination);
+			}
+			else
+			{
+				printf("%d -> %d: %d\nPath:", source, destination, chDistance);
+				for (i = 0; i < pstQuery->pathLength; i++)
+				{
+					printf(" %d", pstQuery->piPath[i]);
+				}
+				printf("\n");
+			}
+
+			printf("\n%s: [%d] shortcuts\n"
+				"Plain:\tSettled: [%d] Time: [%lld] usec\n"
+				"CH:\tSettled: [%d] Stalled: [%d] Time: [%lld] usec\n",
+				schemeString[scheme], stGraph.noOfShortcuts, pstWorkspace->noOfSettled, plainUsec,
+				pstQuery->pstForward->noOfSettled + pstQuery->pstBackward->noOfSettled,
+				pstQuery->noOfStalled, chUsec);
+
+			retVal = OK;
+		}
+	}
+
+	destroyChQuery(pstQuery);
+	destroySsspWorkspace(pstWorkspace);
+	closeGraphFile(pstGraphFile);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
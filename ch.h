@@ -0,0 +1,94 @@
+/***************************************************************************************************/
+// CH.H
+// Contains the hierarchy of the Contraction Hierarchies preprocessing and query
+/***************************************************************************************************/
+
+#ifndef __CH__
+#define __CH__
+
+#include "sssp.h"
+
+#define CH_NO_MIDDLE (-1) // Middle vertex of an original edge
+#define CH_WITNESS_SETTLE_LIMIT 500 // Vertices one witness search may settle
+#define CH_PRIORITY_BIAS MAX_LARGE_VERTEX_NUM // Keeps the ordering keys of the heap positive
+
+/* An arc of the hierarchy. A shortcut u -> w stands for u -> middle -> w, where middle was
+contracted before u and w */
+typedef struct ChArc
+{
+	int vertex;
+	int distance;
+	int middle; // CH_NO_MIDDLE for an original edge
+}ChArc;
+
+/* Growable arc list of one vertex of the graph being contracted */
+typedef struct ChArcList
+{
+	ChArc *pstArcs;
+	int noOfArcs;
+	int capacity;
+}ChArcList;
+
+/* State of the contraction. Once a vertex is contracted its lists are frozen and only hold
+arcs to vertices contracted after it: pstOut[v] are its upward arcs, pstIn[v] the arcs
+from higher vertices into it */
+typedef struct ChBuilder
+{
+	int noOfVertex;
+	ChArcList *pstOut;
+	ChArcList *pstIn;
+	char *pContracted;
+	int *piDeletedNeighbours; // Contracted neighbours, part of the priority
+	int *piRank; // Contraction order
+	int noOfShortcuts;
+	SsspWorkspace *pstWitness;
+}ChBuilder;
+
+/* Start of the hierarchy section of a binary graph file. It is followed by int rank[V],
+int upOffsets[V + 1], ChArc up[noOfUpArcs], int downOffsets[V + 1] and
+ChArc down[noOfDownArcs]. up[v] are the arcs v -> w, down[v] the arcs w -> v, in both
+cases with rank[w] > rank[v] */
+typedef struct ChSectionHeader
+{
+	int noOfVertex;
+	int noOfUpArcs;
+	int noOfDownArcs;
+	int noOfShortcuts;
+}ChSectionHeader;
+
+/* The hierarchy in memory, pointing into a hierarchy section */
+typedef struct ChGraph
+{
+	int noOfVertex;
+	int noOfShortcuts;
+	int *piRank;
+	int *piUpOffsets;
+	ChArc *pstUpArcs;
+	int *piDownOffsets;
+	ChArc *pstDownArcs;
+}ChGraph;
+
+/* Working memory of the upward bidirectional query. The parents keep the arc each vertex
+was reached by, so that the path can be unpacked */
+typedef struct ChQuery
+{
+	ChGraph *pstGraph;
+	SsspWorkspace *pstForward;
+	SsspWorkspace *pstBackward;
+	int *piForwardArc; // Index into pstUpArcs
+	int *piBackwardArc; // Index into pstDownArcs
+	int *piForwardParent;
+	int *piBackwardParent;
+	int noOfStalled;
+	SsspMeeting stMeeting;
+	int *piPath; // Unpacked path of the last query
+	int pathLength;
+}ChQuery;
+
+/* Bytes of a hierarchy section */
+#define CH_SECTION_SIZE(noOfVertex, noOfUpArcs, noOfDownArcs) \
+	((long long)sizeof(ChSectionHeader) + ((long long)sizeof(int) * (noOfVertex)) \
+	+ ((long long)sizeof(int) * 2 * ((noOfVertex) + 1)) \
+	+ ((long long)sizeof(ChArc) * ((noOfUpArcs) + (noOfDownArcs))))
+
+#endif
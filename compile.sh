@@ -1,2 +1,2 @@
 #!/bin/bash
-gcc -o output main.c random.c utility.c adjlist.c simple.c bino.c fibo.c
+gcc -o output main.c random.c utility.c adjlist.c simple.c bino.c fibo.c graphio.c shmpub.c pq.c sssp.c stream.c distmat.c extmem.c alt.c coord.c ch.c arcflags.c overlay.c hublabel.c tz.c rowcache.c batch.c manytomany.c yen.c johnson.c voronoi.c mst.c eccentricity.c brandes.c -lrt -lpthread -lm
@@ -0,0 +1,293 @@
+/***************************************************************************************************/
+// COORD.C
+// Contains all functions for the geometric A* search: reading DIMACS coordinates, the
+// coordinate section of the binary graph format and the benchmark against plain Dijkstra
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "graphio.h"
+#include "sssp.h"
+#include "coord.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern GraphFile* openGraphFile(char *fileName);
+extern void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size);
+extern long long getWallTimeUsec();
+
+char *coordMetricString[TOTAL_COORD_METRICS] = {"euclidean", "manhattan"};
+
+/* Geometric length between two vertices in the given metric */
+double getCoordLength(VertexCoord *pstCoords, int metric, int u, int v)
+{
+	double dx = (double)pstCoords[u].x - pstCoords[v].x;
+	double dy = (double)pstCoords[u].y - pstCoords[v].y;
+
+	if (COORD_MANHATTAN == metric)
+	{
+		return ((dx < 0) ? -dx : dx) + ((dy < 0) ? -dy : dy);
+	}
+
+	return sqrt((dx * dx) + (dy * dy));
+}
+
+/* The coordinate potential: the scaled geometric length to the target. Rounding down
+keeps it consistent since the weights are integers */
+int coordPotential(void *pPotentialCtx, int vertex)
+{
+	CoordPotential *pstCoord = (CoordPotential *)pPotentialCtx;
+
+	return (int)(pstCoord->scale
+		* getCoordLength(pstCoord->pstCoords, pstCoord->metric, vertex, pstCoord->target));
+}
+
+/* Returns the smallest weight per unit of length over all edges. Edges of zero length do
+not constrain it. 0 if no edge has a length, which degrades A* to Dijkstra */
+double getCoordScale(AdjList *pstAdjList, VertexCoord *pstCoords, int metric)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	double length, scale = -1;
+	int u;
+
+	for (u = 0; u < gNoOfVertex; u++)
+	{
+		for (pstTraverser = pstAdjList[u].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			length = getCoordLength(pstCoords, metric, u, pstTraverser->vertexNum);
+			if ((length > 0) && ((scale < 0) || (pstTraverser->distance / length < scale)))
+			{
+				scale = pstTraverser->distance / length;
+			}
+		}
+	}
+
+	return (scale < 0) ? 0 : scale;
+}
+
+/* Reads a DIMACS coordinate file (.co). Vertex lines are "v <id> <x> <y>" with ids from 1,
+so DIMACS vertex id becomes vertex id - 1. Every vertex of the graph needs coordinates.
+Returns the coordinates of noOfVertex vertices, NULL on failure */
+VertexCoord* readDimacsCoords(char *fileName, int noOfVertex)
+{
+	VertexCoord *pstCoords = NULL_PTR;
+	FILE *pFile = NULL_PTR;
+	char fileLine[128], *pHasCoord = NULL_PTR;
+	int id, x, y, noOfRead = 0;
+
+	pFile = fopen(fileName, "r");
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "Could not open [%s]!", fileName);
+		return NULL_PTR;
+	}
+
+	pstCoords = (VertexCoord *)malloc(sizeof(VertexCoord) * noOfVertex);
+	pHasCoord = (char *)calloc(noOfVertex, sizeof(char));
+	if ((NULL_PTR == pstCoords) || (NULL_PTR == pHasCoord))
+	{
+		myLog(ERROR, "Failed to allocate coordinates!");
+		free(pstCoords);
+		free(pHasCoord);
+		fclose(pFile);
+		return NULL_PTR;
+	}
+
+	/* Comment and problem lines are skipped */
+	while (NULL_PTR != fgets(fileLine, sizeof(fileLine), pFile))
+	{
+		if (('v' != fileLine[0]) || (3 != sscanf(fileLine + 1, "%d %d %d", &id, &x, &y)))
+		{
+			continue;
+		}
+
+		if ((id < 1) || (id > noOfVertex))
+		{
+			myLog(ERROR, "Vertex [%d] of [%s] is not in the graph!", id, fileName);
+			continue;
+		}
+
+		pstCoords[id - 1].x = x;
+		pstCoords[id - 1].y = y;
+		if (FALSE == pHasCoord[id - 1])
+		{
+			pHasCoord[id - 1] = TRUE;
+			noOfRead++;
+		}
+	}
+
+	fclose(pFile);
+	free(pHasCoord);
+
+	if (noOfRead != noOfVertex)
+	{
+		myLog(ERROR, "[%s] has coordinates for [%d] of [%d] vertices!", fileName, noOfRead, noOfVertex);
+		free(pstCoords);
+		return NULL_PTR;
+	}
+
+	return pstCoords;
+}
+
+/* Entry function for coordinate mode. Stores the coordinates of the DIMACS file coFileName
+in the binary graph file fileName */
+int coordProc(char *fileName, char *coFileName)
+{
+	GraphFile *pstGraphFile = NULL_PTR;
+	VertexCoord *pstCoords = NULL_PTR;
+	int noOfVertex, retVal;
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR == pstGraphFile)
+	{
+		myLog(ERROR, "[%s] is not a binary graph file! Convert it with -g first", fileName);
+		return ERR;
+	}
+
+	noOfVertex = pstGraphFile->pstHeader->noOfVertex;
+	closeGraphFile(pstGraphFile);
+
+	pstCoords = readDimacsCoords(coFileName, noOfVertex);
+	if (NULL_PTR == pstCoords)
+	{
+		myLog(ERROR, "readDimacsCoords failed!");
+		return ERR;
+	}
+
+	retVal = setGraphFileSection(fileName, GRAPH_SECTION_COORDS, pstCoords,
+		(long long)sizeof(VertexCoord) * noOfVertex);
+	free(pstCoords);
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "setGraphFileSection failed!");
+		return ERR;
+	}
+
+	printf("Stored coordinates of [%d] vertices in [%s]\n", noOfVertex, fileName);
+
+	return OK;
+}
+
+/* Entry function for the A* benchmark. Runs random point to point queries on the binary
+graph file fileName with plain Dijkstra and with coordinate A* on the same heap and prints
+the average settled vertices and latency of both */
+int astarBenchProc(int scheme, char *fileName, char *queriesArg, char *metricArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	GraphFile *pstGraphFile = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	CoordPotential stCoord;
+	VertexCoord *pstCoords = NULL_PTR;
+	long long size = 0, startTime, plainUsec = 0, astarUsec = 0, plainSettled = 0, astarSettled = 0;
+	int noOfQueries = DEFAULT_COORD_QUERIES, metric = COORD_EUCLIDEAN;
+	int i, source, destination, plainDistance, astarDistance, retVal = OK;
+
+	if (NULL_PTR != queriesArg)
+	{
+		noOfQueries = atoi(queriesArg);
+	}
+
+	if (NULL_PTR != metricArg)
+	{
+		for (metric = 0; metric < TOTAL_COORD_METRICS; metric++)
+		{
+			if (0 == strcmp(metricArg, coordMetricString[metric]))
+			{
+				break;
+			}
+		}
+	}
+
+	if ((noOfQueries <= 0) || (TOTAL_COORD_METRICS == metric))
+	{
+		myLog(ERROR, "Invalid Input! Queries must be positive, metric euclidean or manhattan");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR != pstGraphFile)
+	{
+		pstCoords = (VertexCoord *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_COORDS, &size);
+	}
+
+	if ((NULL_PTR == pstCoords) || (size != (long long)sizeof(VertexCoord) * gNoOfVertex))
+	{
+		myLog(ERROR, "[%s] has no coordinates! Store them with -co first", fileName);
+		closeGraphFile(pstGraphFile);
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+		closeGraphFile(pstGraphFile);
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	stCoord.pstCoords = pstCoords;
+	stCoord.metric = metric;
+	stCoord.scale = getCoordScale(pstAdjList, pstCoords, metric);
+
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+	for (i = 0; i < noOfQueries; i++)
+	{
+		source = rand() % gNoOfVertex;
+		destination = rand() % gNoOfVertex;
+
+		ssspSetPotential(pstWorkspace, NULL_PTR, NULL_PTR);
+		startTime = getWallTimeUsec();
+		plainDistance = ssspPointToPoint(pstWorkspace, pstAdjList, source, destination);
+		plainUsec += getWallTimeUsec() - startTime;
+		plainSettled += pstWorkspace->noOfSettled;
+
+		stCoord.target = destination;
+		ssspSetPotential(pstWorkspace, coordPotential, &stCoord);
+		startTime = getWallTimeUsec();
+		astarDistance = ssspPointToPoint(pstWorkspace, pstAdjList, source, destination);
+		astarUsec += getWallTimeUsec() - startTime;
+		astarSettled += pstWorkspace->noOfSettled;
+
+		if ((ERR == plainDistance) || (plainDistance != astarDistance))
+		{
+			myLog(ERROR, "Query [%d] -> [%d]: plain [%d], A* [%d]!",
+				source, destination, plainDistance, astarDistance);
+			retVal = ERR;
+			break;
+		}
+	}
+
+	if (OK == retVal)
+	{
+		printf("\n%s: [%d] queries, %s metric, scale [%f]\n"
+			"Plain:\tAverage settled: [%lld] Average time: [%lld] usec\n"
+			"A*:\tAverage settled: [%lld] Average time: [%lld] usec\n",
+			schemeString[scheme], noOfQueries, coordMetricString[metric], stCoord.scale,
+			plainSettled / noOfQueries, plainUsec / noOfQueries,
+			astarSettled / noOfQueries, astarUsec / noOfQueries);
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	closeGraphFile(pstGraphFile);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
@@ -0,0 +1,37 @@
+/***************************************************************************************************/
+// COORD.H
+// Contains the vertex coordinates used by the geometric A* search
+/***************************************************************************************************/
+
+#ifndef __COORD__
+#define __COORD__
+
+#include "header.h"
+
+#define DEFAULT_COORD_QUERIES 100
+
+typedef enum COORD_METRIC_ENUM
+{
+	COORD_EUCLIDEAN = 0,
+	COORD_MANHATTAN,
+	TOTAL_COORD_METRICS
+}COORD_METRIC_E;
+
+/* One entry of the coordinate section of a binary graph file, one per vertex */
+typedef struct VertexCoord
+{
+	int x;
+	int y;
+}VertexCoord;
+
+/* Context of the coordinate potential of one query. scale is the smallest edge weight per
+unit of geometric length, so scale times the length to the target never overestimates */
+typedef struct CoordPotential
+{
+	VertexCoord *pstCoords;
+	int metric; // COORD_METRIC_E
+	double scale;
+	int target;
+}CoordPotential;
+
+#endif
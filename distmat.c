@@ -0,0 +1,368 @@
+/***************************************************************************************************/
+// DISTMAT.C
+// Contains all functions for the memory mapped, tiled distance matrix file. The file is the
+// backend of the out of core all pairs mode and the result artifact at the same time
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "stream.h"
+#include "distmat.h"
+
+extern int gNoOfVertex;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+
+/* Unmaps and closes the file. A writer flushes everything and marks the file complete
+if isComplete is TRUE */
+void closeDistMat(DistMat *pstDistMat, int isComplete)
+{
+	if (NULL_PTR == pstDistMat)
+	{
+		return;
+	}
+
+	if (MAP_FAILED != (void *)pstDistMat->pMap)
+	{
+		if (TRUE == pstDistMat->isWritable)
+		{
+			/* The flag goes to disk only after the data it vouches for */
+			(void)msync(pstDistMat->pMap, (size_t)pstDistMat->mapSize, MS_SYNC);
+			if (TRUE == isComplete)
+			{
+				pstDistMat->pstHeader->isComplete = TRUE;
+				(void)msync(pstDistMat->pMap, DIST_MAT_DATA_OFFSET, MS_SYNC);
+			}
+		}
+		(void)munmap(pstDistMat->pMap, (size_t)pstDistMat->mapSize);
+	}
+
+	if (pstDistMat->fd >= 0)
+	{
+		close(pstDistMat->fd);
+	}
+
+	free(pstDistMat->piBandRows);
+	free(pstDistMat);
+}
+
+/* Allocates a DistMat with nothing opened yet */
+DistMat* allocDistMat()
+{
+	DistMat *pstDistMat = NULL_PTR;
+
+	pstDistMat = (DistMat *)calloc(1, sizeof(DistMat));
+	if (NULL_PTR == pstDistMat)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstDistMat->fd = -1;
+	pstDistMat->pMap = (char *)MAP_FAILED;
+
+	return pstDistMat;
+}
+
+/* Creates fileName for a noOfVertex x noOfVertex matrix and maps it for writing. The file
+is sparse until rows are written, so its size is not limited by memory or free disk */
+DistMat* createDistMat(char *fileName, int noOfVertex, int scheme)
+{
+	DistMat *pstDistMat = NULL_PTR;
+	DistMatHeader *pstHeader = NULL_PTR;
+	int noOfTiles;
+
+	if ((NULL_PTR == fileName) || (noOfVertex <= 0))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	pstDistMat = allocDistMat();
+	if (NULL_PTR == pstDistMat)
+	{
+		return NULL_PTR;
+	}
+
+	noOfTiles = DIST_MAT_TILES(noOfVertex);
+	pstDistMat->isWritable = TRUE;
+	pstDistMat->mapSize = DIST_MAT_DATA_OFFSET
+		+ ((long long)sizeof(int) * DIST_MAT_TILE * DIST_MAT_TILE * noOfTiles * noOfTiles);
+	pstDistMat->piBandRows = (int *)calloc(noOfTiles, sizeof(int));
+	if (NULL_PTR == pstDistMat->piBandRows)
+	{
+		myLog(ERROR, "calloc failed!");
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	pstDistMat->fd = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (pstDistMat->fd < 0)
+	{
+		myLog(ERROR, "Could not create [%s]!", fileName);
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	if (0 != ftruncate(pstDistMat->fd, (off_t)pstDistMat->mapSize))
+	{
+		myLog(ERROR, "Could not size [%s] to [%lld] bytes!", fileName, pstDistMat->mapSize);
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	pstDistMat->pMap = (char *)mmap(NULL, (size_t)pstDistMat->mapSize,
+		PROT_READ | PROT_WRITE, MAP_SHARED, pstDistMat->fd, 0);
+	if (MAP_FAILED == (void *)pstDistMat->pMap)
+	{
+		myLog(ERROR, "mmap of [%s] failed!", fileName);
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	/* Sources are handed out in order, so the bands fill front to back */
+	(void)madvise(pstDistMat->pMap, (size_t)pstDistMat->mapSize, MADV_SEQUENTIAL);
+
+	pstHeader = (DistMatHeader *)pstDistMat->pMap;
+	pstDistMat->pstHeader = pstHeader;
+
+	(void)memcpy(pstHeader->magic, DIST_MAT_MAGIC, DIST_MAT_MAGIC_LEN);
+	pstHeader->version = DIST_MAT_VERSION;
+	pstHeader->noOfVertex = noOfVertex;
+	pstHeader->tileSize = DIST_MAT_TILE;
+	pstHeader->noOfTiles = noOfTiles;
+	pstHeader->scheme = scheme;
+	pstHeader->timeMsec = INVALID_TIME;
+	pstHeader->isComplete = FALSE;
+	pstHeader->fileSize = pstDistMat->mapSize;
+
+	return pstDistMat;
+}
+
+/* Maps a complete distance matrix file read-only */
+DistMat* openDistMat(char *fileName)
+{
+	DistMat *pstDistMat = NULL_PTR;
+	DistMatHeader *pstHeader = NULL_PTR;
+	struct stat stFileStat;
+
+	if (NULL_PTR == fileName)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	pstDistMat = allocDistMat();
+	if (NULL_PTR == pstDistMat)
+	{
+		return NULL_PTR;
+	}
+
+	pstDistMat->fd = open(fileName, O_RDONLY);
+	if ((pstDistMat->fd < 0)
+		|| (0 != fstat(pstDistMat->fd, &stFileStat))
+		|| (stFileStat.st_size < DIST_MAT_DATA_OFFSET))
+	{
+		myLog(ERROR, "[%s] is not a distance matrix file!", fileName);
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	pstDistMat->mapSize = stFileStat.st_size;
+	pstDistMat->pMap = (char *)mmap(NULL, (size_t)pstDistMat->mapSize,
+		PROT_READ, MAP_SHARED, pstDistMat->fd, 0);
+	if (MAP_FAILED == (void *)pstDistMat->pMap)
+	{
+		myLog(ERROR, "mmap of [%s] failed!", fileName);
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	pstHeader = (DistMatHeader *)pstDistMat->pMap;
+	pstDistMat->pstHeader = pstHeader;
+
+	if ((0 != memcmp(pstHeader->magic, DIST_MAT_MAGIC, DIST_MAT_MAGIC_LEN))
+		|| (DIST_MAT_VERSION != pstHeader->version)
+		|| (DIST_MAT_TILE != pstHeader->tileSize)
+		|| (pstHeader->noOfVertex <= 0)
+		|| (DIST_MAT_TILES(pstHeader->noOfVertex) != pstHeader->noOfTiles)
+		|| (pstHeader->fileSize != pstDistMat->mapSize))
+	{
+		myLog(ERROR, "[%s] has an invalid header!", fileName);
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	if (TRUE != pstHeader->isComplete)
+	{
+		myLog(ERROR, "[%s] was not written completely!", fileName);
+		closeDistMat(pstDistMat, FALSE);
+		return NULL_PTR;
+	}
+
+	/* Lookups jump around, read ahead would only pull in pages nobody asked for */
+	(void)madvise(pstDistMat->pMap, (size_t)pstDistMat->mapSize, MADV_RANDOM);
+
+	return pstDistMat;
+}
+
+/* Row sink which copies the row straight into the mapping. Workers own disjoint rows, so
+no lock is needed. The last row of a band schedules the band for writeback and drops it
+from this process, leaving residency to the page cache */
+int distMatRowSink(void *pSinkCtx, int source, int *piRow, int noOfVertex)
+{
+	DistMat *pstDistMat = (DistMat *)pSinkCtx;
+	DistMatHeader *pstHeader = pstDistMat->pstHeader;
+	char *pBand = NULL_PTR;
+	int tile, band, bandRows, noOfCols;
+
+	for (tile = 0; tile < pstHeader->noOfTiles; tile++)
+	{
+		noOfCols = MIN(DIST_MAT_TILE, noOfVertex - (tile * DIST_MAT_TILE));
+		(void)memcpy(DIST_MAT_ENTRY(pstHeader, source, tile * DIST_MAT_TILE),
+			piRow + (tile * DIST_MAT_TILE), sizeof(int) * noOfCols);
+	}
+
+	band = source / DIST_MAT_TILE;
+	bandRows = MIN(DIST_MAT_TILE, noOfVertex - (band * DIST_MAT_TILE));
+
+	if (bandRows == __sync_add_and_fetch(&pstDistMat->piBandRows[band], 1))
+	{
+		pBand = pstDistMat->pMap + DIST_MAT_DATA_OFFSET + (band * DIST_MAT_BAND_SIZE(pstHeader));
+		(void)msync(pBand, (size_t)DIST_MAT_BAND_SIZE(pstHeader), MS_ASYNC);
+		(void)madvise(pBand, (size_t)DIST_MAT_BAND_SIZE(pstHeader), MADV_DONTNEED);
+	}
+
+	return OK;
+}
+
+/* Entry function for the out of core all pairs mode. Solves every source of the graph in
+fileName and writes the rows into the tiled matrix file matFileName */
+int distMatProc(int scheme, char *fileName, char *matFileName, char *threadsArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	DistMat *pstDistMat = NULL_PTR;
+	RowSink stSink;
+	int noOfThreads, timeMsec;
+
+	if (NULL_PTR == matFileName)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	noOfThreads = getWorkerThreadCount(threadsArg);
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	pstDistMat = createDistMat(matFileName, gNoOfVertex, scheme);
+	if (NULL_PTR == pstDistMat)
+	{
+		myLog(ERROR, "createDistMat failed!");
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	stSink.pfnSink = distMatRowSink;
+	stSink.pSinkCtx = pstDistMat;
+
+	timeMsec = runStreamingScheme(scheme, pstAdjList, &stSink, noOfThreads);
+	destroyAdjList(pstAdjList);
+
+	pstDistMat->pstHeader->timeMsec = timeMsec;
+	closeDistMat(pstDistMat, (INVALID_TIME != timeMsec));
+
+	if (INVALID_TIME == timeMsec)
+	{
+		myLog(ERROR, "runStreamingScheme failed!");
+		return ERR;
+	}
+
+	printf("\n%s: [%d] vertices, [%d] workers, [%d] msec, written to [%s]\n",
+		schemeString[scheme], gNoOfVertex, noOfThreads, timeMsec, matFileName);
+
+	return OK;
+}
+
+/* Entry function for distance matrix queries. Prints the header, the row of source or
+the single entry (source, destination) */
+int distMatQueryProc(char *matFileName, char *sourceArg, char *destinationArg)
+{
+	DistMat *pstDistMat = NULL_PTR;
+	DistMatHeader *pstHeader = NULL_PTR;
+	int source = 0, destination = 0, i, distance;
+
+	pstDistMat = openDistMat(matFileName);
+	if (NULL_PTR == pstDistMat)
+	{
+		myLog(ERROR, "openDistMat failed!");
+		return ERR;
+	}
+
+	pstHeader = pstDistMat->pstHeader;
+
+	if (NULL_PTR != sourceArg)
+	{
+		source = atoi(sourceArg);
+	}
+	if (NULL_PTR != destinationArg)
+	{
+		destination = atoi(destinationArg);
+	}
+
+	if ((source < 0) || (source >= pstHeader->noOfVertex)
+		|| (destination < 0) || (destination >= pstHeader->noOfVertex))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", pstHeader->noOfVertex);
+		closeDistMat(pstDistMat, FALSE);
+		return ERR;
+	}
+
+	printf("\nScheme: [%s] Vertices: [%d] Time: [%d] msec\n",
+		((pstHeader->scheme >= 0) && (pstHeader->scheme < TOTAL_SCHEMES))
+		? schemeString[pstHeader->scheme] : "UNKNOWN", pstHeader->noOfVertex, pstHeader->timeMsec);
+
+	if (NULL_PTR != destinationArg)
+	{
+		distance = *DIST_MAT_ENTRY(pstHeader, source, destination);
+		if (INFINITY == distance)
+		{
+			printf("%d -> %d: -\n", source, destination);
+		}
+		else
+		{
+			printf("%d -> %d: %d\n", source, destination, distance);
+		}
+	}
+	else if (NULL_PTR != sourceArg)
+	{
+		printf("\n%d   |\t", source);
+		for (i = 0; i < pstHeader->noOfVertex; i++)
+		{
+			distance = *DIST_MAT_ENTRY(pstHeader, source, i);
+			if (INFINITY == distance)
+			{
+				printf("-\t");
+			}
+			else
+			{
+				printf("%d\t", distance);
+			}
+		}
+		printf("\n\n");
+	}
+
+	closeDistMat(pstDistMat, FALSE);
+
+	return OK;
+}
@@ -0,0 +1,62 @@
+/***************************************************************************************************/
+// DISTMAT.H
+// Contains the on-disk layout of the tiled distance matrix file
+/***************************************************************************************************/
+
+#ifndef __DISTMAT__
+#define __DISTMAT__
+
+#include "header.h"
+
+/* A distance matrix file is a one page header followed by int dist[V][V] cut into
+DIST_MAT_TILE x DIST_MAT_TILE tiles. Tiles are stored in row major order of tiles and every
+tile is row major inside. Tiles on the right and bottom edge are padded to full size, so the
+address of an entry is pure arithmetic. A band of DIST_MAT_TILE rows is contiguous, which
+is the unit the writer flushes and the page cache evicts */
+
+#define DIST_MAT_MAGIC "DJKM"
+#define DIST_MAT_MAGIC_LEN 4
+#define DIST_MAT_VERSION 1
+#define DIST_MAT_TILE 64 // 16 KB of ints per tile
+#define DIST_MAT_DATA_OFFSET 4096 // Keeps the tiles page aligned
+
+/* First bytes of every distance matrix file */
+typedef struct DistMatHeader
+{
+	char magic[DIST_MAT_MAGIC_LEN];
+	int version;
+	int noOfVertex;
+	int tileSize;
+	int noOfTiles; // Tiles per row and per column
+	int scheme; // BINARY_SCHEME / BINO_SCHEME / FIBO_SCHEME
+	int timeMsec; // Time taken to fill the matrix
+	int isComplete; // TRUE once every row has been written
+	long long fileSize;
+}DistMatHeader;
+
+/* An open distance matrix file */
+typedef struct DistMat
+{
+	int fd;
+	int isWritable;
+	char *pMap;
+	long long mapSize;
+	DistMatHeader *pstHeader;
+	int *piBandRows; // Writer only: rows finished in each band of tiles
+}DistMat;
+
+/* Number of tiles needed along one side for noOfVertex vertices */
+#define DIST_MAT_TILES(noOfVertex) (((noOfVertex) + DIST_MAT_TILE - 1) / DIST_MAT_TILE)
+
+/* Bytes in one band of tiles */
+#define DIST_MAT_BAND_SIZE(pstHeader) \
+	((long long)sizeof(int) * DIST_MAT_TILE * DIST_MAT_TILE * (pstHeader)->noOfTiles)
+
+/* Address of the entry (row, col) */
+#define DIST_MAT_ENTRY(pstHeader, row, col) \
+	((int *)((char *)(pstHeader) + DIST_MAT_DATA_OFFSET \
+	+ ((long long)(row) / DIST_MAT_TILE) * DIST_MAT_BAND_SIZE(pstHeader)) \
+	+ ((long long)(col) / DIST_MAT_TILE) * DIST_MAT_TILE * DIST_MAT_TILE \
+	+ ((row) % DIST_MAT_TILE) * DIST_MAT_TILE + ((col) % DIST_MAT_TILE))
+
+#endif
@@ -0,0 +1,426 @@
+/***************************************************************************************************/
+// ECCENTRICITY.C
+// Contains all functions for the exact eccentricity and diameter mode. The eccentricities are
+// bounded from a few forward and backward searches instead of all pairs
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sssp.h"
+#include "stream.h"
+#include "eccentricity.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern AdjList* buildReverseAdjList(AdjList *pstAdjList);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeMsec();
+
+/* Frees the bounds */
+void destroyEccentricityBounds(EccentricityBounds *pstBounds)
+{
+	free(pstBounds->piLower);
+	free(pstBounds->piUpper);
+	free(pstBounds->pDone);
+	free(pstBounds->piDegree);
+	(void)memset(pstBounds, 0, sizeof(EccentricityBounds));
+}
+
+/* Starts every vertex at [0, INFINITY]. Returns OK or ERR */
+int initEccentricityBounds(EccentricityBounds *pstBounds, AdjList *pstAdjList)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	int i;
+
+	(void)memset(pstBounds, 0, sizeof(EccentricityBounds));
+	pstBounds->piLower = (int *)calloc(gNoOfVertex, sizeof(int));
+	pstBounds->piUpper = (int *)malloc(sizeof(int) * gNoOfVertex);
+	pstBounds->pDone = (char *)calloc(gNoOfVertex, sizeof(char));
+	pstBounds->piDegree = (int *)calloc(gNoOfVertex, sizeof(int));
+
+	if ((NULL_PTR == pstBounds->piLower) || (NULL_PTR == pstBounds->piUpper)
+		|| (NULL_PTR == pstBounds->pDone) || (NULL_PTR == pstBounds->piDegree))
+	{
+		myLog(ERROR, "malloc failed!");
+		destroyEccentricityBounds(pstBounds);
+		return ERR;
+	}
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		pstBounds->piUpper[i] = INFINITY;
+		for (pstTraverser = pstAdjList[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			pstBounds->piDegree[i]++;
+		}
+	}
+
+	return OK;
+}
+
+/* Next vertex to search: the open vertex with the largest upper bound, or with the smallest
+lower bound, the larger degree first on ties. Returns -1 once every vertex is done */
+int chooseEccentricityVertex(EccentricityBounds *pstBounds, int isUpper)
+{
+	int i, best = -1, key, bestKey = 0;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		if (TRUE == pstBounds->pDone[i])
+		{
+			continue;
+		}
+
+		key = (TRUE == isUpper) ? pstBounds->piUpper[i] : -pstBounds->piLower[i];
+		if ((-1 == best) || (key > bestKey)
+			|| ((key == bestKey) && (pstBounds->piDegree[i] > pstBounds->piDegree[best])))
+		{
+			best = i;
+			bestKey = key;
+		}
+	}
+
+	return best;
+}
+
+/* TRUE if every edge (u, v) has a reverse edge (v, u) of the same cost. Then d(v, w) equals
+d(w, v) and the forward row of a vertex doubles as its backward row */
+int isSymmetricAdjList(AdjList *pstAdjList)
+{
+	AdjList *pstTraverser = NULL_PTR, *pstReverse = NULL_PTR;
+	int i;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		for (pstTraverser = pstAdjList[i].next; NULL_PTR != pstTraverser; pstTraverser = pstTraverser->next)
+		{
+			for (pstReverse = pstAdjList[pstTraverser->vertexNum].next; NULL_PTR != pstReverse;
+				pstReverse = pstReverse->next)
+			{
+				if ((i == pstReverse->vertexNum) && (pstTraverser->distance == pstReverse->distance))
+				{
+					break;
+				}
+			}
+
+			if (NULL_PTR == pstReverse)
+			{
+				return FALSE;
+			}
+		}
+	}
+
+	return TRUE;
+}
+
+/* Tightens every open vertex with the forward row d(w, v) of the searched vertex w and, if
+not NULL_PTR, its backward row d(v, w). Without the backward row only the lower bounds
+move, except for w itself whose eccentricity the forward row gives exactly. An unreached
+vertex makes an eccentricity INFINITY: if v can not reach w, or w reaches v but not
+everything, then v does not reach everything either. With isDiameter a vertex whose upper
+bound can not beat the largest lower bound is dropped too */
+void updateEccentricityBounds(EccentricityBounds *pstBounds, int vertex, int *piForward, int *piBackward,
+	int isDiameter)
+{
+	int i, eccentricity = 0, lower, upper;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		eccentricity = MAX(eccentricity, piForward[i]);
+	}
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		if (TRUE == pstBounds->pDone[i])
+		{
+			continue;
+		}
+
+		lower = (NULL_PTR != piBackward) ? piBackward[i] : 0;
+		upper = INFINITY;
+
+		if (INFINITY == eccentricity)
+		{
+			lower = (INFINITY != piForward[i]) ? INFINITY : lower;
+		}
+		else if (INFINITY != lower)
+		{
+			lower = MAX(lower, eccentricity - piForward[i]);
+			if (i == vertex)
+			{
+				upper = eccentricity;
+			}
+			else if (NULL_PTR != piBackward)
+			{
+				upper = piBackward[i] + eccentricity;
+			}
+		}
+
+		pstBounds->piLower[i] = MAX(pstBounds->piLower[i], lower);
+		pstBounds->piUpper[i] = (INFINITY == pstBounds->piLower[i])
+			? INFINITY : MIN(pstBounds->piUpper[i], upper);
+		pstBounds->diameterLower = MAX(pstBounds->diameterLower, pstBounds->piLower[i]);
+
+		if (pstBounds->piLower[i] == pstBounds->piUpper[i])
+		{
+			pstBounds->pDone[i] = TRUE;
+			pstBounds->noOfDone++;
+		}
+	}
+
+	for (i = 0; (i < gNoOfVertex) && (TRUE == isDiameter); i++)
+	{
+		if ((FALSE == pstBounds->pDone[i]) && (pstBounds->piUpper[i] <= pstBounds->diameterLower))
+		{
+			pstBounds->pDone[i] = TRUE;
+			pstBounds->noOfDone++;
+		}
+	}
+}
+
+/* Searches chosen vertices until every vertex is done. The choice alternates between the
+largest upper and the smallest lower bound. A forward search alone settles the searched
+vertex, so a backward search is only spent while the rounds close more vertices than they
+search, and all finds every eccentricity in at most the V searches of all pairs. There a
+round whose backward search closes nothing but the searched vertex, other than the first
+which only sets up the bounds, ends the backward searches. On a symmetric graph the forward
+row is the backward row and every round is one search. Returns OK or ERR */
+int runEccentricityBounds(SsspWorkspace *pstForward, SsspWorkspace *pstBackward, AdjList *pstAdjList,
+	AdjList *pstReverseList, EccentricityBounds *pstBounds, int isDiameter)
+{
+	int *piBackward = NULL_PTR;
+	int vertex, noOfDone, round = 0, noOfBackward = 0, isSymmetric, isBounding = TRUE;
+
+	isSymmetric = isSymmetricAdjList(pstAdjList);
+
+	while (pstBounds->noOfDone < gNoOfVertex)
+	{
+		vertex = chooseEccentricityVertex(pstBounds, (0 == round % 2));
+		noOfDone = pstBounds->noOfDone;
+		round++;
+
+		if (OK != ssspComputeRow(pstForward, pstAdjList, vertex))
+		{
+			myLog(ERROR, "ssspComputeRow failed for vertex [%d]!", vertex);
+			return ERR;
+		}
+		pstBounds->noOfSearches++;
+		piBackward = (TRUE == isSymmetric) ? pstForward->piDist : NULL_PTR;
+
+		/* The searched vertex closes with this round, so the backward search is covered
+		once the earlier rounds closed more vertices than they searched. Dropping vertices
+		needs upper bounds, so the diameter gets its first backward search uncovered */
+		if ((FALSE == isSymmetric) && (TRUE == isBounding)
+			&& ((pstBounds->noOfSearches <= noOfDone) || ((TRUE == isDiameter) && (0 == noOfBackward))))
+		{
+			if (OK != ssspComputeRow(pstBackward, pstReverseList, vertex))
+			{
+				myLog(ERROR, "ssspComputeRow failed for vertex [%d]!", vertex);
+				return ERR;
+			}
+			pstBounds->noOfSearches++;
+			piBackward = pstBackward->piDist;
+		}
+
+		updateEccentricityBounds(pstBounds, vertex, pstForward->piDist, piBackward, isDiameter);
+
+		if ((NULL_PTR != piBackward) && (FALSE == isSymmetric) && (++noOfBackward > 1)
+			&& (FALSE == isDiameter) && (pstBounds->noOfDone - noOfDone <= 1))
+		{
+			isBounding = FALSE;
+		}
+
+		/* Nothing is beyond INFINITY */
+		if ((TRUE == isDiameter) && (INFINITY == pstBounds->diameterLower))
+		{
+			break;
+		}
+	}
+
+	return OK;
+}
+
+/* Writes "v: eccentricity", with "-" for INFINITY */
+int writeEccentricities(FILE *pFile, EccentricityBounds *pstBounds)
+{
+	int i;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		if (INFINITY == pstBounds->piLower[i])
+		{
+			fprintf(pFile, "%d: -\n", i);
+		}
+		else
+		{
+			fprintf(pFile, "%d: %d\n", i, pstBounds->piLower[i]);
+		}
+	}
+
+	return (0 == ferror(pFile)) ? OK : ERR;
+}
+
+/* Checks random vertices with a full search each: the eccentricity must be within the
+bounds and at most the diameter. Returns the number of wrong vertices, ERR on failure */
+int checkEccentricities(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, EccentricityBounds *pstBounds,
+	int diameter)
+{
+	int i, j, vertex, eccentricity, noOfWrong = 0;
+
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+	for (i = 0; i < MIN(ECCENTRICITY_CHECKED_VERTICES, gNoOfVertex); i++)
+	{
+		vertex = rand() % gNoOfVertex;
+		if (OK != ssspComputeRow(pstWorkspace, pstAdjList, vertex))
+		{
+			myLog(ERROR, "ssspComputeRow failed for vertex [%d]!", vertex);
+			return ERR;
+		}
+
+		eccentricity = 0;
+		for (j = 0; j < gNoOfVertex; j++)
+		{
+			eccentricity = MAX(eccentricity, pstWorkspace->piDist[j]);
+		}
+
+		if ((eccentricity < pstBounds->piLower[vertex]) || (eccentricity > pstBounds->piUpper[vertex])
+			|| (eccentricity > diameter))
+		{
+			myLog(ERROR, "Vertex [%d] has eccentricity [%d], bounds [%d, %d]!", vertex, eccentricity,
+				pstBounds->piLower[vertex], pstBounds->piUpper[vertex]);
+			noOfWrong++;
+		}
+	}
+
+	return noOfWrong;
+}
+
+/* Entry function for eccentricity mode. outName "all" (default) finds every eccentricity
+and prints the totals, "-" or a file name also writes them and "diameter" only finds the
+diameter, which drops more vertices early */
+int eccentricityProc(int scheme, char *fileName, char *outName)
+{
+	AdjList *pstAdjList = NULL_PTR, *pstReverseList = NULL_PTR;
+	SsspWorkspace *pstForward = NULL_PTR, *pstBackward = NULL_PTR;
+	EccentricityBounds stBounds;
+	FILE *pFile = NULL_PTR;
+	long long startTime;
+	int i, isDiameter, timeMsec, radius = INFINITY, noOfInfinite = 0, noOfExact = 0, noOfWrong;
+	int retVal = OK;
+
+	outName = (NULL_PTR != outName) ? outName : ECCENTRICITY_ALL_NAME;
+	isDiameter = (0 == strcmp(outName, ECCENTRICITY_DIAMETER_NAME));
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	(void)memset(&stBounds, 0, sizeof(stBounds));
+	pstReverseList = buildReverseAdjList(pstAdjList);
+	pstForward = createSsspWorkspace(scheme, gNoOfVertex);
+	pstBackward = createSsspWorkspace(scheme, gNoOfVertex);
+
+	if ((NULL_PTR == pstReverseList) || (NULL_PTR == pstForward) || (NULL_PTR == pstBackward)
+		|| (OK != initEccentricityBounds(&stBounds, pstAdjList)))
+	{
+		myLog(ERROR, "Failed to set up the searches!");
+		retVal = ERR;
+	}
+
+	if (OK == retVal)
+	{
+		startTime = getWallTimeMsec();
+		retVal = runEccentricityBounds(pstForward, pstBackward, pstAdjList, pstReverseList,
+			&stBounds, isDiameter);
+		timeMsec = (int)(getWallTimeMsec() - startTime);
+	}
+
+	if ((OK == retVal) && (FALSE == isDiameter) && (0 != strcmp(outName, ECCENTRICITY_ALL_NAME)))
+	{
+		pFile = (0 == strcmp(outName, ROW_SINK_STDOUT_NAME)) ? stdout : fopen(outName, "w");
+		if ((NULL_PTR == pFile) || (OK != writeEccentricities(pFile, &stBounds)))
+		{
+			myLog(ERROR, "Could not write the eccentricities to [%s]!", outName);
+			retVal = ERR;
+		}
+
+		if ((NULL_PTR != pFile) && (stdout != pFile))
+		{
+			fclose(pFile);
+		}
+	}
+
+	if (OK == retVal)
+	{
+		for (i = 0; i < gNoOfVertex; i++)
+		{
+			if (stBounds.piLower[i] == stBounds.piUpper[i])
+			{
+				noOfExact++;
+				noOfInfinite += (INFINITY == stBounds.piLower[i]);
+				radius = MIN(radius, stBounds.piLower[i]);
+			}
+		}
+
+		printf("\n%s: [%d] vertices, [%d] msec, [%d] searches instead of [%d] for all pairs\n",
+			schemeString[scheme], gNoOfVertex, timeMsec, stBounds.noOfSearches, gNoOfVertex);
+		if (INFINITY == stBounds.diameterLower)
+		{
+			printf("Diameter: [-], not every vertex reaches every other\n");
+		}
+		else
+		{
+			printf("Diameter: [%d]\n", stBounds.diameterLower);
+		}
+
+		if ((FALSE == isDiameter) && (INFINITY == radius))
+		{
+			printf("Radius: [-], every eccentricity is infinite\n");
+		}
+		else if (FALSE == isDiameter)
+		{
+			printf("Radius: [%d], [%d] infinite eccentricities\n", radius, noOfInfinite);
+		}
+		else
+		{
+			printf("[%d] eccentricities exact, the others can not exceed the diameter\n", noOfExact);
+		}
+
+		noOfWrong = checkEccentricities(pstForward, pstAdjList, &stBounds, stBounds.diameterLower);
+		printf("[%d] of [%d] random vertices differ from a full search\n", noOfWrong,
+			MIN(ECCENTRICITY_CHECKED_VERTICES, gNoOfVertex));
+
+		if (0 != noOfWrong)
+		{
+			myLog(ERROR, "checkEccentricities failed!");
+			retVal = ERR;
+		}
+
+		/* The diameter may spend one backward search no vertex pays for */
+		if (stBounds.noOfSearches > gNoOfVertex + ((TRUE == isDiameter) ? 1 : 0))
+		{
+			myLog(ERROR, "[%d] searches are more than all pairs needs!", stBounds.noOfSearches);
+			retVal = ERR;
+		}
+	}
+
+	destroySsspWorkspace(pstForward);
+	destroySsspWorkspace(pstBackward);
+	destroyEccentricityBounds(&stBounds);
+	if (NULL_PTR != pstReverseList)
+	{
+		destroyAdjList(pstReverseList);
+	}
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
@@ -0,0 +1,30 @@
+/***************************************************************************************************/
+// ECCENTRICITY.H
+// Contains the bounds of the exact eccentricity and diameter mode
+/***************************************************************************************************/
+
+#ifndef __ECCENTRICITY__
+#define __ECCENTRICITY__
+
+#include "header.h"
+
+#define ECCENTRICITY_CHECKED_VERTICES 10 // Random vertices whose eccentricity a full search checks
+#define ECCENTRICITY_ALL_NAME "all" // Every eccentricity, only the totals printed (default)
+#define ECCENTRICITY_DIAMETER_NAME "diameter" // Stop once the diameter is known
+
+/* Bounds on the eccentricity of every vertex, the longest distance out of it. Each chosen
+vertex w is searched forward, and backward while that pays off. Along with ecc(w) that
+gives, by the triangle inequality, max(d(v, w), ecc(w) - d(w, v)) <= ecc(v) <= d(v, w) + ecc(w).
+Without the backward row only ecc(w) - d(w, v) <= ecc(v) is left */
+typedef struct EccentricityBounds
+{
+	int *piLower;
+	int *piUpper;
+	char *pDone; // TRUE once the bounds met, or the vertex can not improve the diameter
+	int *piDegree; // Out degree, breaks the ties when choosing the next vertex
+	int noOfDone;
+	int noOfSearches; // Forward plus backward, at most V for all and V + 1 for the diameter
+	int diameterLower; // Largest lower bound so far
+}EccentricityBounds;
+
+#endif
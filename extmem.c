@@ -0,0 +1,715 @@
+/***************************************************************************************************/
+// EXTMEM.C
+// Contains all functions for the external memory mode. The edges stay on disk and are read
+// in large blocks, the priority queue spills sorted runs to temporary files
+/***************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "stream.h"
+#include "extmem.h"
+
+/* Edges in one block of the edge section */
+#define EXT_EDGES_PER_BLOCK (EXT_BLOCK_SIZE / (int)sizeof(GraphFileEdge))
+
+extern int gNoOfVertex;
+extern long long getWallTimeMsec();
+extern FILE* getNamedRowSinkSummaryFile(NamedRowSink *pstNamedSink);
+
+/* pread() until size bytes are in or the file ends. Returns OK only if all of it was read */
+int preadFully(int fd, void *pBuf, long long size, long long offset)
+{
+	long long done = 0;
+	ssize_t readSize;
+
+	while (done < size)
+	{
+		readSize = pread(fd, (char *)pBuf + done, (size_t)(size - done), (off_t)(offset + done));
+		if (readSize <= 0)
+		{
+			return ERR;
+		}
+		done += readSize;
+	}
+
+	return OK;
+}
+
+/* Closes the graph and frees the block cache */
+void closeExtGraph(ExtGraph *pstGraph)
+{
+	int i;
+
+	if (NULL_PTR == pstGraph)
+	{
+		return;
+	}
+
+	if (pstGraph->fd >= 0)
+	{
+		close(pstGraph->fd);
+	}
+
+	for (i = 0; i < EXT_CACHE_BLOCKS; i++)
+	{
+		free(pstGraph->astBlocks[i].pstEdges);
+	}
+
+	free(pstGraph->piOffsets);
+	free(pstGraph);
+}
+
+/* Opens a binary graph file for block reads. Only the header and the offsets are read */
+ExtGraph* openExtGraph(char *fileName)
+{
+	ExtGraph *pstGraph = NULL_PTR;
+	GraphFileHeader stHeader;
+	GraphFileSection *pstOffsets = NULL_PTR, *pstEdges = NULL_PTR;
+	int i;
+
+	if (NULL_PTR == fileName)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	pstGraph = (ExtGraph *)calloc(1, sizeof(ExtGraph));
+	if (NULL_PTR == pstGraph)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	for (i = 0; i < EXT_CACHE_BLOCKS; i++)
+	{
+		pstGraph->astBlocks[i].blockNum = -1;
+	}
+
+	pstGraph->fd = open(fileName, O_RDONLY);
+	if ((pstGraph->fd < 0)
+		|| (OK != preadFully(pstGraph->fd, &stHeader, sizeof(stHeader), 0))
+		|| (0 != memcmp(stHeader.magic, GRAPH_FILE_MAGIC, GRAPH_FILE_MAGIC_LEN))
+		|| (GRAPH_FILE_VERSION != stHeader.version)
+		|| (stHeader.noOfVertex <= 0)
+		|| (stHeader.noOfEdges < 0)
+		|| (stHeader.noOfSections < 0)
+		|| (stHeader.noOfSections > MAX_GRAPH_SECTIONS))
+	{
+		myLog(ERROR, "[%s] is not a binary graph file!", fileName);
+		closeExtGraph(pstGraph);
+		return NULL_PTR;
+	}
+
+	for (i = 0; i < stHeader.noOfSections; i++)
+	{
+		if (GRAPH_SECTION_OFFSETS == stHeader.sections[i].tag)
+		{
+			pstOffsets = &stHeader.sections[i];
+		}
+		else if (GRAPH_SECTION_EDGES == stHeader.sections[i].tag)
+		{
+			pstEdges = &stHeader.sections[i];
+		}
+	}
+
+	if ((NULL_PTR == pstOffsets) || (NULL_PTR == pstEdges)
+		|| (pstOffsets->size != (long long)sizeof(int) * (stHeader.noOfVertex + 1))
+		|| (pstEdges->size != (long long)sizeof(GraphFileEdge) * stHeader.noOfEdges))
+	{
+		myLog(ERROR, "[%s] has invalid sections!", fileName);
+		closeExtGraph(pstGraph);
+		return NULL_PTR;
+	}
+
+	pstGraph->noOfVertex = stHeader.noOfVertex;
+	pstGraph->noOfEdges = stHeader.noOfEdges;
+	pstGraph->edgeSectionOffset = pstEdges->offset;
+
+	pstGraph->piOffsets = (int *)malloc((size_t)pstOffsets->size);
+	if ((NULL_PTR == pstGraph->piOffsets)
+		|| (OK != preadFully(pstGraph->fd, pstGraph->piOffsets, pstOffsets->size, pstOffsets->offset)))
+	{
+		myLog(ERROR, "Could not read the offsets of [%s]!", fileName);
+		closeExtGraph(pstGraph);
+		return NULL_PTR;
+	}
+
+	if ((0 != pstGraph->piOffsets[0]) || (pstGraph->noOfEdges != pstGraph->piOffsets[pstGraph->noOfVertex]))
+	{
+		myLog(ERROR, "[%s] has invalid offsets!", fileName);
+		closeExtGraph(pstGraph);
+		return NULL_PTR;
+	}
+
+	/* The edge blocks are indexed straight from the offsets */
+	for (i = 0; i < pstGraph->noOfVertex; i++)
+	{
+		if ((pstGraph->piOffsets[i] < 0)
+			|| (pstGraph->piOffsets[i] > pstGraph->piOffsets[i + 1])
+			|| (pstGraph->piOffsets[i + 1] > pstGraph->noOfEdges))
+		{
+			myLog(ERROR, "[%s] has invalid offsets for vertex [%d]!", fileName, i);
+			closeExtGraph(pstGraph);
+			return NULL_PTR;
+		}
+	}
+
+	return pstGraph;
+}
+
+/* Returns the cached block blockNum of the edge section, reading it if needed. The least
+recently used block is replaced */
+EdgeBlock* getEdgeBlock(ExtGraph *pstGraph, long long blockNum)
+{
+	EdgeBlock *pstBlock = NULL_PTR;
+	long long firstEdge;
+	int i;
+
+	for (i = 0; i < EXT_CACHE_BLOCKS; i++)
+	{
+		if (blockNum == pstGraph->astBlocks[i].blockNum)
+		{
+			pstBlock = &pstGraph->astBlocks[i];
+			pstBlock->lastUse = ++pstGraph->useClock;
+			return pstBlock;
+		}
+
+		if ((NULL_PTR == pstBlock) || (pstGraph->astBlocks[i].lastUse < pstBlock->lastUse))
+		{
+			pstBlock = &pstGraph->astBlocks[i];
+		}
+	}
+
+	if (NULL_PTR == pstBlock->pstEdges)
+	{
+		pstBlock->pstEdges = (GraphFileEdge *)malloc(EXT_BLOCK_SIZE);
+		if (NULL_PTR == pstBlock->pstEdges)
+		{
+			myLog(ERROR, "malloc failed!");
+			return NULL_PTR;
+		}
+	}
+
+	firstEdge = blockNum * EXT_EDGES_PER_BLOCK;
+	pstBlock->noOfEdges = (int)MIN((long long)EXT_EDGES_PER_BLOCK, pstGraph->noOfEdges - firstEdge);
+	pstBlock->blockNum = -1;
+
+	if (OK != preadFully(pstGraph->fd, pstBlock->pstEdges,
+		(long long)sizeof(GraphFileEdge) * pstBlock->noOfEdges,
+		pstGraph->edgeSectionOffset + ((long long)sizeof(GraphFileEdge) * firstEdge)))
+	{
+		myLog(ERROR, "Could not read edge block [%lld]!", blockNum);
+		return NULL_PTR;
+	}
+
+	pstBlock->blockNum = blockNum;
+	pstBlock->lastUse = ++pstGraph->useClock;
+	pstGraph->bytesRead += (long long)sizeof(GraphFileEdge) * pstBlock->noOfEdges;
+	pstGraph->blocksRead++;
+
+	return pstBlock;
+}
+
+/* Orders queue entries by key for qsort() */
+int compareExtPQEntry(const void *pLeft, const void *pRight)
+{
+	return ((ExtPQEntry *)pLeft)->key - ((ExtPQEntry *)pRight)->key;
+}
+
+/* Drops all spilled runs */
+void clearSpillRuns(ExtPQueue *pstQueue)
+{
+	int i;
+
+	for (i = 0; i < pstQueue->noOfRuns; i++)
+	{
+		fclose(pstQueue->astRuns[i].pFile);
+		free(pstQueue->astRuns[i].pstBuf);
+	}
+
+	pstQueue->noOfRuns = 0;
+}
+
+/* Empties the queue. The counters are kept */
+void extPqClear(ExtPQueue *pstQueue)
+{
+	clearSpillRuns(pstQueue);
+	pstQueue->size = 0;
+}
+
+/* Frees the queue */
+void destroyExtPQueue(ExtPQueue *pstQueue)
+{
+	if (NULL_PTR == pstQueue)
+	{
+		return;
+	}
+
+	extPqClear(pstQueue);
+	free(pstQueue->pstHeap);
+	free(pstQueue);
+}
+
+/* Returns a queue which keeps at most capacity entries in memory */
+ExtPQueue* createExtPQueue(int capacity)
+{
+	ExtPQueue *pstQueue = NULL_PTR;
+
+	if (capacity < EXT_PQ_MIN_ENTRIES)
+	{
+		myLog(ERROR, "Invalid Input! Capacity: [%d]", capacity);
+		return NULL_PTR;
+	}
+
+	pstQueue = (ExtPQueue *)calloc(1, sizeof(ExtPQueue));
+	if (NULL_PTR == pstQueue)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstQueue->capacity = capacity;
+	pstQueue->pstHeap = (ExtPQEntry *)malloc(sizeof(ExtPQEntry) * capacity);
+	if (NULL_PTR == pstQueue->pstHeap)
+	{
+		myLog(ERROR, "malloc failed!");
+		destroyExtPQueue(pstQueue);
+		return NULL_PTR;
+	}
+
+	return pstQueue;
+}
+
+/* Refills the head of a run from its file. Returns the entry at the head, NULL if the
+run is used up */
+ExtPQEntry* getSpillRunHead(ExtPQueue *pstQueue, SpillRun *pstRun)
+{
+	int count;
+
+	if (pstRun->bufPos < pstRun->bufSize)
+	{
+		return &pstRun->pstBuf[pstRun->bufPos];
+	}
+
+	if (0 == pstRun->noOfLeft)
+	{
+		return NULL_PTR;
+	}
+
+	count = (int)MIN((long long)EXT_RUN_BUF_ENTRIES, pstRun->noOfLeft);
+	if (count != (int)fread(pstRun->pstBuf, sizeof(ExtPQEntry), count, pstRun->pFile))
+	{
+		myLog(ERROR, "Could not read a spilled run!");
+		pstRun->noOfLeft = 0;
+		return NULL_PTR;
+	}
+
+	pstRun->noOfLeft -= count;
+	pstRun->bufSize = count;
+	pstRun->bufPos = 0;
+	pstQueue->bytesRead += (long long)sizeof(ExtPQEntry) * count;
+
+	return &pstRun->pstBuf[0];
+}
+
+/* Returns the run with the smallest head, NULL if all runs are used up. Used up runs
+are closed on the way */
+SpillRun* getMinSpillRun(ExtPQueue *pstQueue)
+{
+	SpillRun *pstMinRun = NULL_PTR;
+	ExtPQEntry *pstHead = NULL_PTR, *pstMinHead = NULL_PTR;
+	int i = 0;
+
+	while (i < pstQueue->noOfRuns)
+	{
+		pstHead = getSpillRunHead(pstQueue, &pstQueue->astRuns[i]);
+		if (NULL_PTR == pstHead)
+		{
+			fclose(pstQueue->astRuns[i].pFile);
+			free(pstQueue->astRuns[i].pstBuf);
+			pstQueue->astRuns[i] = pstQueue->astRuns[--pstQueue->noOfRuns];
+			continue;
+		}
+
+		if ((NULL_PTR == pstMinHead) || (pstHead->key < pstMinHead->key))
+		{
+			pstMinHead = pstHead;
+			pstMinRun = &pstQueue->astRuns[i];
+		}
+		i++;
+	}
+
+	return pstMinRun;
+}
+
+/* Adds a run for the file pFile holding noOfEntries sorted entries */
+int addSpillRun(ExtPQueue *pstQueue, FILE *pFile, long long noOfEntries)
+{
+	SpillRun *pstRun = &pstQueue->astRuns[pstQueue->noOfRuns];
+
+	rewind(pFile);
+
+	pstRun->pFile = pFile;
+	pstRun->noOfLeft = noOfEntries;
+	pstRun->bufSize = 0;
+	pstRun->bufPos = 0;
+	pstRun->pstBuf = (ExtPQEntry *)malloc(sizeof(ExtPQEntry) * EXT_RUN_BUF_ENTRIES);
+	if (NULL_PTR == pstRun->pstBuf)
+	{
+		myLog(ERROR, "malloc failed!");
+		fclose(pFile);
+		return ERR;
+	}
+
+	pstQueue->noOfRuns++;
+
+	return OK;
+}
+
+/* Merges all runs into one, so that a new run fits */
+int mergeSpillRuns(ExtPQueue *pstQueue)
+{
+	SpillRun *pstRun = NULL_PTR;
+	FILE *pFile = NULL_PTR;
+	long long noOfEntries = 0;
+
+	pFile = tmpfile();
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "tmpfile failed!");
+		return ERR;
+	}
+
+	while (NULL_PTR != (pstRun = getMinSpillRun(pstQueue)))
+	{
+		if (1 != fwrite(&pstRun->pstBuf[pstRun->bufPos], sizeof(ExtPQEntry), 1, pFile))
+		{
+			myLog(ERROR, "Could not write a merged run!");
+			fclose(pFile);
+			return ERR;
+		}
+		pstRun->bufPos++;
+		noOfEntries++;
+	}
+
+	pstQueue->bytesWritten += (long long)sizeof(ExtPQEntry) * noOfEntries;
+
+	return addSpillRun(pstQueue, pFile, noOfEntries);
+}
+
+/* Writes the larger half of the full heap out as a sorted run */
+int spillExtPQueue(ExtPQueue *pstQueue)
+{
+	FILE *pFile = NULL_PTR;
+	int keep, noOfSpilled;
+
+	if ((MAX_SPILL_RUNS == pstQueue->noOfRuns) && (OK != mergeSpillRuns(pstQueue)))
+	{
+		myLog(ERROR, "mergeSpillRuns failed!");
+		return ERR;
+	}
+
+	/* A sorted array is a valid heap, so the kept half needs no rebuilding */
+	qsort(pstQueue->pstHeap, pstQueue->size, sizeof(ExtPQEntry), compareExtPQEntry);
+
+	keep = pstQueue->size / 2;
+	noOfSpilled = pstQueue->size - keep;
+
+	pFile = tmpfile();
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "tmpfile failed!");
+		return ERR;
+	}
+
+	if (noOfSpilled != (int)fwrite(&pstQueue->pstHeap[keep], sizeof(ExtPQEntry), noOfSpilled, pFile))
+	{
+		myLog(ERROR, "Could not write a spilled run!");
+		fclose(pFile);
+		return ERR;
+	}
+
+	pstQueue->size = keep;
+	pstQueue->bytesWritten += (long long)sizeof(ExtPQEntry) * noOfSpilled;
+	pstQueue->noOfSpills++;
+
+	return addSpillRun(pstQueue, pFile, noOfSpilled);
+}
+
+/* Returns TRUE if there is nothing in the queue */
+int extPqIsEmpty(ExtPQueue *pstQueue)
+{
+	return ((0 == pstQueue->size) && (NULL_PTR == getMinSpillRun(pstQueue)));
+}
+
+/* Adds an entry, spilling if the heap is full */
+int extPqPush(ExtPQueue *pstQueue, int vertex, int key)
+{
+	ExtPQEntry stEntry;
+	int i, parent;
+
+	if ((pstQueue->size == pstQueue->capacity) && (OK != spillExtPQueue(pstQueue)))
+	{
+		myLog(ERROR, "spillExtPQueue failed!");
+		return ERR;
+	}
+
+	stEntry.key = key;
+	stEntry.vertex = vertex;
+
+	/* Sift up */
+	i = pstQueue->size++;
+	while (i > 0)
+	{
+		parent = (i - 1) / 2;
+		if (pstQueue->pstHeap[parent].key <= key)
+		{
+			break;
+		}
+		pstQueue->pstHeap[i] = pstQueue->pstHeap[parent];
+		i = parent;
+	}
+	pstQueue->pstHeap[i] = stEntry;
+
+	return OK;
+}
+
+/* Removes the smallest entry of the heap and the runs */
+int extPqPop(ExtPQueue *pstQueue, int *vertex, int *key)
+{
+	SpillRun *pstRun = NULL_PTR;
+	ExtPQEntry stLast;
+	int i, child;
+
+	pstRun = getMinSpillRun(pstQueue);
+
+	if ((NULL_PTR != pstRun)
+		&& ((0 == pstQueue->size) || (pstRun->pstBuf[pstRun->bufPos].key < pstQueue->pstHeap[0].key)))
+	{
+		*vertex = pstRun->pstBuf[pstRun->bufPos].vertex;
+		*key = pstRun->pstBuf[pstRun->bufPos].key;
+		pstRun->bufPos++;
+		return OK;
+	}
+
+	if (0 == pstQueue->size)
+	{
+		myLog(ERROR, "Queue is empty!");
+		return ERR;
+	}
+
+	*vertex = pstQueue->pstHeap[0].vertex;
+	*key = pstQueue->pstHeap[0].key;
+
+	/* Sift the last entry down from the top */
+	stLast = pstQueue->pstHeap[--pstQueue->size];
+	i = 0;
+	while ((child = (2 * i) + 1) < pstQueue->size)
+	{
+		if ((child + 1 < pstQueue->size)
+			&& (pstQueue->pstHeap[child + 1].key < pstQueue->pstHeap[child].key))
+		{
+			child++;
+		}
+		if (stLast.key <= pstQueue->pstHeap[child].key)
+		{
+			break;
+		}
+		pstQueue->pstHeap[i] = pstQueue->pstHeap[child];
+		i = child;
+	}
+	pstQueue->pstHeap[i] = stLast;
+
+	return OK;
+}
+
+/* Dijkstra from source over the disk resident graph. piDist gets the distances and
+pSettled is scratch, both of noOfVertex entries. Returns the vertices settled, ERR on
+failure */
+int extMemSssp(ExtGraph *pstGraph, ExtPQueue *pstQueue, int source, int *piDist, char *pSettled)
+{
+	EdgeBlock *pstBlock = NULL_PTR;
+	GraphFileEdge *pstEdge = NULL_PTR;
+	int i, vertex, distance, edge, lastEdge, blockEnd, noOfSettled = 0;
+
+	for (i = 0; i < pstGraph->noOfVertex; i++)
+	{
+		piDist[i] = INFINITY;
+		pSettled[i] = FALSE;
+	}
+
+	extPqClear(pstQueue);
+
+	piDist[source] = 0;
+	if (OK != extPqPush(pstQueue, source, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == extPqIsEmpty(pstQueue))
+	{
+		if (OK != extPqPop(pstQueue, &vertex, &distance))
+		{
+			return ERR;
+		}
+
+		/* A stale copy of a vertex which got a smaller key later */
+		if ((TRUE == pSettled[vertex]) || (distance > piDist[vertex]))
+		{
+			continue;
+		}
+
+		pSettled[vertex] = TRUE;
+		noOfSettled++;
+
+		/* Walk the edges block by block */
+		edge = pstGraph->piOffsets[vertex];
+		lastEdge = pstGraph->piOffsets[vertex + 1];
+		while (edge < lastEdge)
+		{
+			pstBlock = getEdgeBlock(pstGraph, edge / EXT_EDGES_PER_BLOCK);
+			if (NULL_PTR == pstBlock)
+			{
+				return ERR;
+			}
+
+			blockEnd = MIN(lastEdge, (int)((pstBlock->blockNum + 1) * EXT_EDGES_PER_BLOCK));
+			for (; edge < blockEnd; edge++)
+			{
+				pstEdge = &pstBlock->pstEdges[edge % EXT_EDGES_PER_BLOCK];
+				if ((pstEdge->vertexNum < 0) || (pstEdge->vertexNum >= pstGraph->noOfVertex))
+				{
+					myLog(ERROR, "Edge [%d] points outside the graph!", edge);
+					return ERR;
+				}
+
+				if ((FALSE == pSettled[pstEdge->vertexNum])
+					&& (distance + pstEdge->distance < piDist[pstEdge->vertexNum]))
+				{
+					piDist[pstEdge->vertexNum] = distance + pstEdge->distance;
+					if (OK != extPqPush(pstQueue, pstEdge->vertexNum, piDist[pstEdge->vertexNum]))
+					{
+						return ERR;
+					}
+				}
+			}
+		}
+	}
+
+	return noOfSettled;
+}
+
+/* Entry function for the external memory mode. Runs one query per source in the comma
+separated sourcesArg on the binary graph in fileName, hands every row to the sink and
+reports the I/O of each query */
+int extMemProc(char *fileName, char *sourcesArg, char *sinkName, char *pqEntriesArg)
+{
+	ExtGraph *pstGraph = NULL_PTR;
+	ExtPQueue *pstQueue = NULL_PTR;
+	NamedRowSink stNamedSink;
+	FILE *pSummary = NULL_PTR;
+	char *pSource = sourcesArg;
+	int *piDist = NULL_PTR;
+	char *pSettled = NULL_PTR;
+	long long startTime;
+	int source, noOfSettled, retVal = OK;
+
+	if ((NULL_PTR == sourcesArg) || ('\0' == *sourcesArg))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstGraph = openExtGraph(fileName);
+	if (NULL_PTR == pstGraph)
+	{
+		myLog(ERROR, "openExtGraph failed!");
+		return ERR;
+	}
+
+	gNoOfVertex = pstGraph->noOfVertex;
+
+	/* Reject a bad list before any query runs */
+	while ('\0' != *pSource)
+	{
+		if (OK != nextListVertex(&pSource, pstGraph->noOfVertex, &source))
+		{
+			myLog(ERROR, "Invalid source list [%s]!", sourcesArg);
+			closeExtGraph(pstGraph);
+			return ERR;
+		}
+	}
+	pSource = sourcesArg;
+
+	pstQueue = createExtPQueue((NULL_PTR != pqEntriesArg) ? atoi(pqEntriesArg) : EXT_PQ_DEFAULT_ENTRIES);
+	piDist = (int *)malloc(sizeof(int) * pstGraph->noOfVertex);
+	pSettled = (char *)malloc(sizeof(char) * pstGraph->noOfVertex);
+
+	if ((NULL_PTR == pstQueue) || (NULL_PTR == piDist) || (NULL_PTR == pSettled)
+		|| (OK != openNamedRowSink(&stNamedSink, sinkName)))
+	{
+		myLog(ERROR, "Failed to set up the external memory mode!");
+		destroyExtPQueue(pstQueue);
+		free(piDist);
+		free(pSettled);
+		closeExtGraph(pstGraph);
+		return ERR;
+	}
+
+	pSummary = getNamedRowSinkSummaryFile(&stNamedSink);
+
+	fprintf(pSummary, "\nVertices: [%d] Edges: [%d] Offsets read: [%lld] bytes "
+		"Block: [%d] bytes Cached blocks: [%d] Queue entries in memory: [%d]\n",
+		pstGraph->noOfVertex, pstGraph->noOfEdges,
+		(long long)sizeof(int) * (pstGraph->noOfVertex + 1),
+		EXT_BLOCK_SIZE, EXT_CACHE_BLOCKS, pstQueue->capacity);
+
+	while ((OK == retVal) && ('\0' != *pSource))
+	{
+		(void)nextListVertex(&pSource, pstGraph->noOfVertex, &source); // Checked above
+
+		/* Per query counters */
+		pstGraph->bytesRead = 0;
+		pstGraph->blocksRead = 0;
+		pstQueue->bytesRead = 0;
+		pstQueue->bytesWritten = 0;
+		pstQueue->noOfSpills = 0;
+
+		startTime = getWallTimeMsec();
+
+		noOfSettled = extMemSssp(pstGraph, pstQueue, source, piDist, pSettled);
+		if ((ERR == noOfSettled)
+			|| (OK != stNamedSink.stSink.pfnSink(stNamedSink.stSink.pSinkCtx, source,
+				piDist, pstGraph->noOfVertex)))
+		{
+			myLog(ERROR, "Query from source [%d] failed!", source);
+			retVal = ERR;
+			break;
+		}
+
+		fprintf(pSummary, "Source: [%d] Settled: [%d] Edge bytes read: [%lld] in [%d] blocks "
+			"Queue spills: [%d] Queue bytes written: [%lld] read: [%lld] Time: [%lld] msec\n",
+			source, noOfSettled, pstGraph->bytesRead, pstGraph->blocksRead,
+			pstQueue->noOfSpills, pstQueue->bytesWritten, pstQueue->bytesRead,
+			getWallTimeMsec() - startTime);
+	}
+
+	if (OK != closeNamedRowSink(&stNamedSink))
+	{
+		retVal = ERR;
+	}
+
+	if (OK == retVal)
+	{
+		printNamedRowSinkTotals(&stNamedSink);
+	}
+
+	destroyExtPQueue(pstQueue);
+	free(piDist);
+	free(pSettled);
+	closeExtGraph(pstGraph);
+
+	return retVal;
+}
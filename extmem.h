@@ -0,0 +1,76 @@
+/***************************************************************************************************/
+// EXTMEM.H
+// Contains the block cache and the spilling priority queue of the external memory mode
+/***************************************************************************************************/
+
+#ifndef __EXTMEM__
+#define __EXTMEM__
+
+#include <stdio.h>
+#include "graphio.h"
+
+#define EXT_BLOCK_SIZE (1 << 20) // Bytes per read of the edge section
+#define EXT_CACHE_BLOCKS 16 // Edge blocks kept in memory
+#define EXT_PQ_DEFAULT_ENTRIES (1 << 20) // Queue entries kept in memory
+#define EXT_PQ_MIN_ENTRIES 1024
+#define EXT_RUN_BUF_ENTRIES 8192 // Entries read from a spilled run at a time
+#define MAX_SPILL_RUNS 32 // More runs are merged into one
+
+/* One cached block of the edge section */
+typedef struct EdgeBlock
+{
+	long long blockNum; // -1 if unused
+	unsigned int lastUse; // For LRU replacement
+	int noOfEdges; // Valid edges in the block, the last block may be short
+	GraphFileEdge *pstEdges;
+}EdgeBlock;
+
+/* A binary graph file read with pread(). Only the CSR offsets are resident, the edges are
+pulled in EXT_BLOCK_SIZE blocks on demand */
+typedef struct ExtGraph
+{
+	int fd;
+	int noOfVertex;
+	int noOfEdges;
+	int *piOffsets; // int[V + 1]
+	long long edgeSectionOffset;
+	EdgeBlock astBlocks[EXT_CACHE_BLOCKS];
+	unsigned int useClock;
+	long long bytesRead; // Edge bytes read since the counter was last cleared
+	int blocksRead;
+}ExtGraph;
+
+/* A queue entry. The queue does no decrease key, a vertex is pushed again instead and the
+stale entries are skipped when they come out */
+typedef struct ExtPQEntry
+{
+	int key;
+	int vertex;
+}ExtPQEntry;
+
+/* A sorted run of entries spilled to a temporary file */
+typedef struct SpillRun
+{
+	FILE *pFile;
+	long long noOfLeft; // Entries still in the file
+	ExtPQEntry *pstBuf; // Head of the run
+	int bufSize;
+	int bufPos;
+}SpillRun;
+
+/* A priority queue with a bounded in-memory binary heap. When the heap is full its larger
+half is sorted and written out as a run. The minimum is the smallest of the heap top and
+the heads of the runs */
+typedef struct ExtPQueue
+{
+	ExtPQEntry *pstHeap;
+	int capacity;
+	int size;
+	SpillRun astRuns[MAX_SPILL_RUNS];
+	int noOfRuns;
+	long long bytesRead; // Spill traffic since the counters were last cleared
+	long long bytesWritten;
+	int noOfSpills;
+}ExtPQueue;
+
+#endif
@@ -20,8 +20,9 @@ int gTestEV;
 extern int gFCombine;
 
 /* Pointer Flags. Assuming maximum 500 nodes, the maxdegree of the fibonacci tree can
-go only to maximum of log_2 (500) <= 9 */
-int *fiboPtrFlags[MAX_FIBO_DEGREE] = {NULL_PTR};
+go only to maximum of log_2 (500) <= 9. Kept per thread as the streaming modes run one
+heap per worker */
+__thread int *fiboPtrFlags[MAX_FIBO_DEGREE] = {NULL_PTR};
 
 /* Entry function for user input */
 int fiboProc()
@@ -6,6 +6,9 @@
 // Year: 2011
 /***************************************************************************************************/
 
+#ifndef __FIBO__
+#define __FIBO__
+
 #include "header.h"
 #include <malloc.h>
 
@@ -29,3 +32,5 @@ typedef struct FiboHeap
 	struct FiboHeap *prev; //Useful for doubly circular linked list. Points to itself if alone
 	struct FiboHeap *next; //Useful for doubly circular linked list. Points to itself if alone
 }FiboHeap;
+
+#endif
@@ -0,0 +1,494 @@
+/***************************************************************************************************/
+// GRAPHIO.C
+// Contains all functions for reading and writing the binary graph format
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "graphio.h"
+
+//Stores the number to vertices
+extern int gNoOfVertex;
+//function which allocates memory for adjlist based on number of vertices and density
+extern AdjList* initAdjList();
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+
+/* Returns the offset rounded up to the section alignment */
+long long alignGraphFileOffset(long long offset)
+{
+	return ((offset + GRAPH_FILE_ALIGN - 1) / GRAPH_FILE_ALIGN) * GRAPH_FILE_ALIGN;
+}
+
+/* Writes the given sections into fileName. The file is written under a temporary name
+and renamed at the end, so readers never observe a half written graph */
+int writeGraphFileSections(char *fileName, int noOfVertex, int noOfEdges,
+	GraphSectionData *pstSections, int noOfSections)
+{
+	GraphFileHeader stHeader;
+	char tmpFileName[MAX_FILE_NAME_LEN];
+	char pad[GRAPH_FILE_ALIGN] = {0};
+	FILE *pFile = NULL_PTR;
+	long long offset;
+	int i;
+
+	if ((NULL_PTR == fileName)
+		|| ((noOfSections > 0) && (NULL_PTR == pstSections))
+		|| (noOfSections > MAX_GRAPH_SECTIONS))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	/* Lay out the sections one after the other */
+	(void)memset(&stHeader, 0, sizeof(stHeader));
+	(void)memcpy(stHeader.magic, GRAPH_FILE_MAGIC, GRAPH_FILE_MAGIC_LEN);
+	stHeader.version = GRAPH_FILE_VERSION;
+	stHeader.noOfVertex = noOfVertex;
+	stHeader.noOfEdges = noOfEdges;
+	stHeader.noOfSections = noOfSections;
+
+	offset = alignGraphFileOffset(sizeof(stHeader));
+	for (i = 0; i < noOfSections; i++)
+	{
+		stHeader.sections[i].tag = pstSections[i].tag;
+		stHeader.sections[i].offset = offset;
+		stHeader.sections[i].size = pstSections[i].size;
+
+		offset = alignGraphFileOffset(offset + pstSections[i].size);
+	}
+
+	(void)snprintf(tmpFileName, sizeof(tmpFileName), "%s.tmp.%d", fileName, (int)getpid());
+
+	pFile = fopen(tmpFileName, "wb");
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "Could not create file [%s]!", tmpFileName);
+		return ERR;
+	}
+
+	if (1 != fwrite(&stHeader, sizeof(stHeader), 1, pFile))
+	{
+		myLog(ERROR, "Could not write header to [%s]!", tmpFileName);
+		fclose(pFile);
+		(void)remove(tmpFileName);
+		return ERR;
+	}
+
+	offset = sizeof(stHeader);
+	for (i = 0; i < noOfSections; i++)
+	{
+		/* Pad up to the start of this section */
+		if (stHeader.sections[i].offset > offset)
+		{
+			(void)fwrite(pad, (size_t)(stHeader.sections[i].offset - offset), 1, pFile);
+		}
+
+		if ((pstSections[i].size > 0)
+			&& (1 != fwrite(pstSections[i].pData, (size_t)pstSections[i].size, 1, pFile)))
+		{
+			myLog(ERROR, "Could not write section [%d] to [%s]!",
+				pstSections[i].tag, tmpFileName);
+			fclose(pFile);
+			(void)remove(tmpFileName);
+			return ERR;
+		}
+
+		offset = stHeader.sections[i].offset + pstSections[i].size;
+	}
+
+	if (0 != fclose(pFile))
+	{
+		myLog(ERROR, "Could not flush [%s]!", tmpFileName);
+		(void)remove(tmpFileName);
+		return ERR;
+	}
+
+	if (0 != rename(tmpFileName, fileName))
+	{
+		myLog(ERROR, "Could not rename [%s] to [%s]!", tmpFileName, fileName);
+		(void)remove(tmpFileName);
+		return ERR;
+	}
+
+	myLog(INFO, "Saved graph with [%d] vertices and [%d] edges to [%s]",
+		noOfVertex, noOfEdges, fileName);
+
+	return OK;
+}
+
+/* Stores the adjacency list in CSR form into a binary graph file */
+int saveAdjListToGraphFile(char *fileName, AdjList *pstAdjList)
+{
+	GraphSectionData astSections[2];
+	GraphFileEdge *pstEdges = NULL_PTR;
+	AdjList *pstTraverser = NULL_PTR;
+	int *piOffsets = NULL_PTR;
+	int i, noOfEdges = 0, retVal;
+
+	if ((NULL_PTR == fileName) || (NULL_PTR == pstAdjList))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	/* Count the edges so that both sections can be allocated at once */
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		for (pstTraverser = pstAdjList[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			noOfEdges++;
+		}
+	}
+
+	piOffsets = (int *)malloc(sizeof(int) * (gNoOfVertex + 1));
+	pstEdges = (GraphFileEdge *)malloc(sizeof(GraphFileEdge) * MAX(noOfEdges, 1));
+	if ((NULL_PTR == piOffsets) || (NULL_PTR == pstEdges))
+	{
+		myLog(ERROR, "malloc failed!");
+		free(piOffsets);
+		free(pstEdges);
+		return ERR;
+	}
+
+	/* Flatten the lists in the order they are stored */
+	noOfEdges = 0;
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		piOffsets[i] = noOfEdges;
+
+		for (pstTraverser = pstAdjList[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			pstEdges[noOfEdges].vertexNum = pstTraverser->vertexNum;
+			pstEdges[noOfEdges].distance = pstTraverser->distance;
+			noOfEdges++;
+		}
+	}
+	piOffsets[gNoOfVertex] = noOfEdges;
+
+	astSections[0].tag = GRAPH_SECTION_OFFSETS;
+	astSections[0].pData = piOffsets;
+	astSections[0].size = (long long)sizeof(int) * (gNoOfVertex + 1);
+	astSections[1].tag = GRAPH_SECTION_EDGES;
+	astSections[1].pData = pstEdges;
+	astSections[1].size = (long long)sizeof(GraphFileEdge) * noOfEdges;
+
+	retVal = writeGraphFileSections(fileName, gNoOfVertex, noOfEdges, astSections, 2);
+
+	free(piOffsets);
+	free(pstEdges);
+
+	return retVal;
+}
+
+/* Returns a pointer to the section with the given tag inside the mapping or NULL if
+the file does not have one. size is an optional output */
+void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size)
+{
+	GraphFileHeader *pstHeader = NULL_PTR;
+	int i;
+
+	if (NULL_PTR == pstGraphFile)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	pstHeader = pstGraphFile->pstHeader;
+
+	for (i = 0; i < pstHeader->noOfSections; i++)
+	{
+		if (tag == pstHeader->sections[i].tag)
+		{
+			if (NULL_PTR != size)
+			{
+				*size = pstHeader->sections[i].size;
+			}
+
+			return (pstGraphFile->pMap + pstHeader->sections[i].offset);
+		}
+	}
+
+	return NULL_PTR;
+}
+
+/* Unmaps the file and frees the handle */
+void closeGraphFile(GraphFile *pstGraphFile)
+{
+	if (NULL_PTR == pstGraphFile)
+	{
+		return;
+	}
+
+	if (MAP_FAILED != (void *)pstGraphFile->pMap)
+	{
+		(void)munmap(pstGraphFile->pMap, (size_t)pstGraphFile->mapSize);
+	}
+
+	if (pstGraphFile->fd >= 0)
+	{
+		close(pstGraphFile->fd);
+	}
+
+	free(pstGraphFile);
+}
+
+/* Maps a binary graph file read-only and validates its layout. Returns NULL if the file
+is missing or is not a valid graph file */
+GraphFile* openGraphFile(char *fileName)
+{
+	GraphFile *pstGraphFile = NULL_PTR;
+	GraphFileHeader *pstHeader = NULL_PTR;
+	struct stat stFileStat;
+	long long size;
+	int i;
+
+	if (NULL_PTR == fileName)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	pstGraphFile = (GraphFile *)malloc(sizeof(GraphFile));
+	if (NULL_PTR == pstGraphFile)
+	{
+		myLog(ERROR, "malloc failed!");
+		return NULL_PTR;
+	}
+
+	pstGraphFile->pMap = (char *)MAP_FAILED;
+	pstGraphFile->mapSize = 0;
+	pstGraphFile->pstHeader = NULL_PTR;
+
+	pstGraphFile->fd = open(fileName, O_RDONLY);
+	if (pstGraphFile->fd < 0)
+	{
+		myLog(INFO, "Graph file [%s] could not be opened", fileName);
+		closeGraphFile(pstGraphFile);
+		return NULL_PTR;
+	}
+
+	if ((0 != fstat(pstGraphFile->fd, &stFileStat))
+		|| (stFileStat.st_size < (off_t)sizeof(GraphFileHeader)))
+	{
+		myLog(ERROR, "Graph file [%s] is too small!", fileName);
+		closeGraphFile(pstGraphFile);
+		return NULL_PTR;
+	}
+
+	pstGraphFile->mapSize = stFileStat.st_size;
+	pstGraphFile->pMap = (char *)mmap(NULL, (size_t)pstGraphFile->mapSize,
+		PROT_READ, MAP_SHARED, pstGraphFile->fd, 0);
+	if (MAP_FAILED == (void *)pstGraphFile->pMap)
+	{
+		myLog(ERROR, "mmap of [%s] failed!", fileName);
+		closeGraphFile(pstGraphFile);
+		return NULL_PTR;
+	}
+
+	/* Validate the header and the section table */
+	pstHeader = (GraphFileHeader *)pstGraphFile->pMap;
+	pstGraphFile->pstHeader = pstHeader;
+
+	if ((0 != memcmp(pstHeader->magic, GRAPH_FILE_MAGIC, GRAPH_FILE_MAGIC_LEN))
+		|| (GRAPH_FILE_VERSION != pstHeader->version)
+		|| (pstHeader->noOfVertex < 0)
+		|| (pstHeader->noOfEdges < 0)
+		|| (pstHeader->noOfSections < 0)
+		|| (pstHeader->noOfSections > MAX_GRAPH_SECTIONS))
+	{
+		myLog(ERROR, "[%s] is not a valid graph file!", fileName);
+		closeGraphFile(pstGraphFile);
+		return NULL_PTR;
+	}
+
+	for (i = 0; i < pstHeader->noOfSections; i++)
+	{
+		if ((pstHeader->sections[i].offset < (long long)sizeof(GraphFileHeader))
+			|| (pstHeader->sections[i].size < 0)
+			|| ((pstHeader->sections[i].offset + pstHeader->sections[i].size)
+				> pstGraphFile->mapSize))
+		{
+			myLog(ERROR, "Section [%d] of [%s] is out of bounds!",
+				pstHeader->sections[i].tag, fileName);
+			closeGraphFile(pstGraphFile);
+			return NULL_PTR;
+		}
+	}
+
+	/* Every graph file must carry the adjacency */
+	if ((NULL_PTR == getGraphFileSection(pstGraphFile, GRAPH_SECTION_OFFSETS, &size))
+		|| (size != (long long)sizeof(int) * (pstHeader->noOfVertex + 1))
+		|| (NULL_PTR == getGraphFileSection(pstGraphFile, GRAPH_SECTION_EDGES, &size))
+		|| (size != (long long)sizeof(GraphFileEdge) * pstHeader->noOfEdges))
+	{
+		myLog(ERROR, "Adjacency sections of [%s] are missing or corrupt!", fileName);
+		closeGraphFile(pstGraphFile);
+		return NULL_PTR;
+	}
+
+	return pstGraphFile;
+}
+
+/* Adds the section tag to the binary graph file fileName or replaces the one it has. The
+other sections are kept as they are */
+int setGraphFileSection(char *fileName, int tag, void *pData, long long size)
+{
+	GraphFile *pstGraphFile = NULL_PTR;
+	GraphFileHeader *pstHeader = NULL_PTR;
+	GraphSectionData astSections[MAX_GRAPH_SECTIONS];
+	int i, noOfSections = 0, retVal;
+
+	if ((NULL_PTR == fileName) || (GRAPH_SECTION_OFFSETS == tag) || (GRAPH_SECTION_EDGES == tag)
+		|| (size < 0) || ((size > 0) && (NULL_PTR == pData)))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR == pstGraphFile)
+	{
+		myLog(ERROR, "[%s] is not a binary graph file!", fileName);
+		return ERR;
+	}
+
+	pstHeader = pstGraphFile->pstHeader;
+
+	/* The old sections are written straight from the mapping */
+	for (i = 0; i < pstHeader->noOfSections; i++)
+	{
+		if (tag == pstHeader->sections[i].tag)
+		{
+			continue;
+		}
+
+		astSections[noOfSections].tag = pstHeader->sections[i].tag;
+		astSections[noOfSections].pData = pstGraphFile->pMap + pstHeader->sections[i].offset;
+		astSections[noOfSections].size = pstHeader->sections[i].size;
+		noOfSections++;
+	}
+
+	if (MAX_GRAPH_SECTIONS == noOfSections)
+	{
+		myLog(ERROR, "[%s] has no room for another section!", fileName);
+		closeGraphFile(pstGraphFile);
+		return ERR;
+	}
+
+	astSections[noOfSections].tag = tag;
+	astSections[noOfSections].pData = pData;
+	astSections[noOfSections].size = size;
+	noOfSections++;
+
+	retVal = writeGraphFileSections(fileName, pstHeader->noOfVertex, pstHeader->noOfEdges,
+		astSections, noOfSections);
+
+	closeGraphFile(pstGraphFile);
+
+	return retVal;
+}
+
+/* Builds an adjacency list from an opened graph file. gNoOfVertex is set to the number
+of vertices in the file */
+AdjList* graphFileToAdjList(GraphFile *pstGraphFile)
+{
+	AdjList *pstAdjList = NULL_PTR, *pstListNode = NULL_PTR, *pstTail = NULL_PTR;
+	GraphFileEdge *pstEdges = NULL_PTR;
+	int *piOffsets = NULL_PTR;
+	int i, j;
+
+	if (NULL_PTR == pstGraphFile)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	piOffsets = (int *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_OFFSETS, NULL_PTR);
+	pstEdges = (GraphFileEdge *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_EDGES, NULL_PTR);
+
+	gNoOfVertex = pstGraphFile->pstHeader->noOfVertex;
+
+	pstAdjList = initAdjList();
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "initAdjList failed!");
+		return NULL_PTR;
+	}
+
+	/* Append directly at the tail, addToAdjList() would walk every list again */
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		if ((piOffsets[i] < 0)
+			|| (piOffsets[i] > piOffsets[i + 1])
+			|| (piOffsets[i + 1] > pstGraphFile->pstHeader->noOfEdges))
+		{
+			myLog(ERROR, "Corrupt offsets for vertex [%d]!", i);
+			destroyAdjList(pstAdjList);
+			return NULL_PTR;
+		}
+
+		pstTail = &(pstAdjList[i]);
+
+		for (j = piOffsets[i]; j < piOffsets[i + 1]; j++)
+		{
+			if ((pstEdges[j].vertexNum < 0) || (pstEdges[j].vertexNum >= gNoOfVertex))
+			{
+				myLog(ERROR, "Corrupt edge [%d] for vertex [%d]!", j, i);
+				destroyAdjList(pstAdjList);
+				return NULL_PTR;
+			}
+
+			pstListNode = (AdjList *)malloc(sizeof(AdjList));
+			if (NULL_PTR == pstListNode)
+			{
+				myLog(ERROR, "malloc failed!");
+				destroyAdjList(pstAdjList);
+				return NULL_PTR;
+			}
+
+			pstListNode->vertexNum = pstEdges[j].vertexNum;
+			pstListNode->distance = pstEdges[j].distance;
+			pstListNode->next = NULL_PTR;
+
+			pstTail->next = pstListNode;
+			pstTail = pstListNode;
+		}
+	}
+
+	return pstAdjList;
+}
+
+/* Entry function for graph conversion mode. Stores the graph in fileName (text or binary)
+as a binary graph file, the input of the modes that read the file without loading it */
+int convertGraphProc(char *fileName, char *graphFileName)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	int retVal;
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	retVal = saveAdjListToGraphFile(graphFileName, pstAdjList);
+	destroyAdjList(pstAdjList);
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "saveAdjListToGraphFile failed!");
+		return ERR;
+	}
+
+	printf("Stored [%d] vertices in [%s]\n", gNoOfVertex, graphFileName);
+
+	return OK;
+}
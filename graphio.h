@@ -0,0 +1,82 @@
+/***************************************************************************************************/
+// GRAPHIO.H
+// Contains the on-disk layout of the binary graph format
+/***************************************************************************************************/
+
+#ifndef __GRAPHIO__
+#define __GRAPHIO__
+
+#include "header.h"
+
+/* A binary graph file is a fixed size header followed by sections. The adjacency is
+stored as CSR (row offsets + edge array) so that it can be mmap'd and walked without parsing.
+Every section starts at an offset aligned to GRAPH_FILE_ALIGN bytes */
+
+#define GRAPH_FILE_MAGIC "DJKG"
+#define GRAPH_FILE_MAGIC_LEN 4
+#define GRAPH_FILE_VERSION 1
+#define GRAPH_FILE_ALIGN 8
+#define MAX_GRAPH_SECTIONS 16
+
+#define MAX_FILE_NAME_LEN 256
+
+typedef enum GRAPH_SECTION_ENUM
+{
+	GRAPH_SECTION_INVALID = 0,
+	GRAPH_SECTION_OFFSETS, // int[V + 1], edges of vertex v are [offsets[v], offsets[v + 1])
+	GRAPH_SECTION_EDGES, // GraphFileEdge[E]
+	GRAPH_SECTION_LANDMARKS, // LandmarkSectionHeader, then the landmarks and their distances
+	GRAPH_SECTION_COORDS, // VertexCoord[V]
+	GRAPH_SECTION_CH, // ChSectionHeader, then the ranks and the upward and downward CSR arcs
+	GRAPH_SECTION_ARC_FLAGS, // ArcFlagSectionHeader, then a flag mask per edge and a cell per vertex
+	GRAPH_SECTION_OVERLAY, // OverlaySectionHeader, then the cell of every vertex on every level
+	GRAPH_SECTION_HUB_LABELS, // HubLabelSectionHeader, then the forward and backward labels
+	TOTAL_GRAPH_SECTIONS
+}GRAPH_SECTION_E;
+
+/* Location of a section inside the file */
+typedef struct GraphFileSection
+{
+	int tag; // GRAPH_SECTION_E
+	int reserved;
+	long long offset; // From the start of the file
+	long long size; // In bytes
+}GraphFileSection;
+
+/* First bytes of every binary graph file */
+typedef struct GraphFileHeader
+{
+	char magic[GRAPH_FILE_MAGIC_LEN];
+	int version;
+	int noOfVertex;
+	int noOfEdges;
+	int noOfSections;
+	int reserved;
+	GraphFileSection sections[MAX_GRAPH_SECTIONS];
+}GraphFileHeader;
+
+/* One entry of the edge section */
+typedef struct GraphFileEdge
+{
+	int vertexNum;
+	int distance;
+}GraphFileEdge;
+
+/* Section contents handed to the writer */
+typedef struct GraphSectionData
+{
+	int tag;
+	void *pData;
+	long long size;
+}GraphSectionData;
+
+/* An opened (mmap'd) graph file */
+typedef struct GraphFile
+{
+	int fd;
+	char *pMap; // Start of the mapping. The header sits here
+	long long mapSize;
+	GraphFileHeader *pstHeader;
+}GraphFile;
+
+#endif
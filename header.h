@@ -18,6 +18,7 @@
 #define PRG_OK 0
 #define PRG_ERR 1
 #define MIN_ARGS 2
+#define MAX_ARGS 3
 
 #define NULL_PTR 0
 
@@ -29,11 +30,22 @@
 
 #define MAX_EDGE_COST 1000
 #define MAX_VERTEX_NUM 500
-#define INFINITY (MAX_EDGE_COST * MAX_VERTEX_NUM)
+//Modes which do not use dist[][] accept graphs up to this size
+#define MAX_LARGE_VERTEX_NUM 1000000
+//Replaces the float INFINITY of <math.h>, which has to be included before this header
+#undef INFINITY
+#define INFINITY (MAX_EDGE_COST * MAX_LARGE_VERTEX_NUM)
 
 #define MAX_SCHEME_RUNS 5
 
+/* Generated graphs are cached under a key made of these and the graph parameters */
+#define GRAPH_CACHE_DEFAULT_DIR "graphcache"
+#define GRAPH_CACHE_SEED 2011
+#define RANDOM_GENERATOR_NAME "random"
+#define RANDOM_WEIGHT_DIST_NAME "uniform"
+
 #define MAX(x, y) ((x) < (y) ? (y) : (x))
+#define MIN(x, y) ((x) < (y) ? (x) : (y))
 
 #define MAX_VALID_VERTICES 4
 #define MAX_VALID_DENSITIES 10
@@ -56,6 +68,39 @@ typedef enum PRG_MODE_ENUM
         INTERACTIVE_SIMPLE_FILE_MODE,
         INTERACTIVE_BINOMIAL_FILE_MODE,
         INTERACTIVE_FIBONACCI_FILE_MODE,
+        RANDOM_CACHED_MODE,
+        PUBLISH_MODE,
+        PUBLISH_READER_MODE,
+        ALLPAIRS_STREAM_MODE,
+        DIST_MATRIX_MODE,
+        DIST_MATRIX_QUERY_MODE,
+        GRAPH_CONVERT_MODE,
+        EXTERNAL_MEMORY_MODE,
+        QUERY_MODE,
+        BIDIRECTIONAL_MODE,
+        LANDMARK_MODE,
+        ALT_MODE,
+        COORD_MODE,
+        ASTAR_MODE,
+        CH_PREP_MODE,
+        CH_MODE,
+        ARC_FLAG_PREP_MODE,
+        ARC_FLAG_MODE,
+        OVERLAY_PREP_MODE,
+        OVERLAY_MODE,
+        HUB_LABEL_PREP_MODE,
+        HUB_LABEL_MODE,
+        TZ_MODE,
+        ROW_CACHE_MODE,
+        BATCH_MODE,
+        MANY_TO_MANY_MODE,
+        LOCAL_QUERY_MODE,
+        YEN_MODE,
+        JOHNSON_MODE,
+        VORONOI_MODE,
+        MST_MODE,
+        ECCENTRICITY_MODE,
+        BETWEENNESS_MODE,
 	TOTAL_PRG_MODES = 0xFF
 }PRG_MODE_E;
 
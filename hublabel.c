@@ -0,0 +1,565 @@
+/***************************************************************************************************/
+// HUBLABEL.C
+// Contains all functions of the hub labeling oracle: building pruned labels from the stored
+// Contraction Hierarchies, the hub label section of the binary graph format and the
+// label merge which answers a query, with a vector version on SSE2
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "graphio.h"
+#include "ch.h"
+#include "hublabel.h"
+
+/* Queries checked against Dijkstra by the benchmark, the rest only time the merges */
+#define HUB_LABEL_CHECKED_QUERIES 100
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern GraphFile* openGraphFile(char *fileName);
+extern void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size);
+extern long long getWallTimeMsec();
+extern long long getWallTimeUsec();
+
+/* Smallest distanceA + distanceB over the hubs two sorted labels share, INFINITY if they
+share none. One hub at a time */
+int hubLabelMergeScalar(int *piHubsA, int *piDistancesA, int sizeA,
+	int *piHubsB, int *piDistancesB, int sizeB)
+{
+	int i = 0, j = 0, best = INFINITY;
+
+	while ((i < sizeA) && (j < sizeB))
+	{
+		if (piHubsA[i] == piHubsB[j])
+		{
+			best = MIN(best, piDistancesA[i] + piDistancesB[j]);
+			i++;
+			j++;
+		}
+		else if (piHubsA[i] < piHubsB[j])
+		{
+			i++;
+		}
+		else
+		{
+			j++;
+		}
+	}
+
+	return best;
+}
+
+/* Same as hubLabelMergeScalar. With SSE2 it compares blocks of HUB_LABEL_BLOCK hubs of
+each label against each other, rotating one block through the four lanes, and moves on
+with the block whose last hub is smaller. The tails are merged one hub at a time */
+int hubLabelMerge(int *piHubsA, int *piDistancesA, int sizeA,
+	int *piHubsB, int *piDistancesB, int sizeB)
+{
+	int i = 0, j = 0, best = INFINITY;
+#ifdef __SSE2__
+	__m128i hubsA, hubsB, distancesA, distancesB, isEqual, isLess, sum;
+	__m128i infinity = _mm_set1_epi32(INFINITY), bestBlock = _mm_set1_epi32(INFINITY);
+	int k, lastA, lastB, aBest[HUB_LABEL_BLOCK];
+
+	while ((i + HUB_LABEL_BLOCK <= sizeA) && (j + HUB_LABEL_BLOCK <= sizeB))
+	{
+		hubsA = _mm_loadu_si128((__m128i *)(piHubsA + i));
+		distancesA = _mm_loadu_si128((__m128i *)(piDistancesA + i));
+		hubsB = _mm_loadu_si128((__m128i *)(piHubsB + j));
+		distancesB = _mm_loadu_si128((__m128i *)(piDistancesB + j));
+
+		for (k = 0; k < HUB_LABEL_BLOCK; k++)
+		{
+			isEqual = _mm_cmpeq_epi32(hubsA, hubsB);
+			sum = _mm_add_epi32(distancesA, distancesB);
+			sum = _mm_or_si128(_mm_and_si128(isEqual, sum), _mm_andnot_si128(isEqual, infinity));
+			isLess = _mm_cmplt_epi32(sum, bestBlock);
+			bestBlock = _mm_or_si128(_mm_and_si128(isLess, sum), _mm_andnot_si128(isLess, bestBlock));
+
+			hubsB = _mm_shuffle_epi32(hubsB, _MM_SHUFFLE(0, 3, 2, 1));
+			distancesB = _mm_shuffle_epi32(distancesB, _MM_SHUFFLE(0, 3, 2, 1));
+		}
+
+		lastA = piHubsA[i + HUB_LABEL_BLOCK - 1];
+		lastB = piHubsB[j + HUB_LABEL_BLOCK - 1];
+		if (lastA <= lastB)
+		{
+			i += HUB_LABEL_BLOCK;
+		}
+		if (lastB <= lastA)
+		{
+			j += HUB_LABEL_BLOCK;
+		}
+	}
+
+	_mm_storeu_si128((__m128i *)aBest, bestBlock);
+	for (k = 0; k < HUB_LABEL_BLOCK; k++)
+	{
+		best = MIN(best, aBest[k]);
+	}
+#endif
+
+	while ((i < sizeA) && (j < sizeB))
+	{
+		if (piHubsA[i] == piHubsB[j])
+		{
+			best = MIN(best, piDistancesA[i] + piDistancesB[j]);
+			i++;
+			j++;
+		}
+		else if (piHubsA[i] < piHubsB[j])
+		{
+			i++;
+		}
+		else
+		{
+			j++;
+		}
+	}
+
+	return best;
+}
+
+/* Returns d(source, target) from the labels, INFINITY if target is not reachable */
+int hubLabelPointToPoint(HubLabels *pstLabels, int source, int target)
+{
+	HubLabelSet *pstForward = &pstLabels->stForward;
+	HubLabelSet *pstBackward = &pstLabels->stBackward;
+
+	return hubLabelMerge(pstForward->piHubs + pstForward->pllOffsets[source],
+		pstForward->piDistances + pstForward->pllOffsets[source],
+		(int)(pstForward->pllOffsets[source + 1] - pstForward->pllOffsets[source]),
+		pstBackward->piHubs + pstBackward->pllOffsets[target],
+		pstBackward->piDistances + pstBackward->pllOffsets[target],
+		(int)(pstBackward->pllOffsets[target + 1] - pstBackward->pllOffsets[target]));
+}
+
+/* Same as hubLabelPointToPoint with the scalar merge */
+int hubLabelPointToPointScalar(HubLabels *pstLabels, int source, int target)
+{
+	HubLabelSet *pstForward = &pstLabels->stForward;
+	HubLabelSet *pstBackward = &pstLabels->stBackward;
+
+	return hubLabelMergeScalar(pstForward->piHubs + pstForward->pllOffsets[source],
+		pstForward->piDistances + pstForward->pllOffsets[source],
+		(int)(pstForward->pllOffsets[source + 1] - pstForward->pllOffsets[source]),
+		pstBackward->piHubs + pstBackward->pllOffsets[target],
+		pstBackward->piDistances + pstBackward->pllOffsets[target],
+		(int)(pstBackward->pllOffsets[target + 1] - pstBackward->pllOffsets[target]));
+}
+
+/* qsort comparator for hubs */
+int compareHubs(const void *pLeft, const void *pRight)
+{
+	return (*(int *)pLeft > *(int *)pRight) - (*(int *)pLeft < *(int *)pRight);
+}
+
+/* Builds the label of vertex in one direction from the labels of its neighbours above it
+in the hierarchy, which must be done: the forward label from the upward arcs, the backward
+label from the downward ones. An entry (hub, d) is dropped when the opposite label of hub
+shows a shorter way, so only the entries with the exact distance stay.
+piBest (INFINITY everywhere), piHubs and piDistances are scratch arrays of noOfVertex */
+int buildHubLabelList(ChGraph *pstGraph, HubLabelList *pstLists, HubLabelList *pstOpposite,
+	int vertex, int isForward, int *piBest, int *piHubs, int *piDistances)
+{
+	int *piOffsets = (TRUE == isForward) ? pstGraph->piUpOffsets : pstGraph->piDownOffsets;
+	ChArc *pstArcs = (TRUE == isForward) ? pstGraph->pstUpArcs : pstGraph->pstDownArcs;
+	HubLabelList *pstNeighbour = NULL_PTR, *pstList = &pstLists[vertex];
+	int i, k, hub, distance, noOfHubs = 0, size = 0;
+
+	piBest[vertex] = 0;
+	piHubs[noOfHubs++] = vertex;
+
+	for (i = piOffsets[vertex]; i < piOffsets[vertex + 1]; i++)
+	{
+		pstNeighbour = &pstLists[pstArcs[i].vertex];
+
+		for (k = 0; k < pstNeighbour->size; k++)
+		{
+			hub = pstNeighbour->piHubs[k];
+			distance = pstArcs[i].distance + pstNeighbour->piDistances[k];
+
+			if (INFINITY == piBest[hub])
+			{
+				piHubs[noOfHubs++] = hub;
+			}
+
+			piBest[hub] = MIN(piBest[hub], distance);
+		}
+	}
+
+	qsort(piHubs, noOfHubs, sizeof(int), compareHubs);
+
+	for (k = 0; k < noOfHubs; k++)
+	{
+		piDistances[k] = piBest[piHubs[k]];
+		piBest[piHubs[k]] = INFINITY;
+	}
+
+	pstList->piHubs = (int *)malloc(sizeof(int) * noOfHubs);
+	pstList->piDistances = (int *)malloc(sizeof(int) * noOfHubs);
+	if ((NULL_PTR == pstList->piHubs) || (NULL_PTR == pstList->piDistances))
+	{
+		myLog(ERROR, "Failed to allocate a label of [%d] hubs!", noOfHubs);
+		return ERR;
+	}
+
+	for (k = 0; k < noOfHubs; k++)
+	{
+		hub = piHubs[k];
+
+		if ((hub != vertex)
+			&& (hubLabelMergeScalar(piHubs, piDistances, noOfHubs, pstOpposite[hub].piHubs,
+			pstOpposite[hub].piDistances, pstOpposite[hub].size) < piDistances[k]))
+		{
+			continue;
+		}
+
+		pstList->piHubs[size] = hub;
+		pstList->piDistances[size] = piDistances[k];
+		size++;
+	}
+
+	pstList->size = size;
+
+	return OK;
+}
+
+/* Frees the labels being built */
+void destroyHubLabelLists(HubLabelList *pstLists, int noOfVertex)
+{
+	int i;
+
+	if (NULL_PTR == pstLists)
+	{
+		return;
+	}
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		free(pstLists[i].piHubs);
+		free(pstLists[i].piDistances);
+	}
+
+	free(pstLists);
+}
+
+/* Copies the labels of one direction into a section, at pSet. Returns the end of it */
+char* flattenHubLabelLists(HubLabelList *pstLists, int noOfVertex, long long noOfEntries, char *pSet)
+{
+	long long *pllOffsets = (long long *)pSet;
+	int *piHubs = (int *)(pllOffsets + noOfVertex + 1);
+	int *piDistances = piHubs + noOfEntries;
+	long long entry = 0;
+	int i;
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		pllOffsets[i] = entry;
+		memcpy(piHubs + entry, pstLists[i].piHubs, sizeof(int) * pstLists[i].size);
+		memcpy(piDistances + entry, pstLists[i].piDistances, sizeof(int) * pstLists[i].size);
+		entry += pstLists[i].size;
+	}
+
+	pllOffsets[noOfVertex] = entry;
+
+	return (char *)(piDistances + noOfEntries);
+}
+
+/* Returns a hub label section built from the hierarchy, its length in size. Vertices are
+labelled from the top of the hierarchy down. The caller frees it. NULL on failure */
+void* buildHubLabelSection(ChGraph *pstGraph, long long *size)
+{
+	HubLabelSectionHeader *pstHeader = NULL_PTR;
+	HubLabelList *pstForward = NULL_PTR, *pstBackward = NULL_PTR;
+	int *piOrder = NULL_PTR, *piBest = NULL_PTR, *piHubs = NULL_PTR, *piDistances = NULL_PTR;
+	long long noOfForwardEntries = 0, noOfBackwardEntries = 0;
+	int i, vertex, maxLabelSize = 0, noOfVertex = pstGraph->noOfVertex, retVal = OK;
+
+	pstForward = (HubLabelList *)calloc(noOfVertex, sizeof(HubLabelList));
+	pstBackward = (HubLabelList *)calloc(noOfVertex, sizeof(HubLabelList));
+	piOrder = (int *)malloc(sizeof(int) * noOfVertex);
+	piBest = (int *)malloc(sizeof(int) * noOfVertex);
+	piHubs = (int *)malloc(sizeof(int) * noOfVertex);
+	piDistances = (int *)malloc(sizeof(int) * noOfVertex);
+
+	if ((NULL_PTR == pstForward) || (NULL_PTR == pstBackward) || (NULL_PTR == piOrder)
+		|| (NULL_PTR == piBest) || (NULL_PTR == piHubs) || (NULL_PTR == piDistances))
+	{
+		myLog(ERROR, "Failed to allocate the labels of [%d] vertices!", noOfVertex);
+		retVal = ERR;
+	}
+	else
+	{
+		for (i = 0; i < noOfVertex; i++)
+		{
+			piOrder[pstGraph->piRank[i]] = i;
+			piBest[i] = INFINITY;
+		}
+	}
+
+	for (i = noOfVertex - 1; (i >= 0) && (OK == retVal); i--)
+	{
+		vertex = piOrder[i];
+
+		if ((OK != buildHubLabelList(pstGraph, pstForward, pstBackward, vertex, TRUE,
+			piBest, piHubs, piDistances))
+			|| (OK != buildHubLabelList(pstGraph, pstBackward, pstForward, vertex, FALSE,
+			piBest, piHubs, piDistances)))
+		{
+			retVal = ERR;
+			break;
+		}
+
+		noOfForwardEntries += pstForward[vertex].size;
+		noOfBackwardEntries += pstBackward[vertex].size;
+		maxLabelSize = MAX(maxLabelSize, MAX(pstForward[vertex].size, pstBackward[vertex].size));
+	}
+
+	if (OK == retVal)
+	{
+		*size = HUB_LABEL_SECTION_SIZE(noOfVertex, noOfForwardEntries, noOfBackwardEntries);
+		pstHeader = (HubLabelSectionHeader *)malloc((size_t)*size);
+		if (NULL_PTR == pstHeader)
+		{
+			myLog(ERROR, "Failed to allocate [%lld] bytes of labels!", *size);
+		}
+		else
+		{
+			pstHeader->noOfVertex = noOfVertex;
+			pstHeader->maxLabelSize = maxLabelSize;
+			pstHeader->noOfForwardEntries = noOfForwardEntries;
+			pstHeader->noOfBackwardEntries = noOfBackwardEntries;
+
+			(void)flattenHubLabelLists(pstBackward, noOfVertex, noOfBackwardEntries,
+				flattenHubLabelLists(pstForward, noOfVertex, noOfForwardEntries, (char *)(pstHeader + 1)));
+		}
+	}
+
+	destroyHubLabelLists(pstForward, noOfVertex);
+	destroyHubLabelLists(pstBackward, noOfVertex);
+	free(piOrder);
+	free(piBest);
+	free(piHubs);
+	free(piDistances);
+
+	return pstHeader;
+}
+
+/* Points the labels into a hub label section of size bytes. Returns ERR if the section
+does not fit a graph with noOfVertex vertices */
+int attachHubLabels(HubLabels *pstLabels, void *pSection, long long size, int noOfVertex)
+{
+	HubLabelSectionHeader *pstHeader = (HubLabelSectionHeader *)pSection;
+	long long *pllOffsets = NULL_PTR;
+
+	if ((NULL_PTR == pstLabels) || (NULL_PTR == pSection)
+		|| (size < (long long)sizeof(HubLabelSectionHeader)))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	if ((pstHeader->noOfVertex != noOfVertex) || (pstHeader->noOfForwardEntries < 0)
+		|| (pstHeader->noOfBackwardEntries < 0)
+		|| (size != HUB_LABEL_SECTION_SIZE(pstHeader->noOfVertex, pstHeader->noOfForwardEntries,
+		pstHeader->noOfBackwardEntries)))
+	{
+		myLog(ERROR, "Hub label section does not match the graph!");
+		return ERR;
+	}
+
+	pstLabels->noOfVertex = noOfVertex;
+	pstLabels->maxLabelSize = pstHeader->maxLabelSize;
+
+	pllOffsets = (long long *)(pstHeader + 1);
+	pstLabels->stForward.pllOffsets = pllOffsets;
+	pstLabels->stForward.piHubs = (int *)(pllOffsets + noOfVertex + 1);
+	pstLabels->stForward.piDistances = pstLabels->stForward.piHubs + pstHeader->noOfForwardEntries;
+
+	pllOffsets = (long long *)(pstLabels->stForward.piDistances + pstHeader->noOfForwardEntries);
+	pstLabels->stBackward.pllOffsets = pllOffsets;
+	pstLabels->stBackward.piHubs = (int *)(pllOffsets + noOfVertex + 1);
+	pstLabels->stBackward.piDistances = pstLabels->stBackward.piHubs + pstHeader->noOfBackwardEntries;
+
+	return OK;
+}
+
+/* Entry function for hub label preprocessing. Builds the labels of the binary graph file
+fileName from the hierarchy stored in it and stores them in it as well */
+int hubLabelPrepProc(char *fileName)
+{
+	GraphFile *pstGraphFile = NULL_PTR;
+	HubLabelSectionHeader *pstHeader = NULL_PTR;
+	ChGraph stGraph;
+	void *pSection = NULL_PTR;
+	long long size, startTime;
+	int noOfVertex, retVal;
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR != pstGraphFile)
+	{
+		pSection = getGraphFileSection(pstGraphFile, GRAPH_SECTION_CH, &size);
+	}
+
+	if ((NULL_PTR == pSection)
+		|| (OK != attachChGraph(&stGraph, pSection, size, pstGraphFile->pstHeader->noOfVertex)))
+	{
+		myLog(ERROR, "[%s] has no usable hierarchy! Run -hp on it first", fileName);
+		closeGraphFile(pstGraphFile);
+		return ERR;
+	}
+
+	noOfVertex = stGraph.noOfVertex;
+
+	startTime = getWallTimeMsec();
+	pstHeader = (HubLabelSectionHeader *)buildHubLabelSection(&stGraph, &size);
+
+	/* The section has to be written after the mapping is gone */
+	closeGraphFile(pstGraphFile);
+
+	if (NULL_PTR == pstHeader)
+	{
+		myLog(ERROR, "buildHubLabelSection failed!");
+		return ERR;
+	}
+
+	printf("\nLabelled [%d] vertices in [%lld] msec\n"
+		"Average label: [%lld] forward, [%lld] backward hubs, largest [%d]\n",
+		noOfVertex, getWallTimeMsec() - startTime,
+		pstHeader->noOfForwardEntries / noOfVertex, pstHeader->noOfBackwardEntries / noOfVertex,
+		pstHeader->maxLabelSize);
+
+	retVal = setGraphFileSection(fileName, GRAPH_SECTION_HUB_LABELS, pstHeader, size);
+	free(pstHeader);
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "Could not store the labels in [%s]!", fileName);
+		return ERR;
+	}
+
+	printf("Stored [%lld] bytes of labels in [%s], a distance matrix would take [%lld]\n",
+		size, fileName, (long long)sizeof(int) * noOfVertex * noOfVertex);
+
+	return OK;
+}
+
+/* Entry function for hub label mode. Answers random queries from the labels stored in the
+binary graph file fileName with the scalar and the vector merge and prints the time per
+query of both. The first queries are checked against Dijkstra */
+int hubLabelProc(char *fileName, char *queriesArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	GraphFile *pstGraphFile = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	HubLabels stLabels;
+	void *pSection = NULL_PTR;
+	int *piPairs = NULL_PTR, *piResults = NULL_PTR;
+	long long size, startTime, scalarUsec, vectorUsec;
+	int i, noOfQueries = DEFAULT_HUB_LABEL_QUERIES, retVal = OK;
+
+	if (NULL_PTR != queriesArg)
+	{
+		noOfQueries = atoi(queriesArg);
+	}
+
+	if (noOfQueries <= 0)
+	{
+		myLog(ERROR, "Invalid Input! Queries must be positive");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR != pstGraphFile)
+	{
+		pSection = getGraphFileSection(pstGraphFile, GRAPH_SECTION_HUB_LABELS, &size);
+	}
+
+	piPairs = (int *)malloc(sizeof(int) * 2 * noOfQueries);
+	piResults = (int *)malloc(sizeof(int) * noOfQueries);
+	pstWorkspace = createSsspWorkspace(BINARY_SCHEME, gNoOfVertex);
+
+	if ((NULL_PTR == pSection) || (OK != attachHubLabels(&stLabels, pSection, size, gNoOfVertex)))
+	{
+		myLog(ERROR, "[%s] has no usable labels! Run -hl on it first", fileName);
+		retVal = ERR;
+	}
+	else if ((NULL_PTR == piPairs) || (NULL_PTR == piResults) || (NULL_PTR == pstWorkspace))
+	{
+		myLog(ERROR, "Failed to allocate [%d] queries!", noOfQueries);
+		retVal = ERR;
+	}
+	else
+	{
+		srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+		for (i = 0; i < 2 * noOfQueries; i++)
+		{
+			piPairs[i] = rand() % gNoOfVertex;
+		}
+
+		startTime = getWallTimeUsec();
+		for (i = 0; i < noOfQueries; i++)
+		{
+			piResults[i] = hubLabelPointToPointScalar(&stLabels, piPairs[2 * i], piPairs[(2 * i) + 1]);
+		}
+		scalarUsec = getWallTimeUsec() - startTime;
+
+		startTime = getWallTimeUsec();
+		for (i = 0; i < noOfQueries; i++)
+		{
+			if (piResults[i] != hubLabelPointToPoint(&stLabels, piPairs[2 * i], piPairs[(2 * i) + 1]))
+			{
+				retVal = ERR;
+			}
+		}
+		vectorUsec = getWallTimeUsec() - startTime;
+
+		if (OK != retVal)
+		{
+			myLog(ERROR, "The scalar and the vector merge disagree!");
+		}
+
+		for (i = 0; (i < MIN(noOfQueries, HUB_LABEL_CHECKED_QUERIES)) && (OK == retVal); i++)
+		{
+			if (piResults[i] != ssspPointToPoint(pstWorkspace, pstAdjList, piPairs[2 * i], piPairs[(2 * i) + 1]))
+			{
+				myLog(ERROR, "Query [%d] -> [%d]: labels [%d], Dijkstra [%d]!", piPairs[2 * i],
+					piPairs[(2 * i) + 1], piResults[i], pstWorkspace->piDist[piPairs[(2 * i) + 1]]);
+				retVal = ERR;
+			}
+		}
+
+		if (OK == retVal)
+		{
+			printf("\n[%d] queries, [%d] checked against Dijkstra, largest label [%d]\n"
+				"Scalar merge:\t[%lld] nsec per query\n"
+				"Vector merge:\t[%lld] nsec per query\n",
+				noOfQueries, MIN(noOfQueries, HUB_LABEL_CHECKED_QUERIES), stLabels.maxLabelSize,
+				(scalarUsec * 1000) / noOfQueries, (vectorUsec * 1000) / noOfQueries);
+		}
+	}
+
+	free(piPairs);
+	free(piResults);
+	destroySsspWorkspace(pstWorkspace);
+	closeGraphFile(pstGraphFile);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
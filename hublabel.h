@@ -0,0 +1,61 @@
+/***************************************************************************************************/
+// HUBLABEL.H
+// Contains the hub labels of the hub labeling distance oracle
+/***************************************************************************************************/
+
+#ifndef __HUBLABEL__
+#define __HUBLABEL__
+
+#include "header.h"
+
+#define DEFAULT_HUB_LABEL_QUERIES 100000
+#define HUB_LABEL_BLOCK 4 // Hubs compared at once by the vector merge
+
+/* Start of the hub label section of a binary graph file. It is followed by the forward
+labels (hubs reachable from a vertex) and then the backward labels (hubs reaching it),
+each as long long offsets[noOfVertex + 1], int hubs[entries] and int distances[entries].
+The label of v is [offsets[v], offsets[v + 1]), sorted by hub. d(s, t) is the smallest
+forward distance of s plus backward distance of t over their common hubs */
+typedef struct HubLabelSectionHeader
+{
+	int noOfVertex;
+	int maxLabelSize;
+	long long noOfForwardEntries;
+	long long noOfBackwardEntries;
+}HubLabelSectionHeader;
+
+/* One direction of the labels, pointing into a hub label section or a label being built */
+typedef struct HubLabelSet
+{
+	long long *pllOffsets;
+	int *piHubs;
+	int *piDistances;
+}HubLabelSet;
+
+/* The labels in memory */
+typedef struct HubLabels
+{
+	int noOfVertex;
+	int maxLabelSize;
+	HubLabelSet stForward;
+	HubLabelSet stBackward;
+}HubLabels;
+
+/* A label while the labels are built, one per vertex and direction */
+typedef struct HubLabelList
+{
+	int *piHubs;
+	int *piDistances;
+	int size;
+}HubLabelList;
+
+/* Bytes of one direction of a hub label section */
+#define HUB_LABEL_SET_SIZE(noOfVertex, noOfEntries) \
+	(((long long)sizeof(long long) * ((noOfVertex) + 1)) + ((long long)sizeof(int) * 2 * (noOfEntries)))
+
+/* Bytes of a hub label section */
+#define HUB_LABEL_SECTION_SIZE(noOfVertex, noOfForwardEntries, noOfBackwardEntries) \
+	((long long)sizeof(HubLabelSectionHeader) + HUB_LABEL_SET_SIZE(noOfVertex, noOfForwardEntries) \
+	+ HUB_LABEL_SET_SIZE(noOfVertex, noOfBackwardEntries))
+
+#endif
@@ -0,0 +1,356 @@
+/***************************************************************************************************/
+// JOHNSON.C
+// Contains all functions for the Johnson all pairs mode. One Bellman-Ford pass from a virtual
+// source gives potentials which make every cost non negative, so the heap schemes can stream
+// the rows of a graph with negative costs
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "johnson.h"
+
+extern int gNoOfVertex;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListWithMinCost(char *fileName, int maxVertexNum, int minDistance);
+extern long long getWallTimeMsec();
+extern FILE* getNamedRowSinkSummaryFile(NamedRowSink *pstNamedSink);
+
+/* Frees a Bellman-Ford workspace */
+void destroySpfaWorkspace(SpfaWorkspace *pstSpfa)
+{
+	if (NULL_PTR == pstSpfa)
+	{
+		return;
+	}
+
+	free(pstSpfa->piDist);
+	free(pstSpfa->piPredecessor);
+	free(pstSpfa->piLength);
+	free(pstSpfa->piQueue);
+	free(pstSpfa->pInQueue);
+	free(pstSpfa);
+}
+
+/* Returns a Bellman-Ford workspace for noOfVertex vertices, NULL on failure */
+SpfaWorkspace* createSpfaWorkspace(int noOfVertex)
+{
+	SpfaWorkspace *pstSpfa = NULL_PTR;
+
+	pstSpfa = (SpfaWorkspace *)calloc(1, sizeof(SpfaWorkspace));
+	if (NULL_PTR == pstSpfa)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstSpfa->noOfVertex = noOfVertex;
+	pstSpfa->piDist = (int *)malloc(sizeof(int) * noOfVertex);
+	pstSpfa->piPredecessor = (int *)malloc(sizeof(int) * noOfVertex);
+	pstSpfa->piLength = (int *)malloc(sizeof(int) * noOfVertex);
+	pstSpfa->piQueue = (int *)malloc(sizeof(int) * noOfVertex);
+	pstSpfa->pInQueue = (char *)malloc(sizeof(char) * noOfVertex);
+
+	if ((NULL_PTR == pstSpfa->piDist) || (NULL_PTR == pstSpfa->piPredecessor)
+		|| (NULL_PTR == pstSpfa->piLength) || (NULL_PTR == pstSpfa->piQueue)
+		|| (NULL_PTR == pstSpfa->pInQueue))
+	{
+		myLog(ERROR, "malloc failed!");
+		destroySpfaWorkspace(pstSpfa);
+		return NULL_PTR;
+	}
+
+	return pstSpfa;
+}
+
+/* Bellman-Ford from source, or from JOHNSON_VIRTUAL_SOURCE which reaches every vertex at
+cost 0. Only vertices whose distance dropped are scanned again. Returns OK, or TRUE once a
+negative cycle is reachable. piCycleVertex is then the vertex whose path grew to noOfVertex
+edges, and its predecessors lead into the cycle */
+int runSpfa(SpfaWorkspace *pstSpfa, AdjList *pstAdjList, int source, int *piCycleVertex)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	int i, vertex, nextVertex, distance, head = 0, noOfQueued = 0;
+	int noOfVertex = pstSpfa->noOfVertex;
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		pstSpfa->piDist[i] = (JOHNSON_VIRTUAL_SOURCE == source) ? 0 : INFINITY;
+		pstSpfa->piPredecessor[i] = -1;
+		pstSpfa->piLength[i] = 0;
+		pstSpfa->pInQueue[i] = (JOHNSON_VIRTUAL_SOURCE == source);
+		pstSpfa->piQueue[i] = i;
+	}
+
+	noOfQueued = (JOHNSON_VIRTUAL_SOURCE == source) ? noOfVertex : 0;
+	if (JOHNSON_VIRTUAL_SOURCE != source)
+	{
+		pstSpfa->piDist[source] = 0;
+		pstSpfa->pInQueue[source] = TRUE;
+		pstSpfa->piQueue[0] = source;
+		noOfQueued = 1;
+	}
+
+	pstSpfa->noOfRelaxed = 0;
+
+	while (noOfQueued > 0)
+	{
+		vertex = pstSpfa->piQueue[head];
+		head = (head + 1) % noOfVertex;
+		noOfQueued--;
+		pstSpfa->pInQueue[vertex] = FALSE;
+
+		for (pstTraverser = pstAdjList[vertex].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			nextVertex = pstTraverser->vertexNum;
+			distance = pstSpfa->piDist[vertex] + pstTraverser->distance;
+			if (distance >= pstSpfa->piDist[nextVertex])
+			{
+				continue;
+			}
+
+			pstSpfa->piDist[nextVertex] = distance;
+			pstSpfa->piPredecessor[nextVertex] = vertex;
+			pstSpfa->piLength[nextVertex] = pstSpfa->piLength[vertex] + 1;
+			pstSpfa->noOfRelaxed++;
+
+			if (pstSpfa->piLength[nextVertex] >= noOfVertex)
+			{
+				*piCycleVertex = nextVertex;
+				return TRUE;
+			}
+
+			if (FALSE == pstSpfa->pInQueue[nextVertex])
+			{
+				pstSpfa->pInQueue[nextVertex] = TRUE;
+				pstSpfa->piQueue[(head + noOfQueued) % noOfVertex] = nextVertex;
+				noOfQueued++;
+			}
+		}
+	}
+
+	return OK;
+}
+
+/* Prints the negative cycle the predecessors of cycleVertex lead into. Walking back
+noOfVertex steps surely ends on the cycle */
+void printNegativeCycle(SpfaWorkspace *pstSpfa, AdjList *pstAdjList, int cycleVertex)
+{
+	int *piCycle = NULL_PTR;
+	int i, vertex = cycleVertex, length = 0, swap;
+
+	for (i = 0; i < pstSpfa->noOfVertex; i++)
+	{
+		vertex = pstSpfa->piPredecessor[vertex];
+	}
+
+	piCycle = (int *)malloc(sizeof(int) * (pstSpfa->noOfVertex + 1));
+	if (NULL_PTR == piCycle)
+	{
+		myLog(ERROR, "Negative cycle through [%d]", vertex);
+		return;
+	}
+
+	/* Collected backwards, closed by the first vertex again */
+	cycleVertex = vertex;
+	do
+	{
+		piCycle[length++] = vertex;
+		vertex = pstSpfa->piPredecessor[vertex];
+	} while (vertex != cycleVertex);
+	piCycle[length++] = cycleVertex;
+
+	for (i = 0; i < length / 2; i++)
+	{
+		swap = piCycle[i];
+		piCycle[i] = piCycle[length - 1 - i];
+		piCycle[length - 1 - i] = swap;
+	}
+
+	printf("Negative cycle of [%d] edges, cost [%d]\nPath:", length - 1,
+		getBatchPathDistance(pstAdjList, piCycle, length));
+	for (i = 0; i < length; i++)
+	{
+		printf(" %d", piCycle[i]);
+	}
+	printf("\n");
+
+	free(piCycle);
+}
+
+/* Adds potential[u] - potential[v] to the cost of every edge (u, v). With the distances
+from the virtual source as potentials no cost is negative afterwards */
+void reweightAdjList(AdjList *pstAdjList, int *piPotential)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	int i;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		for (pstTraverser = pstAdjList[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			pstTraverser->distance += piPotential[i] - piPotential[pstTraverser->vertexNum];
+		}
+	}
+}
+
+/* Row sink of the reweighted graph. A distance d' from s to v is d' - potential[s] +
+potential[v] in the original graph. The row is changed in place, which is safe as the
+worker resets it before its next source */
+int johnsonRowSink(void *pSinkCtx, int source, int *piRow, int noOfVertex)
+{
+	JohnsonSink *pstJohnson = (JohnsonSink *)pSinkCtx;
+	int i, noOfWrong = 0;
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		if (INFINITY != piRow[i])
+		{
+			piRow[i] += pstJohnson->piPotential[i] - pstJohnson->piPotential[source];
+		}
+	}
+
+	if (source < pstJohnson->noOfChecked)
+	{
+		for (i = 0; i < noOfVertex; i++)
+		{
+			noOfWrong += (piRow[i] != pstJohnson->piCheckedRows[(long long)source * noOfVertex + i]);
+		}
+
+		if (noOfWrong > 0)
+		{
+			myLog(ERROR, "[%d] distances of row [%d] differ from Bellman-Ford!", noOfWrong, source);
+			__sync_fetch_and_add(&pstJohnson->noOfWrong, noOfWrong);
+		}
+	}
+
+	return pstJohnson->pstSink->pfnSink(pstJohnson->pstSink->pSinkCtx, source, piRow, noOfVertex);
+}
+
+/* Entry function for Johnson mode. Streams all pairs distances of a graph which may have
+negative costs. A negative cycle is printed and fails the mode, as there are no shortest
+paths. See openNamedRowSink() for sinkName */
+int johnsonProc(int scheme, char *fileName, char *sinkName, char *threadsArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	SpfaWorkspace *pstSpfa = NULL_PTR;
+	NamedRowSink stNamedSink;
+	JohnsonSink stJohnson;
+	RowSink stSink;
+	long long startTime, noOfNegative = 0, checkMsec = 0;
+	int *piPotential = NULL_PTR;
+	int i, noOfThreads, potentialMsec, timeMsec, cycleVertex = -1, retVal = OK;
+
+	noOfThreads = getWorkerThreadCount(threadsArg);
+
+	pstAdjList = loadAdjListWithMinCost(fileName, MAX_LARGE_VERTEX_NUM, JOHNSON_MIN_EDGE_COST);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListWithMinCost failed!");
+		return ERR;
+	}
+
+	(void)memset(&stJohnson, 0, sizeof(stJohnson));
+	stJohnson.noOfChecked = MIN(JOHNSON_CHECKED_SOURCES, gNoOfVertex);
+
+	pstSpfa = createSpfaWorkspace(gNoOfVertex);
+	piPotential = (int *)malloc(sizeof(int) * gNoOfVertex);
+	stJohnson.piCheckedRows = (int *)malloc(sizeof(int) * stJohnson.noOfChecked * gNoOfVertex);
+
+	if ((NULL_PTR == pstSpfa) || (NULL_PTR == piPotential) || (NULL_PTR == stJohnson.piCheckedRows))
+	{
+		myLog(ERROR, "malloc failed!");
+		retVal = ERR;
+	}
+
+	/* Potentials from the virtual source */
+	if (OK == retVal)
+	{
+		startTime = getWallTimeMsec();
+		retVal = runSpfa(pstSpfa, pstAdjList, JOHNSON_VIRTUAL_SOURCE, &cycleVertex);
+		potentialMsec = (int)(getWallTimeMsec() - startTime);
+
+		if (OK != retVal)
+		{
+			printNegativeCycle(pstSpfa, pstAdjList, cycleVertex);
+			printf("\nNo shortest paths: the graph has a negative cycle. [%d] msec\n", potentialMsec);
+			myLog(ERROR, "The graph has a negative cycle!");
+			retVal = ERR;
+		}
+	}
+
+	if (OK == retVal)
+	{
+		(void)memcpy(piPotential, pstSpfa->piDist, sizeof(int) * gNoOfVertex);
+		for (i = 0; i < gNoOfVertex; i++)
+		{
+			noOfNegative += (piPotential[i] < 0);
+		}
+
+		printf("\nPotentials: [%d] msec, [%lld] relaxations, [%lld] vertices below 0\n",
+			potentialMsec, pstSpfa->noOfRelaxed, noOfNegative);
+
+		/* Rows to check against, on the original costs */
+		startTime = getWallTimeMsec();
+		for (i = 0; (i < stJohnson.noOfChecked) && (OK == retVal); i++)
+		{
+			retVal = runSpfa(pstSpfa, pstAdjList, i, &cycleVertex);
+			(void)memcpy(&stJohnson.piCheckedRows[(long long)i * gNoOfVertex], pstSpfa->piDist,
+				sizeof(int) * gNoOfVertex);
+		}
+		checkMsec = getWallTimeMsec() - startTime;
+	}
+
+	if (OK == retVal)
+	{
+		reweightAdjList(pstAdjList, piPotential);
+
+		if (OK != openNamedRowSink(&stNamedSink, sinkName))
+		{
+			retVal = ERR;
+		}
+	}
+
+	if (OK == retVal)
+	{
+		stJohnson.pstSink = &stNamedSink.stSink;
+		stJohnson.piPotential = piPotential;
+		stSink.pfnSink = johnsonRowSink;
+		stSink.pSinkCtx = &stJohnson;
+
+		timeMsec = runStreamingScheme(scheme, pstAdjList, &stSink, noOfThreads);
+
+		if ((OK != closeNamedRowSink(&stNamedSink)) || (INVALID_TIME == timeMsec))
+		{
+			myLog(ERROR, "runStreamingScheme failed!");
+			retVal = ERR;
+		}
+	}
+
+	if (OK == retVal)
+	{
+		fprintf(getNamedRowSinkSummaryFile(&stNamedSink),
+			"\n%s: [%d] vertices, [%d] workers, [%d] msec, [%d] msec with the potentials\n"
+			"Bellman-Ford from every source: about [%lld] msec\n",
+			schemeString[scheme], gNoOfVertex, noOfThreads, timeMsec, timeMsec + potentialMsec,
+			(checkMsec * gNoOfVertex) / MAX(stJohnson.noOfChecked, 1));
+
+		printNamedRowSinkTotals(&stNamedSink);
+
+		if (stJohnson.noOfWrong > 0)
+		{
+			myLog(ERROR, "[%d] distances of the first [%d] rows are wrong!", stJohnson.noOfWrong,
+				stJohnson.noOfChecked);
+			retVal = ERR;
+		}
+	}
+
+	destroySpfaWorkspace(pstSpfa);
+	free(piPotential);
+	free(stJohnson.piCheckedRows);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
@@ -0,0 +1,40 @@
+/***************************************************************************************************/
+// JOHNSON.H
+// Contains the Bellman-Ford workspace and the row sink of the Johnson all pairs mode
+/***************************************************************************************************/
+
+#ifndef __JOHNSON__
+#define __JOHNSON__
+
+#include "header.h"
+#include "stream.h"
+
+#define JOHNSON_MIN_EDGE_COST (1 - MAX_EDGE_COST) // Text graphs of this mode may have costs down to here
+#define JOHNSON_CHECKED_SOURCES 10
+#define JOHNSON_VIRTUAL_SOURCE -1 // Joined to every vertex with a 0 cost edge
+
+/* Queue based Bellman-Ford (SPFA). piLength[v] is the number of edges of the path to v,
+which reaches noOfVertex only through a negative cycle */
+typedef struct SpfaWorkspace
+{
+	int noOfVertex;
+	int *piDist;
+	int *piPredecessor;
+	int *piLength;
+	int *piQueue; // Circular, a vertex is in it at most once
+	char *pInQueue;
+	long long noOfRelaxed;
+}SpfaWorkspace;
+
+/* Turns the rows of the reweighted graph back into distances of the original graph, checks
+the first rows and passes them on to the sink picked on the command line */
+typedef struct JohnsonSink
+{
+	RowSink *pstSink;
+	int *piPotential;
+	int noOfChecked;
+	int *piCheckedRows; // noOfChecked x V, from Bellman-Ford on the original costs
+	volatile int noOfWrong;
+}JohnsonSink;
+
+#endif
@@ -10,6 +10,8 @@
 #include <time.h>
 #include "header.h"
 
+extern char *schemeString[TOTAL_SCHEMES];
+
 /******** CONFIG VARIABLES START ****************/
 //Stores the number to vertices
 int gNoOfVertex = 100;
@@ -17,6 +19,10 @@ int gNoOfVertex = 100;
 int gGraphDensity = 10;
 //The default log level is ERR
 int gLogLevel = LERROR;
+//Seed for the random graph generator. 0 seeds from the clock
+unsigned int gRandomSeed = 0;
+//Directory of the generated graph cache. NULL when graphs are not cached
+char *gGraphCacheDir = NULL_PTR;
 /************ CONFIG VARIABLES END **************/
 
 //The output is stored here. For simplicity take static memory and that too for
@@ -26,20 +32,69 @@ int dist[MAX_VERTEX_NUM][MAX_VERTEX_NUM];
 //The mode of the program
 PRG_MODE_E gProgramMode = INVALID_MODE;
 
+//Bumped whenever the loaded graph changes, so cached rows of older versions are dropped
+volatile int gGraphVersion = 0;
+
 void printProgUsage()
 {
-	printf("\nUsage: ./a.out -[r|i[s|b|f [fileName]]\n"
+	printf("\nUsage: ./a.out -[r[c [cacheDir]]|i[s|b|f [fileName]]|p[s|b|f fileName [shmName]|r [shmName]]"
+			"|a[s|b|f] fileName [sink [threads]]|m[s|b|f] fileName matFile [threads]|mq matFile [src [dst]]"
+			"|g fileName graphFile|x graphFile src[,src...] [sink [pqEntries]]"
+			"|q[s|b|f] fileName src [dst]|b[s|b|f] fileName src dst"
+			"|lp graphFile [k [farthest|avoid]]|l[s|b|f] graphFile src dst"
+			"|co graphFile coFile|c[s|b|f] graphFile [queries [euclidean|manhattan]]"
+			"|hp graphFile|h[s|b|f] graphFile src dst|hl graphFile|hq graphFile [queries]|fp graphFile [cells]|f[s|b|f] graphFile src dst"
+			"|op graphFile [levels [fanout]]|o[s|b|f] graphFile [updateFile|- [queries [threads]]]"
+			"|t[s|b|f] fileName [k [queries]]|e[s|b|f] fileName [queries [cacheMB [threads [updateFile]]]]"
+			"|n[s|b|f] fileName queryFile [none|-|outFile [threads [paths]]]|w[s|b|f] graphFile sources [targets [-|outFile]]"
+			"|k[s|b|f] fileName src range|nearest bound|y[s|b|f] fileName src dst [k [threads]]"
+			"|j[s|b|f] fileName [agg|-|outFile [threads]]|v[s|b|f] fileName v[,v...]|random:N|idFile [none|-|outFile]|s [fileName]"
+			"|d[s|b|f] fileName [all|diameter|-|outFile]|u[s|b|f] fileName [sources [threads [none|-|outFile]]]]\n"
 			"\t-r\t\t\tRandom Mode\n"
+			"\t-rc [cacheDir]\t\tRandom Mode - Graphs cached on disk\n"
 			"\t-is\t\t\tInteractive Mode - User Input - Simple Scheme Application\n"
 			"\t-ib\t\t\tInteractive Mode - User Input - Binomial Heap Application\n"
 			"\t-if\t\t\tInteractive Mode - User Input - Fibonacci Heap Application\n"
-			"\t-i[s|b|f] [fileName]\tInteractive Mode - File Input\n\n");
+			"\t-i[s|b|f] [fileName]\tInteractive Mode - File Input\n"
+			"\t-p[s|b|f] fileName [shmName]\tPublish Mode - Distance matrix to shared memory\n"
+			"\t-pr [shmName]\t\tPublish Mode - Print the published matrix\n"
+			"\t-a[s|b|f] fileName [agg|-|outFile [threads]]\tAll Pairs Stream Mode - One row at a time\n"
+			"\t-m[s|b|f] fileName matFile [threads]\tDistance Matrix Mode - Tiled matrix in a mapped file\n"
+			"\t-mq matFile [src [dst]]\tDistance Matrix Mode - Look up a row or an entry\n"
+			"\t-g fileName graphFile\tGraph Convert Mode - Store a graph as a binary graph file\n"
+			"\t-x graphFile src[,src...] [sink [pqEntries]]\tExternal Memory Mode - Edges read from disk\n"
+			"\t-q[s|b|f] fileName src [dst]\tQuery Mode - Single source, or point to point with early stop and the path\n"
+			"\t-b[s|b|f] fileName src dst\tBidirectional Mode - Point to point from both ends\n"
+			"\t-lp graphFile [k [farthest|avoid]]\tLandmark Mode - Store k ALT landmarks in the graph file\n"
+			"\t-l[s|b|f] graphFile src dst\tALT Mode - Point to point A* with the stored landmarks\n"
+			"\t-co graphFile coFile\tCoordinate Mode - Store DIMACS coordinates in the graph file\n"
+			"\t-c[s|b|f] graphFile [queries [euclidean|manhattan]]\tA* Mode - Random queries with the coordinate bound\n"
+			"\t-hp graphFile\t\tHierarchy Mode - Store Contraction Hierarchies in the graph file\n"
+			"\t-h[s|b|f] graphFile src dst\tCH Mode - Point to point on the stored hierarchy, with the path\n"
+			"\t-hl graphFile\t\tHub Label Mode - Store hub labels built from the hierarchy\n"
+			"\t-hq graphFile [queries]\tHub Label Mode - Random queries on the stored labels\n"
+			"\t-fp graphFile [cells]\tArc Flags Mode - Store the cells and edge flags in the graph file\n"
+			"\t-f[s|b|f] graphFile src dst\tFlagged Mode - Point to point skipping edges not flagged for dst\n"
+			"\t-op graphFile [levels [fanout]]\tPartition Mode - Store a nested partition in the graph file\n"
+			"\t-o[s|b|f] graphFile [updateFile|- [queries [threads]]]\tOverlay Mode - Customize, query, update weights\n"
+			"\t-t[s|b|f] fileName [k [queries]]\tOracle Mode - Thorup-Zwick estimates against exact distances\n"
+			"\t-e[s|b|f] fileName [queries [cacheMB [threads [updateFile]]]]\tRow Cache Mode - Skewed queries through an LRU of rows\n"
+			"\t-n[s|b|f] fileName queryFile [none|-|outFile [threads [paths]]]\tBatch Mode - Queries grouped by source\n"
+			"\t-w[s|b|f] graphFile sources [targets [-|outFile]]\tMany to Many Mode - Distance table on the stored hierarchy\n"
+			"\t-k[s|b|f] fileName src range|nearest bound\tLocal Query Mode - Vertices within a distance, or the k nearest\n"
+			"\t-y[s|b|f] fileName src dst [k [threads]]\tYen Mode - k shortest loopless paths\n"
+			"\t-j[s|b|f] fileName [agg|-|outFile [threads]]\tJohnson Mode - All pairs with negative costs\n"
+			"\t-v[s|b|f] fileName v[,v...]|random:N|idFile [none|-|outFile]\tVoronoi Mode - Closest facility of every vertex\n"
+			"\t-s [fileName]\t\tSpanning Tree Mode - Prim on each heap and Kruskal\n"
+			"\t-d[s|b|f] fileName [all|diameter|-|outFile]\tEccentricity Mode - Exact eccentricities and diameter\n"
+			"\t-u[s|b|f] fileName [sources [threads [none|-|outFile]]]\tBetweenness Mode - Brandes, exact or from sampled sources\n\n");
 }
 
 int main(int argc, char *argv[])
 {
 	char *cpFileName = NULL_PTR;
-	int retVal;
+	int retVal, scheme = BINARY_SCHEME;
+	int minArgs = MIN_ARGS, maxArgs = MAX_ARGS;
 
 	/* Scan the user arguments and determine the mode */
 	if (argc < MIN_ARGS)
@@ -48,73 +103,507 @@ int main(int argc, char *argv[])
 		return PRG_ERR;
 	}
 
-	switch (argc)
-	{
-		case 2:
-		case 3:
-		{
-			/* Parse the second argument */
-			if ('r' == argv[1][1])
-			{
-				myLog(INFO, "Random Mode");
-				gProgramMode = RANDOM_MODE;
-			}
-			else if ('i' == argv[1][1])
-			{
-				if ('s' == argv[1][2])
-				{
-					myLog(INFO, "Interactive Mode - Simple");
-					gProgramMode = INTERACTIVE_SIMPLE_MODE;
-				}
-				else if ('b' == argv[1][2])
-				{
-					myLog(INFO, "Interactive Mode - Binomial");
-					gProgramMode = INTERACTIVE_BINOMIAL_MODE;
-				}
-				else if ('f' == argv[1][2])
-				{
-					myLog(INFO, "Interactive Mode - Fibonacci");
-					gProgramMode = INTERACTIVE_FIBONACCI_MODE;
-				}
-				else
-				{
-					myLog(ERROR, "Invalid Mode!");
-					printProgUsage();
-					return PRG_ERR;
-				}
-			}
-			else
-			{
-				myLog(ERROR, "Invalid Mode!");
-				printProgUsage();
-				return PRG_ERR;
-			}
-
-			/* Parse file name if present */
-			if (argc >= 3)
-			{
-				cpFileName = argv[2];
-				myLog(INFO, "File name: [%s]\n", cpFileName);
-
-				/* Make all mode into corresponding file mode */
-				gProgramMode += 3;
-			}
-
-			/* Change the log level. Secret functionality :) Disabled currently */
-			if (4 == argc)
-			{
-				if (((argv[3][0] - '0') >= 0)
-					&& ((argv[3][0] - '0') <= 2))
-				gLogLevel = (argv[3][0] - '0');
-			}
+	/* Parse the second argument */
+	if ('r' == argv[1][1])
+	{
+		if ('c' == argv[1][2])
+		{
+			myLog(INFO, "Random Mode - Cached Graphs");
+			gProgramMode = RANDOM_CACHED_MODE;
+		}
+		else
+		{
+			myLog(INFO, "Random Mode");
+			gProgramMode = RANDOM_MODE;
+		}
+	}
+	else if ('i' == argv[1][1])
+	{
+		if ('s' == argv[1][2])
+		{
+			myLog(INFO, "Interactive Mode - Simple");
+			gProgramMode = INTERACTIVE_SIMPLE_MODE;
+		}
+		else if ('b' == argv[1][2])
+		{
+			myLog(INFO, "Interactive Mode - Binomial");
+			gProgramMode = INTERACTIVE_BINOMIAL_MODE;
+		}
+		else if ('f' == argv[1][2])
+		{
+			myLog(INFO, "Interactive Mode - Fibonacci");
+			gProgramMode = INTERACTIVE_FIBONACCI_MODE;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('p' == argv[1][1])
+	{
+		/* Publish modes take the graph file and an optional segment name */
+		maxArgs = 4;
 
-			break;
+		if ('r' == argv[1][2])
+		{
+			myLog(INFO, "Publish Mode - Reader");
+			gProgramMode = PUBLISH_READER_MODE;
+			maxArgs = 3;
 		}
-		default:
+		else if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Publish Mode - %s", schemeString[scheme]);
+			gProgramMode = PUBLISH_MODE;
+			minArgs = 3;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('a' == argv[1][1])
+	{
+		/* Stream mode takes the graph file, an optional sink and an optional thread count */
+		if (ERR == (scheme = getSchemeFromChar(argv[1][2])))
 		{
+			myLog(ERROR, "Invalid Mode!");
 			printProgUsage();
 			return PRG_ERR;
 		}
+
+		myLog(INFO, "All Pairs Stream Mode - %s", schemeString[scheme]);
+		gProgramMode = ALLPAIRS_STREAM_MODE;
+		minArgs = 3;
+		maxArgs = 5;
+	}
+	else if ('m' == argv[1][1])
+	{
+		/* Matrix file modes. The query takes the matrix file and an optional source and
+		destination, the solver the graph file, the matrix file and an optional thread count */
+		minArgs = 3;
+		maxArgs = 5;
+
+		if ('q' == argv[1][2])
+		{
+			myLog(INFO, "Distance Matrix Mode - Query");
+			gProgramMode = DIST_MATRIX_QUERY_MODE;
+		}
+		else if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Distance Matrix Mode - %s", schemeString[scheme]);
+			gProgramMode = DIST_MATRIX_MODE;
+			minArgs = 4;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('g' == argv[1][1])
+	{
+		myLog(INFO, "Graph Convert Mode");
+		gProgramMode = GRAPH_CONVERT_MODE;
+		minArgs = 4;
+		maxArgs = 4;
+	}
+	else if ('x' == argv[1][1])
+	{
+		/* The binary graph file, the sources and optionally the sink and the queue size */
+		myLog(INFO, "External Memory Mode");
+		gProgramMode = EXTERNAL_MEMORY_MODE;
+		minArgs = 4;
+		maxArgs = 6;
+	}
+	else if ('q' == argv[1][1])
+	{
+		/* Query mode takes the graph file, the source and an optional destination */
+		if (ERR == (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+
+		myLog(INFO, "Query Mode - %s", schemeString[scheme]);
+		gProgramMode = QUERY_MODE;
+		minArgs = 4;
+		maxArgs = 5;
+	}
+	else if ('b' == argv[1][1])
+	{
+		/* Bidirectional mode takes the graph file, the source and the destination */
+		if (ERR == (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+
+		myLog(INFO, "Bidirectional Mode - %s", schemeString[scheme]);
+		gProgramMode = BIDIRECTIONAL_MODE;
+		minArgs = 5;
+		maxArgs = 5;
+	}
+	else if ('l' == argv[1][1])
+	{
+		/* Landmark preprocessing takes the graph file and optionally the count and the
+		selection, ALT queries the graph file, the source and the destination */
+		if ('p' == argv[1][2])
+		{
+			myLog(INFO, "Landmark Mode");
+			gProgramMode = LANDMARK_MODE;
+			minArgs = 3;
+			maxArgs = 5;
+		}
+		else if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "ALT Mode - %s", schemeString[scheme]);
+			gProgramMode = ALT_MODE;
+			minArgs = 5;
+			maxArgs = 5;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('c' == argv[1][1])
+	{
+		/* Coordinate mode takes the graph file and the DIMACS coordinate file, A* mode the
+		graph file and optionally the number of queries and the metric */
+		if ('o' == argv[1][2])
+		{
+			myLog(INFO, "Coordinate Mode");
+			gProgramMode = COORD_MODE;
+			minArgs = 4;
+			maxArgs = 4;
+		}
+		else if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "A* Mode - %s", schemeString[scheme]);
+			gProgramMode = ASTAR_MODE;
+			minArgs = 3;
+			maxArgs = 5;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('h' == argv[1][1])
+	{
+		/* Hierarchy preprocessing and hub labelling take the graph file, CH queries the
+		graph file, the source and the destination, hub label queries optionally a count */
+		if ('p' == argv[1][2])
+		{
+			myLog(INFO, "Hierarchy Mode");
+			gProgramMode = CH_PREP_MODE;
+			minArgs = 3;
+			maxArgs = 3;
+		}
+		else if ('l' == argv[1][2])
+		{
+			myLog(INFO, "Hub Label Mode - Build");
+			gProgramMode = HUB_LABEL_PREP_MODE;
+			minArgs = 3;
+			maxArgs = 3;
+		}
+		else if ('q' == argv[1][2])
+		{
+			myLog(INFO, "Hub Label Mode - Query");
+			gProgramMode = HUB_LABEL_MODE;
+			minArgs = 3;
+			maxArgs = 4;
+		}
+		else if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "CH Mode - %s", schemeString[scheme]);
+			gProgramMode = CH_MODE;
+			minArgs = 5;
+			maxArgs = 5;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('f' == argv[1][1])
+	{
+		/* Arc flags preprocessing takes the graph file and optionally the number of cells,
+		flagged queries the graph file, the source and the destination */
+		if ('p' == argv[1][2])
+		{
+			myLog(INFO, "Arc Flags Mode");
+			gProgramMode = ARC_FLAG_PREP_MODE;
+			minArgs = 3;
+			maxArgs = 4;
+		}
+		else if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Flagged Mode - %s", schemeString[scheme]);
+			gProgramMode = ARC_FLAG_MODE;
+			minArgs = 5;
+			maxArgs = 5;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('o' == argv[1][1])
+	{
+		/* Partition mode takes the graph file and optionally the levels and the fanout,
+		overlay mode the graph file and optionally the updates, queries and threads */
+		if ('p' == argv[1][2])
+		{
+			myLog(INFO, "Partition Mode");
+			gProgramMode = OVERLAY_PREP_MODE;
+			minArgs = 3;
+			maxArgs = 5;
+		}
+		else if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Overlay Mode - %s", schemeString[scheme]);
+			gProgramMode = OVERLAY_MODE;
+			minArgs = 3;
+			maxArgs = 6;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('t' == argv[1][1])
+	{
+		/* Oracle mode takes the file name and optionally the levels and the queries */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Oracle Mode - %s", schemeString[scheme]);
+			gProgramMode = TZ_MODE;
+			minArgs = 3;
+			maxArgs = 5;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('e' == argv[1][1])
+	{
+		/* Row cache mode takes the file name and optionally the queries, the cache size,
+		the threads and an update file */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Row Cache Mode - %s", schemeString[scheme]);
+			gProgramMode = ROW_CACHE_MODE;
+			minArgs = 3;
+			maxArgs = 7;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('n' == argv[1][1])
+	{
+		/* Batch mode takes the file name, the query file and optionally the output, the
+		threads and whether to keep the paths */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Batch Mode - %s", schemeString[scheme]);
+			gProgramMode = BATCH_MODE;
+			minArgs = 4;
+			maxArgs = 7;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('w' == argv[1][1])
+	{
+		/* Many to many mode takes the graph file, the number of sources and optionally
+		the number of targets and the output */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Many to Many Mode - %s", schemeString[scheme]);
+			gProgramMode = MANY_TO_MANY_MODE;
+			minArgs = 4;
+			maxArgs = 6;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('k' == argv[1][1])
+	{
+		/* Local query mode takes the file name, the source, the query type and the bound */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Local Query Mode - %s", schemeString[scheme]);
+			gProgramMode = LOCAL_QUERY_MODE;
+			minArgs = 6;
+			maxArgs = 6;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('y' == argv[1][1])
+	{
+		/* Yen mode takes the file name, the source, the destination, k and the threads */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Yen Mode - %s", schemeString[scheme]);
+			gProgramMode = YEN_MODE;
+			minArgs = 5;
+			maxArgs = 7;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('j' == argv[1][1])
+	{
+		/* Johnson mode takes the file name, the sink and the threads */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Johnson Mode - %s", schemeString[scheme]);
+			gProgramMode = JOHNSON_MODE;
+			minArgs = 3;
+			maxArgs = 5;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('d' == argv[1][1])
+	{
+		/* Eccentricity mode takes the file name and what to find or where to write it */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Eccentricity Mode - %s", schemeString[scheme]);
+			gProgramMode = ECCENTRICITY_MODE;
+			minArgs = 3;
+			maxArgs = 4;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('u' == argv[1][1])
+	{
+		/* Betweenness mode takes the file name, the sampled sources, the threads and the output */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Betweenness Mode - %s", schemeString[scheme]);
+			gProgramMode = BETWEENNESS_MODE;
+			minArgs = 3;
+			maxArgs = 6;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else if ('s' == argv[1][1])
+	{
+		/* Spanning tree mode takes an optional file name, else it uses the random graphs */
+		myLog(INFO, "Spanning Tree Mode");
+		gProgramMode = MST_MODE;
+		minArgs = 2;
+		maxArgs = 3;
+	}
+	else if ('v' == argv[1][1])
+	{
+		/* Voronoi mode takes the file name, the number of facilities and the output */
+		if (ERR != (scheme = getSchemeFromChar(argv[1][2])))
+		{
+			myLog(INFO, "Voronoi Mode - %s", schemeString[scheme]);
+			gProgramMode = VORONOI_MODE;
+			minArgs = 4;
+			maxArgs = 5;
+		}
+		else
+		{
+			myLog(ERROR, "Invalid Mode!");
+			printProgUsage();
+			return PRG_ERR;
+		}
+	}
+	else
+	{
+		myLog(ERROR, "Invalid Mode!");
+		printProgUsage();
+		return PRG_ERR;
+	}
+
+	if ((argc < minArgs) || (argc > maxArgs))
+	{
+		myLog(ERROR, "Invalid number of arguments for the mode!");
+		printProgUsage();
+		return PRG_ERR;
+	}
+
+	/* Parse file name if present */
+	if (argc >= 3)
+	{
+		cpFileName = argv[2];
+		myLog(INFO, "File name: [%s]\n", cpFileName);
+
+		/* Make all interactive modes into corresponding file mode */
+		if ((gProgramMode >= INTERACTIVE_SIMPLE_MODE)
+			&& (gProgramMode <= INTERACTIVE_FIBONACCI_MODE))
+		{
+			gProgramMode += 3;
+		}
+	}
+
+	/* Change the log level. Secret functionality :) Disabled currently */
+	if ((4 == argc) && (gProgramMode <= INTERACTIVE_FIBONACCI_FILE_MODE))
+	{
+		if (((argv[3][0] - '0') >= 0)
+			&& ((argv[3][0] - '0') <= 2))
+		gLogLevel = (argv[3][0] - '0');
 	}
 
 	/* Invoke respective functions */
@@ -125,6 +614,11 @@ int main(int argc, char *argv[])
 			retVal = randomProc();
 			break;
 		}
+		case RANDOM_CACHED_MODE:
+		{
+			retVal = randomCachedProc(cpFileName);
+			break;
+		}
 		case INTERACTIVE_SIMPLE_MODE:
 		{
 			retVal = binaryProc();
@@ -155,6 +649,181 @@ int main(int argc, char *argv[])
 			retVal = fiboFileProc(cpFileName);
 			break;
 		}
+		case PUBLISH_MODE:
+		{
+			retVal = publishProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR));
+			break;
+		}
+		case PUBLISH_READER_MODE:
+		{
+			retVal = printDistShm(cpFileName);
+			break;
+		}
+		case ALLPAIRS_STREAM_MODE:
+		{
+			retVal = streamProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case DIST_MATRIX_MODE:
+		{
+			retVal = distMatProc(scheme, cpFileName, argv[3], ((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case DIST_MATRIX_QUERY_MODE:
+		{
+			retVal = distMatQueryProc(cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case GRAPH_CONVERT_MODE:
+		{
+			retVal = convertGraphProc(cpFileName, argv[3]);
+			break;
+		}
+		case EXTERNAL_MEMORY_MODE:
+		{
+			retVal = extMemProc(cpFileName, argv[3], ((argc > 4) ? argv[4] : NULL_PTR),
+				((argc > 5) ? argv[5] : NULL_PTR));
+			break;
+		}
+		case QUERY_MODE:
+		{
+			retVal = ssspQueryProc(scheme, cpFileName, argv[3], ((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case BIDIRECTIONAL_MODE:
+		{
+			retVal = bidirectionalProc(scheme, cpFileName, argv[3], argv[4]);
+			break;
+		}
+		case LANDMARK_MODE:
+		{
+			retVal = landmarkProc(cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case ALT_MODE:
+		{
+			retVal = altProc(scheme, cpFileName, argv[3], argv[4]);
+			break;
+		}
+		case COORD_MODE:
+		{
+			retVal = coordProc(cpFileName, argv[3]);
+			break;
+		}
+		case ASTAR_MODE:
+		{
+			retVal = astarBenchProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case CH_PREP_MODE:
+		{
+			retVal = chPrepProc(cpFileName);
+			break;
+		}
+		case CH_MODE:
+		{
+			retVal = chQueryProc(scheme, cpFileName, argv[3], argv[4]);
+			break;
+		}
+		case HUB_LABEL_PREP_MODE:
+		{
+			retVal = hubLabelPrepProc(cpFileName);
+			break;
+		}
+		case HUB_LABEL_MODE:
+		{
+			retVal = hubLabelProc(cpFileName, ((argc > 3) ? argv[3] : NULL_PTR));
+			break;
+		}
+		case ARC_FLAG_PREP_MODE:
+		{
+			retVal = arcFlagPrepProc(cpFileName, ((argc > 3) ? argv[3] : NULL_PTR));
+			break;
+		}
+		case ARC_FLAG_MODE:
+		{
+			retVal = arcFlagProc(scheme, cpFileName, argv[3], argv[4]);
+			break;
+		}
+		case OVERLAY_PREP_MODE:
+		{
+			retVal = overlayPrepProc(cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case OVERLAY_MODE:
+		{
+			retVal = overlayProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR), ((argc > 5) ? argv[5] : NULL_PTR));
+			break;
+		}
+		case TZ_MODE:
+		{
+			retVal = tzProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case ROW_CACHE_MODE:
+		{
+			retVal = rowCacheProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR), ((argc > 5) ? argv[5] : NULL_PTR),
+				((argc > 6) ? argv[6] : NULL_PTR));
+			break;
+		}
+		case JOHNSON_MODE:
+		{
+			retVal = johnsonProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case ECCENTRICITY_MODE:
+		{
+			retVal = eccentricityProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR));
+			break;
+		}
+		case BETWEENNESS_MODE:
+		{
+			retVal = brandesProc(scheme, cpFileName, ((argc > 3) ? argv[3] : NULL_PTR),
+				((argc > 4) ? argv[4] : NULL_PTR), ((argc > 5) ? argv[5] : NULL_PTR));
+			break;
+		}
+		case MST_MODE:
+		{
+			retVal = mstProc(cpFileName);
+			break;
+		}
+		case VORONOI_MODE:
+		{
+			retVal = voronoiProc(scheme, cpFileName, argv[3], ((argc > 4) ? argv[4] : NULL_PTR));
+			break;
+		}
+		case BATCH_MODE:
+		{
+			retVal = batchProc(scheme, cpFileName, argv[3], ((argc > 4) ? argv[4] : NULL_PTR),
+				((argc > 5) ? argv[5] : NULL_PTR), ((argc > 6) ? argv[6] : NULL_PTR));
+			break;
+		}
+		case MANY_TO_MANY_MODE:
+		{
+			retVal = manyToManyProc(scheme, cpFileName, argv[3], ((argc > 4) ? argv[4] : NULL_PTR),
+				((argc > 5) ? argv[5] : NULL_PTR));
+			break;
+		}
+		case LOCAL_QUERY_MODE:
+		{
+			retVal = localQueryProc(scheme, cpFileName, argv[3], argv[4], argv[5]);
+			break;
+		}
+		case YEN_MODE:
+		{
+			retVal = yenProc(scheme, cpFileName, argv[3], argv[4], ((argc > 5) ? argv[5] : NULL_PTR),
+				((argc > 6) ? argv[6] : NULL_PTR));
+			break;
+		}
 		default:
 		{
 			myLog(ERROR, "Invalid Mode: [%d]", gProgramMode);
@@ -0,0 +1,499 @@
+/***************************************************************************************************/
+// MANYTOMANY.C
+// Contains all functions for the many to many mode. One backward upward search per target
+// fills the buckets of the hierarchy, then one forward upward search per source scans the
+// buckets it meets, so each source and target is searched once
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "graphio.h"
+#include "stream.h"
+#include "manytomany.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern GraphFile* openGraphFile(char *fileName);
+extern void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size);
+extern long long getWallTimeMsec();
+
+/* Frees the table */
+void destroyManyToManyTable(ManyToManyTable *pstTable)
+{
+	if (NULL_PTR == pstTable)
+	{
+		return;
+	}
+
+	free(pstTable->piSources);
+	free(pstTable->piTargets);
+	free(pstTable->piDistances);
+	free(pstTable);
+}
+
+/* Returns a table for the given sources and targets, which are copied. Returns NULL on
+failure */
+ManyToManyTable* createManyToManyTable(int *piSources, int noOfSources, int *piTargets, int noOfTargets)
+{
+	ManyToManyTable *pstTable = NULL_PTR;
+
+	pstTable = (ManyToManyTable *)calloc(1, sizeof(ManyToManyTable));
+	if (NULL_PTR == pstTable)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstTable->noOfSources = noOfSources;
+	pstTable->noOfTargets = noOfTargets;
+	pstTable->piSources = (int *)malloc(sizeof(int) * noOfSources);
+	pstTable->piTargets = (int *)malloc(sizeof(int) * noOfTargets);
+	pstTable->piDistances = (int *)malloc(sizeof(int) * noOfSources * noOfTargets);
+
+	if ((NULL_PTR == pstTable->piSources) || (NULL_PTR == pstTable->piTargets)
+		|| (NULL_PTR == pstTable->piDistances))
+	{
+		myLog(ERROR, "Failed to allocate a [%d] x [%d] table!", noOfSources, noOfTargets);
+		destroyManyToManyTable(pstTable);
+		return NULL_PTR;
+	}
+
+	(void)memcpy(pstTable->piSources, piSources, sizeof(int) * noOfSources);
+	(void)memcpy(pstTable->piTargets, piTargets, sizeof(int) * noOfTargets);
+
+	return pstTable;
+}
+
+/* Settles the closest vertex of an upward search over the arcs piOffsets / pstArcs, with
+stall-on-demand over the opposite arcs. vertex and distance get the settled vertex.
+Returns TRUE if it was stalled, FALSE if its arcs were relaxed and ERR on failure */
+int mtmSettleNext(SsspWorkspace *pstWorkspace, int *piOffsets, ChArc *pstArcs,
+	int *piStallOffsets, ChArc *pstStallArcs, int *vertex, int *distance)
+{
+	int i, nextVertex;
+
+	if (OK != pqRemoveMin(pstWorkspace->pstQueue, vertex, distance))
+	{
+		myLog(ERROR, "pqRemoveMin failed!");
+		return ERR;
+	}
+
+	pstWorkspace->pSettled[*vertex] = TRUE;
+	pstWorkspace->noOfSettled++;
+
+	for (i = piStallOffsets[*vertex]; i < piStallOffsets[*vertex + 1]; i++)
+	{
+		if (pstWorkspace->piDist[pstStallArcs[i].vertex] + pstStallArcs[i].distance < *distance)
+		{
+			return TRUE;
+		}
+	}
+
+	for (i = piOffsets[*vertex]; i < piOffsets[*vertex + 1]; i++)
+	{
+		nextVertex = pstArcs[i].vertex;
+		if ((FALSE == pstWorkspace->pSettled[nextVertex])
+			&& (OK != ssspRelax(pstWorkspace, nextVertex, *distance + pstArcs[i].distance)))
+		{
+			return ERR;
+		}
+	}
+
+	return FALSE;
+}
+
+/* Runs the backward upward search of every target and sorts what they settle into
+buckets: piOffsets[v] .. piOffsets[v + 1] of the returned entries are the bucket of v.
+piOffsets holds noOfVertex + 1 ints. Returns NULL on failure */
+ManyToManyBucketEntry* fillManyToManyBuckets(SsspWorkspace *pstWorkspace, ChGraph *pstGraph,
+	ManyToManyTable *pstTable, int *piOffsets)
+{
+	ManyToManyBucketEntry *pstEntries = NULL_PTR, *pstBuckets = NULL_PTR, *pstResized = NULL_PTR;
+	int *piVertices = NULL_PTR, *piResized = NULL_PTR;
+	long long noOfEntries = 0, capacity = 1024, i;
+	int j, vertex, distance, isStalled, retVal = OK;
+
+	pstEntries = (ManyToManyBucketEntry *)malloc(sizeof(ManyToManyBucketEntry) * capacity);
+	piVertices = (int *)malloc(sizeof(int) * capacity);
+
+	if ((NULL_PTR == pstEntries) || (NULL_PTR == piVertices))
+	{
+		retVal = ERR;
+	}
+
+	for (j = 0; (j < pstTable->noOfTargets) && (OK == retVal); j++)
+	{
+		resetSsspWorkspace(pstWorkspace);
+		retVal = ssspRelax(pstWorkspace, pstTable->piTargets[j], 0);
+
+		while ((OK == retVal) && (FALSE == pqIsEmpty(pstWorkspace->pstQueue)))
+		{
+			/* Backward: the downward arcs in reverse, stalled over the upward ones */
+			isStalled = mtmSettleNext(pstWorkspace, pstGraph->piDownOffsets, pstGraph->pstDownArcs,
+				pstGraph->piUpOffsets, pstGraph->pstUpArcs, &vertex, &distance);
+			if (FALSE != isStalled)
+			{
+				retVal = (TRUE == isStalled) ? OK : ERR;
+				continue;
+			}
+
+			if (noOfEntries == capacity)
+			{
+				capacity *= 2;
+				pstResized = (ManyToManyBucketEntry *)realloc(pstEntries, sizeof(ManyToManyBucketEntry) * capacity);
+				pstEntries = (NULL_PTR != pstResized) ? pstResized : pstEntries;
+				piResized = (int *)realloc(piVertices, sizeof(int) * capacity);
+				piVertices = (NULL_PTR != piResized) ? piResized : piVertices;
+				if ((NULL_PTR == pstResized) || (NULL_PTR == piResized))
+				{
+					myLog(ERROR, "realloc failed!");
+					retVal = ERR;
+					break;
+				}
+			}
+
+			pstEntries[noOfEntries].target = j;
+			pstEntries[noOfEntries].distance = distance;
+			piVertices[noOfEntries] = vertex;
+			noOfEntries++;
+		}
+
+		pstTable->noOfSettled += pstWorkspace->noOfSettled;
+	}
+
+	if (OK == retVal)
+	{
+		pstBuckets = (ManyToManyBucketEntry *)malloc(sizeof(ManyToManyBucketEntry) * MAX(noOfEntries, 1));
+	}
+
+	/* Counting sort by vertex */
+	if (NULL_PTR != pstBuckets)
+	{
+		(void)memset(piOffsets, 0, sizeof(int) * (pstGraph->noOfVertex + 1));
+		for (i = 0; i < noOfEntries; i++)
+		{
+			piOffsets[piVertices[i] + 1]++;
+		}
+
+		for (j = 0; j < pstGraph->noOfVertex; j++)
+		{
+			piOffsets[j + 1] += piOffsets[j];
+		}
+
+		for (i = 0; i < noOfEntries; i++)
+		{
+			pstBuckets[piOffsets[piVertices[i]]++] = pstEntries[i];
+		}
+
+		/* The fill moved every offset to the end of its bucket */
+		for (j = pstGraph->noOfVertex; j > 0; j--)
+		{
+			piOffsets[j] = piOffsets[j - 1];
+		}
+		piOffsets[0] = 0;
+
+		pstTable->noOfBucketEntries = noOfEntries;
+	}
+	else
+	{
+		myLog(ERROR, "Failed to fill the buckets of [%d] targets!", pstTable->noOfTargets);
+	}
+
+	free(pstEntries);
+	free(piVertices);
+
+	return pstBuckets;
+}
+
+/* Returns the largest entry of a row */
+int getManyToManyRowMax(int *piRow, int noOfTargets)
+{
+	int j, rowMax = 0;
+
+	for (j = 0; j < noOfTargets; j++)
+	{
+		rowMax = MAX(rowMax, piRow[j]);
+	}
+
+	return rowMax;
+}
+
+/* Fills the row of one source with a forward upward search which scans the bucket of
+every vertex it settles. Once every entry of the row is finite the search stops at the
+first vertex no closer than the largest entry, as no bucket further up can lower it */
+int fillManyToManyRow(SsspWorkspace *pstWorkspace, ChGraph *pstGraph, ManyToManyBucketEntry *pstBuckets,
+	int *piOffsets, int source, int *piRow, int noOfTargets)
+{
+	int i, j, vertex, distance, isStalled, noOfUnset = noOfTargets, rowMax = INFINITY;
+
+	for (j = 0; j < noOfTargets; j++)
+	{
+		piRow[j] = INFINITY;
+	}
+
+	resetSsspWorkspace(pstWorkspace);
+	if (OK != ssspRelax(pstWorkspace, source, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		isStalled = mtmSettleNext(pstWorkspace, pstGraph->piUpOffsets, pstGraph->pstUpArcs,
+			pstGraph->piDownOffsets, pstGraph->pstDownArcs, &vertex, &distance);
+		if (ERR == isStalled)
+		{
+			return ERR;
+		}
+
+		if (distance >= rowMax)
+		{
+			break;
+		}
+
+		if (TRUE == isStalled)
+		{
+			continue;
+		}
+
+		for (i = piOffsets[vertex]; i < piOffsets[vertex + 1]; i++)
+		{
+			j = pstBuckets[i].target;
+			if (distance + pstBuckets[i].distance >= piRow[j])
+			{
+				continue;
+			}
+
+			noOfUnset -= (INFINITY == piRow[j]);
+			piRow[j] = distance + pstBuckets[i].distance;
+
+			/* The bound only tightens when the largest entry drops */
+			if ((0 == noOfUnset) && ((INFINITY == rowMax) || (piRow[j] < rowMax)))
+			{
+				rowMax = getManyToManyRowMax(piRow, noOfTargets);
+			}
+		}
+	}
+
+	return OK;
+}
+
+/* Fills pstTable with the hierarchy in pstGraph, using the heap of scheme. Returns OK or
+ERR */
+int chManyToMany(int scheme, ChGraph *pstGraph, ManyToManyTable *pstTable)
+{
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	ManyToManyBucketEntry *pstBuckets = NULL_PTR;
+	int *piOffsets = NULL_PTR;
+	int i, retVal = OK;
+
+	pstTable->noOfBucketEntries = 0;
+	pstTable->noOfSettled = 0;
+
+	pstWorkspace = createSsspWorkspace(scheme, pstGraph->noOfVertex);
+	piOffsets = (int *)malloc(sizeof(int) * (pstGraph->noOfVertex + 1));
+
+	if ((NULL_PTR == pstWorkspace) || (NULL_PTR == piOffsets)
+		|| (NULL_PTR == (pstBuckets = fillManyToManyBuckets(pstWorkspace, pstGraph, pstTable, piOffsets))))
+	{
+		myLog(ERROR, "Failed to set up the buckets!");
+		retVal = ERR;
+	}
+
+	for (i = 0; (i < pstTable->noOfSources) && (OK == retVal); i++)
+	{
+		retVal = fillManyToManyRow(pstWorkspace, pstGraph, pstBuckets, piOffsets, pstTable->piSources[i],
+			pstTable->piDistances + ((long long)i * pstTable->noOfTargets), pstTable->noOfTargets);
+		pstTable->noOfSettled += pstWorkspace->noOfSettled;
+	}
+
+	free(pstBuckets);
+	free(piOffsets);
+	destroySsspWorkspace(pstWorkspace);
+
+	return retVal;
+}
+
+/* Writes the table as text: the targets, then one row per source, "-" for no path */
+int writeManyToManyTable(FILE *pFile, ManyToManyTable *pstTable)
+{
+	int i, j, distance;
+
+	fprintf(pFile, "     |\t");
+	for (j = 0; j < pstTable->noOfTargets; j++)
+	{
+		fprintf(pFile, "%d\t", pstTable->piTargets[j]);
+	}
+	fprintf(pFile, "\n");
+
+	for (i = 0; i < pstTable->noOfSources; i++)
+	{
+		fprintf(pFile, "%d   |\t", pstTable->piSources[i]);
+		for (j = 0; j < pstTable->noOfTargets; j++)
+		{
+			distance = pstTable->piDistances[((long long)i * pstTable->noOfTargets) + j];
+			if (INFINITY == distance)
+			{
+				fprintf(pFile, "-\t");
+			}
+			else
+			{
+				fprintf(pFile, "%d\t", distance);
+			}
+		}
+		fprintf(pFile, "\n");
+	}
+
+	return (0 == ferror(pFile)) ? OK : ERR;
+}
+
+/* Checks the first rows of the table against full Dijkstra rows. Returns the number of
+wrong entries, ERR on failure */
+int checkManyToManyTable(int scheme, AdjList *pstAdjList, ManyToManyTable *pstTable)
+{
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int i, j, noOfWrong = 0;
+
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+		return ERR;
+	}
+
+	for (i = 0; (i < pstTable->noOfSources) && (i < MTM_CHECKED_SOURCES); i++)
+	{
+		if (OK != ssspComputeRow(pstWorkspace, pstAdjList, pstTable->piSources[i]))
+		{
+			noOfWrong = ERR;
+			break;
+		}
+
+		for (j = 0; j < pstTable->noOfTargets; j++)
+		{
+			noOfWrong += (pstWorkspace->piDist[pstTable->piTargets[j]]
+				!= pstTable->piDistances[((long long)i * pstTable->noOfTargets) + j]);
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+
+	return noOfWrong;
+}
+
+/* Entry function for many to many mode. Computes the table between random sets of
+noOfSources sources and noOfTargets targets on the hierarchy stored in the binary graph
+file fileName. outName is "-" for stdout or a file name for the table */
+int manyToManyProc(int scheme, char *fileName, char *sourcesArg, char *targetsArg, char *outName)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	GraphFile *pstGraphFile = NULL_PTR;
+	ManyToManyTable *pstTable = NULL_PTR;
+	ChGraph stGraph;
+	FILE *pFile = NULL_PTR;
+	void *pSection = NULL_PTR;
+	int *piSources = NULL_PTR, *piTargets = NULL_PTR;
+	long long size, startTime, tableMsec;
+	int i, noOfSources, noOfTargets, noOfWrong, retVal = ERR;
+
+	noOfSources = atoi(sourcesArg);
+	noOfTargets = (NULL_PTR != targetsArg) ? atoi(targetsArg) : noOfSources;
+
+	if ((noOfSources <= 0) || (noOfTargets <= 0))
+	{
+		myLog(ERROR, "Invalid Input! Sources and targets must be positive");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR != pstGraphFile)
+	{
+		pSection = getGraphFileSection(pstGraphFile, GRAPH_SECTION_CH, &size);
+	}
+
+	piSources = (int *)malloc(sizeof(int) * noOfSources);
+	piTargets = (int *)malloc(sizeof(int) * noOfTargets);
+
+	if ((NULL_PTR == pSection) || (OK != attachChGraph(&stGraph, pSection, size, gNoOfVertex)))
+	{
+		myLog(ERROR, "[%s] has no usable hierarchy! Run -hp on it first", fileName);
+	}
+	else if ((NULL_PTR == piSources) || (NULL_PTR == piTargets))
+	{
+		myLog(ERROR, "malloc failed!");
+	}
+	else
+	{
+		srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+		for (i = 0; i < noOfSources; i++)
+		{
+			piSources[i] = rand() % gNoOfVertex;
+		}
+
+		for (i = 0; i < noOfTargets; i++)
+		{
+			piTargets[i] = rand() % gNoOfVertex;
+		}
+
+		pstTable = createManyToManyTable(piSources, noOfSources, piTargets, noOfTargets);
+	}
+
+	if (NULL_PTR != pstTable)
+	{
+		startTime = getWallTimeMsec();
+		retVal = chManyToMany(scheme, &stGraph, pstTable);
+		tableMsec = getWallTimeMsec() - startTime;
+	}
+
+	if ((OK == retVal) && (NULL_PTR != outName))
+	{
+		pFile = (0 == strcmp(outName, ROW_SINK_STDOUT_NAME)) ? stdout : fopen(outName, "w");
+		if ((NULL_PTR == pFile) || (OK != writeManyToManyTable(pFile, pstTable)))
+		{
+			myLog(ERROR, "Could not write the table to [%s]!", outName);
+			retVal = ERR;
+		}
+
+		if ((NULL_PTR != pFile) && (stdout != pFile))
+		{
+			fclose(pFile);
+		}
+	}
+
+	if (OK == retVal)
+	{
+		noOfWrong = checkManyToManyTable(scheme, pstAdjList, pstTable);
+
+		printf("\n%s: [%d] x [%d] table in [%lld] msec\n"
+			"Bucket entries: [%lld], settled: [%lld], [%d] wrong in the first [%d] rows\n",
+			schemeString[scheme], noOfSources, noOfTargets, tableMsec,
+			pstTable->noOfBucketEntries, pstTable->noOfSettled, noOfWrong, MIN(noOfSources, MTM_CHECKED_SOURCES));
+
+		if (0 != noOfWrong)
+		{
+			myLog(ERROR, "checkManyToManyTable failed!");
+			retVal = ERR;
+		}
+	}
+
+	destroyManyToManyTable(pstTable);
+	free(piSources);
+	free(piTargets);
+	closeGraphFile(pstGraphFile);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
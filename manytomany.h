@@ -0,0 +1,34 @@
+/***************************************************************************************************/
+// MANYTOMANY.H
+// Contains the distance table of the many to many mode
+/***************************************************************************************************/
+
+#ifndef __MANYTOMANY__
+#define __MANYTOMANY__
+
+#include "ch.h"
+
+#define MTM_CHECKED_SOURCES 10 // Rows checked against a full Dijkstra
+
+/* An |S| x |T| table. piDistances[(i * noOfTargets) + j] is the distance from
+piSources[i] to piTargets[j], INFINITY if there is no path */
+typedef struct ManyToManyTable
+{
+	int noOfSources;
+	int noOfTargets;
+	int *piSources;
+	int *piTargets;
+	int *piDistances;
+	long long noOfBucketEntries; // Stats of the last computation
+	long long noOfSettled;
+}ManyToManyTable;
+
+/* Entry of the bucket of a vertex v: a target which reaches v upward in the hierarchy
+and the distance from v to it */
+typedef struct ManyToManyBucketEntry
+{
+	int target; // Index into piTargets
+	int distance;
+}ManyToManyBucketEntry;
+
+#endif
@@ -0,0 +1,378 @@
+/***************************************************************************************************/
+// MST.C
+// Contains all functions for the minimum spanning tree mode. Prim runs on each of the heaps
+// through the priority queue, and Kruskal with union-find is the baseline
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pq.h"
+#include "mst.h"
+
+extern int gNoOfVertex;
+extern int gGraphDensity;
+extern char *schemeString[TOTAL_SCHEMES];
+extern int aValidVertices[MAX_VALID_VERTICES];
+extern int aValidDensities[MAX_VALID_DENSITIES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern AdjList* getRandomAdjList();
+extern AdjList* buildUndirectedAdjList(AdjList *pstAdjList);
+extern PQueue* createPQueue(int scheme, int noOfVertex);
+extern long long getWallTimeUsec();
+
+//Output for spanning tree mode, average usec of each run
+int gMstModeOutput[TOTAL_MST_RUNS][MAX_VALID_VERTICES][MAX_VALID_DENSITIES];
+//Decrease keys of Prim per 100 inserts, which does not depend on the heap
+int gMstDecreaseOutput[MAX_VALID_VERTICES][MAX_VALID_DENSITIES];
+char *mstRunString[TOTAL_MST_RUNS] = {"PRIM BINARY SCHEME", "PRIM BINOMIAL SCHEME", "PRIM FIBONACCI SCHEME",
+	"KRUSKAL UNION-FIND"};
+
+/* Prim over the undirected graph. The key of a queued vertex is its lightest edge to the
+tree, so an edge which beats it is a decrease key. Every unreached vertex starts a new tree,
+which gives a spanning forest. pInTree must be all FALSE. Returns OK or ERR */
+int runPrim(PQueue *pstQueue, AdjList *pstUndirected, char *pInTree, MstStats *pstStats)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	long long startTime;
+	int root, vertex, key, nextVertex, wasQueued, retVal;
+
+	(void)memset(pstStats, 0, sizeof(MstStats));
+	pqClear(pstQueue);
+
+	startTime = getWallTimeUsec();
+
+	for (root = 0; root < gNoOfVertex; root++)
+	{
+		if (TRUE == pInTree[root])
+		{
+			continue;
+		}
+
+		pstStats->noOfComponents++;
+		if (OK != pqInsert(pstQueue, root, 0))
+		{
+			return ERR;
+		}
+		pstStats->noOfInserts++;
+
+		while (FALSE == pqIsEmpty(pstQueue))
+		{
+			if (OK != pqRemoveMin(pstQueue, &vertex, &key))
+			{
+				myLog(ERROR, "pqRemoveMin failed!");
+				return ERR;
+			}
+
+			pInTree[vertex] = TRUE;
+			pstStats->noOfRemoves++;
+			pstStats->weight += key;
+			pstStats->noOfTreeEdges += (vertex != root);
+
+			for (pstTraverser = pstUndirected[vertex].next; NULL_PTR != pstTraverser;
+				pstTraverser = pstTraverser->next)
+			{
+				nextVertex = pstTraverser->vertexNum;
+				if (TRUE == pInTree[nextVertex])
+				{
+					continue;
+				}
+
+				wasQueued = pqIsInQueue(pstQueue, nextVertex);
+				retVal = pqUpdate(pstQueue, nextVertex, pstTraverser->distance);
+				if (ERR == retVal)
+				{
+					myLog(ERROR, "pqUpdate failed for vertex [%d]!", nextVertex);
+					return ERR;
+				}
+
+				if (TRUE == retVal)
+				{
+					pstStats->noOfInserts += (FALSE == wasQueued);
+					pstStats->noOfDecreases += (TRUE == wasQueued);
+				}
+			}
+		}
+	}
+
+	pstStats->timeUsec = getWallTimeUsec() - startTime;
+
+	return OK;
+}
+
+/* Orders the edges by cost for Kruskal */
+int compareMstEdges(const void *pFirst, const void *pSecond)
+{
+	return ((MstEdge *)pFirst)->distance - ((MstEdge *)pSecond)->distance;
+}
+
+/* Root of the set of vertex. Halves the path on the way up */
+int findMstSet(int *piParent, int vertex, long long *pllFinds)
+{
+	(*pllFinds)++;
+
+	while (piParent[vertex] != vertex)
+	{
+		piParent[vertex] = piParent[piParent[vertex]];
+		vertex = piParent[vertex];
+	}
+
+	return vertex;
+}
+
+/* Kruskal over the undirected graph: every edge once, by cost, joining two sets of the
+union-find by rank. pstEdges must hold every edge of pstUndirected. Returns OK */
+int runKruskal(AdjList *pstUndirected, MstEdge *pstEdges, int *piParent, int *piRank,
+	MstStats *pstStats)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	long long startTime;
+	int i, root1, root2, noOfEdges = 0;
+
+	(void)memset(pstStats, 0, sizeof(MstStats));
+
+	startTime = getWallTimeUsec();
+
+	/* Each edge is in both lists, take it from the smaller end */
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		piParent[i] = i;
+		piRank[i] = 0;
+
+		for (pstTraverser = pstUndirected[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			if (i < pstTraverser->vertexNum)
+			{
+				pstEdges[noOfEdges].vertex1 = i;
+				pstEdges[noOfEdges].vertex2 = pstTraverser->vertexNum;
+				pstEdges[noOfEdges].distance = pstTraverser->distance;
+				noOfEdges++;
+			}
+		}
+	}
+
+	qsort(pstEdges, noOfEdges, sizeof(MstEdge), compareMstEdges);
+	pstStats->noOfInserts = noOfEdges;
+
+	for (i = 0; (i < noOfEdges) && (pstStats->noOfTreeEdges < gNoOfVertex - 1); i++)
+	{
+		root1 = findMstSet(piParent, pstEdges[i].vertex1, &pstStats->noOfDecreases);
+		root2 = findMstSet(piParent, pstEdges[i].vertex2, &pstStats->noOfDecreases);
+		if (root1 == root2)
+		{
+			continue;
+		}
+
+		if (piRank[root1] < piRank[root2])
+		{
+			piParent[root1] = root2;
+		}
+		else
+		{
+			piParent[root2] = root1;
+			piRank[root1] += (piRank[root1] == piRank[root2]);
+		}
+
+		pstStats->weight += pstEdges[i].distance;
+		pstStats->noOfTreeEdges++;
+	}
+
+	pstStats->timeUsec = getWallTimeUsec() - startTime;
+	pstStats->noOfComponents = gNoOfVertex - pstStats->noOfTreeEdges;
+
+	return OK;
+}
+
+/* Runs Prim on each heap and Kruskal MAX_SCHEME_RUNS times over the graph, which is treated
+as undirected. pstStats gets the last run of each with the average time. Returns ERR if a
+run fails or the trees do not weigh the same */
+int runMstSchemes(AdjList *pstAdjList, MstStats *pstStats)
+{
+	AdjList *pstUndirected = NULL_PTR, *pstTraverser = NULL_PTR;
+	PQueue *pstQueue = NULL_PTR;
+	MstEdge *pstEdges = NULL_PTR;
+	char *pInTree = NULL_PTR;
+	int *piParent = NULL_PTR, *piRank = NULL_PTR;
+	long long totalUsec;
+	int i, scheme, run, noOfEdges = 0, retVal = OK;
+
+	pstUndirected = buildUndirectedAdjList(pstAdjList);
+	if (NULL_PTR == pstUndirected)
+	{
+		myLog(ERROR, "buildUndirectedAdjList failed!");
+		return ERR;
+	}
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		for (pstTraverser = pstUndirected[i].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			noOfEdges++;
+		}
+	}
+
+	pInTree = (char *)malloc(sizeof(char) * gNoOfVertex);
+	pstEdges = (MstEdge *)malloc(sizeof(MstEdge) * (noOfEdges / 2 + 1));
+	piParent = (int *)malloc(sizeof(int) * gNoOfVertex);
+	piRank = (int *)malloc(sizeof(int) * gNoOfVertex);
+
+	if ((NULL_PTR == pInTree) || (NULL_PTR == pstEdges) || (NULL_PTR == piParent) || (NULL_PTR == piRank))
+	{
+		myLog(ERROR, "malloc failed!");
+		retVal = ERR;
+	}
+
+	for (scheme = 0; (scheme < TOTAL_MST_RUNS) && (OK == retVal); scheme++)
+	{
+		if (KRUSKAL_RUN != scheme)
+		{
+			pstQueue = createPQueue(scheme, gNoOfVertex);
+			if (NULL_PTR == pstQueue)
+			{
+				myLog(ERROR, "createPQueue failed!");
+				retVal = ERR;
+				break;
+			}
+		}
+
+		totalUsec = 0;
+		for (run = 0; (run < MAX_SCHEME_RUNS) && (OK == retVal); run++)
+		{
+			if (KRUSKAL_RUN == scheme)
+			{
+				retVal = runKruskal(pstUndirected, pstEdges, piParent, piRank, &pstStats[scheme]);
+			}
+			else
+			{
+				(void)memset(pInTree, FALSE, sizeof(char) * gNoOfVertex);
+				retVal = runPrim(pstQueue, pstUndirected, pInTree, &pstStats[scheme]);
+			}
+			totalUsec += pstStats[scheme].timeUsec;
+		}
+		pstStats[scheme].timeUsec = totalUsec / MAX_SCHEME_RUNS;
+
+		destroyPQueue(pstQueue);
+		pstQueue = NULL_PTR;
+
+		if ((OK == retVal) && (pstStats[scheme].weight != pstStats[0].weight))
+		{
+			myLog(ERROR, "%s found weight [%lld], %s [%lld]!", mstRunString[scheme],
+				pstStats[scheme].weight, mstRunString[0], pstStats[0].weight);
+			retVal = ERR;
+		}
+	}
+
+	free(pInTree);
+	free(pstEdges);
+	free(piParent);
+	free(piRank);
+	destroyAdjList(pstUndirected);
+
+	return retVal;
+}
+
+/* Prints a matrix over the random graph grid */
+void printMstMatrix(char *title, int aMatrix[MAX_VALID_VERTICES][MAX_VALID_DENSITIES])
+{
+	int i, j;
+
+	printf("\n\t\t\t\t--- %s ----\n", title);
+
+	printf("\t");
+	for (j = 0; j < MAX_VALID_DENSITIES; j++)
+	{
+		printf("%d\t", aValidDensities[j]);
+	}
+
+	for (i = 0; i < MAX_VALID_VERTICES; i++)
+	{
+		printf("\n%d\t", aValidVertices[i]);
+		for (j = 0; j < MAX_VALID_DENSITIES; j++)
+		{
+			printf("[%d]\t", aMatrix[i][j]);
+		}
+	}
+	printf("\n");
+}
+
+/* Entry function for spanning tree mode. With a file its graph is used, otherwise the
+random graphs of random mode. Prints the time of Prim on each heap and of Kruskal */
+int mstProc(char *fileName)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	MstStats astStats[TOTAL_MST_RUNS];
+	int i, j, run;
+
+	if (NULL_PTR != fileName)
+	{
+		pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+		if (NULL_PTR == pstAdjList)
+		{
+			myLog(ERROR, "loadAdjListFromFile failed!");
+			return ERR;
+		}
+
+		if (OK != runMstSchemes(pstAdjList, astStats))
+		{
+			destroyAdjList(pstAdjList);
+			return ERR;
+		}
+
+		printf("\nWeight: [%lld], [%d] tree edges, [%d] components, average of [%d] runs\n",
+			astStats[0].weight, astStats[0].noOfTreeEdges, astStats[0].noOfComponents, MAX_SCHEME_RUNS);
+		for (run = 0; run < KRUSKAL_RUN; run++)
+		{
+			printf("%s: [%lld] usec, [%lld] inserts, [%lld] decrease keys, [%lld] remove mins\n",
+				mstRunString[run], astStats[run].timeUsec, astStats[run].noOfInserts,
+				astStats[run].noOfDecreases, astStats[run].noOfRemoves);
+		}
+		printf("%s: [%lld] usec, [%lld] edges sorted, [%lld] finds\n", mstRunString[KRUSKAL_RUN],
+			astStats[KRUSKAL_RUN].timeUsec, astStats[KRUSKAL_RUN].noOfInserts,
+			astStats[KRUSKAL_RUN].noOfDecreases);
+
+		destroyAdjList(pstAdjList);
+
+		return OK;
+	}
+
+	/* Same grid as random mode */
+	for (i = 0; i < MAX_VALID_VERTICES; i++)
+	{
+		for (j = 0; j < MAX_VALID_DENSITIES; j++)
+		{
+			gNoOfVertex = aValidVertices[i];
+			gGraphDensity = aValidDensities[j];
+
+			pstAdjList = getRandomAdjList();
+			if (NULL_PTR == pstAdjList)
+			{
+				myLog(ERROR, "getRandomAdjList failed!");
+				return ERR;
+			}
+
+			if (OK != runMstSchemes(pstAdjList, astStats))
+			{
+				destroyAdjList(pstAdjList);
+				return ERR;
+			}
+
+			for (run = 0; run < TOTAL_MST_RUNS; run++)
+			{
+				gMstModeOutput[run][i][j] = (int)astStats[run].timeUsec;
+			}
+			gMstDecreaseOutput[i][j] = (int)((100 * astStats[0].noOfDecreases) / MAX(astStats[0].noOfInserts, 1));
+
+			destroyAdjList(pstAdjList);
+		}
+	}
+
+	for (run = 0; run < TOTAL_MST_RUNS; run++)
+	{
+		printMstMatrix(mstRunString[run], gMstModeOutput[run]);
+	}
+	printMstMatrix("PRIM DECREASE KEYS PER 100 INSERTS", gMstDecreaseOutput);
+
+	return OK;
+}
@@ -0,0 +1,35 @@
+/***************************************************************************************************/
+// MST.H
+// Contains the results of the minimum spanning tree mode
+/***************************************************************************************************/
+
+#ifndef __MST__
+#define __MST__
+
+#include "header.h"
+
+#define KRUSKAL_RUN TOTAL_SCHEMES // Prim has one run per scheme, Kruskal comes after them
+#define TOTAL_MST_RUNS (TOTAL_SCHEMES + 1)
+
+/* One run over one graph. For Prim the heap operations are counted, for Kruskal the
+edges sorted and the finds */
+typedef struct MstStats
+{
+	long long weight;
+	int noOfTreeEdges;
+	int noOfComponents;
+	long long noOfInserts; // Kruskal: edges sorted
+	long long noOfDecreases; // Kruskal: finds
+	long long noOfRemoves;
+	long long timeUsec;
+}MstStats;
+
+/* An edge of the undirected graph, for Kruskal */
+typedef struct MstEdge
+{
+	int vertex1;
+	int vertex2;
+	int distance;
+}MstEdge;
+
+#endif
@@ -0,0 +1,1051 @@
+/***************************************************************************************************/
+// OVERLAY.C
+// Contains all functions of the multi-level overlay search: the nested partition, the
+// customization of the cell cliques in parallel, weight updates which only customize the
+// cells they touch and the query over the overlay
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "arcflags.h"
+#include "overlay.h"
+#include "sssp.h"
+#include "stream.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern GraphFile* openGraphFile(char *fileName);
+extern void* getGraphFileSection(GraphFile *pstGraphFile, int tag, long long *size);
+extern long long getWallTimeMsec();
+extern long long getWallTimeUsec();
+
+/* Shared by the workers customizing the dirty cells of one level */
+typedef struct OverlayCustomizeCtx
+{
+	OverlayGraph *pstOverlay;
+	int scheme;
+	int level;
+	int *piJobs; // Dirty cells of the level
+	int noOfJobs;
+	volatile int nextJob; // Next cell to hand out
+	volatile int hasFailed;
+}OverlayCustomizeCtx;
+
+/* Splits every cell of the level above (piParentCells, NULL for a single top cell) into
+fanout cells grown breadth first from random members, ignoring the edge directions and
+never leaving the parent. Members no seed reaches start cells of their own. The child
+cells of parent p are numbered p * fanout to p * fanout + fanout - 1 */
+int partitionOverlayLevel(ArcFlagGraph *pstGraph, int *piParentCells, int noOfParentCells,
+	int fanout, int *piCells)
+{
+	int *piMembers = NULL_PTR, *piMemberOffsets = NULL_PTR, *piQueue = NULL_PTR;
+	int i, p, u, v, e, vertex, parent, head, tail, nextChild, retVal = OK;
+
+	piMembers = (int *)malloc(sizeof(int) * pstGraph->noOfVertex);
+	piMemberOffsets = (int *)calloc(noOfParentCells + 1, sizeof(int));
+	piQueue = (int *)malloc(sizeof(int) * pstGraph->noOfVertex);
+
+	if ((NULL_PTR == piMembers) || (NULL_PTR == piMemberOffsets) || (NULL_PTR == piQueue))
+	{
+		myLog(ERROR, "Failed to allocate the partition of [%d] vertices!", pstGraph->noOfVertex);
+		retVal = ERR;
+	}
+	else
+	{
+		/* Group the vertices by parent cell */
+		for (v = 0; v < pstGraph->noOfVertex; v++)
+		{
+			piMemberOffsets[((NULL_PTR == piParentCells) ? 0 : piParentCells[v]) + 1]++;
+			piCells[v] = -1;
+		}
+
+		for (p = 0; p < noOfParentCells; p++)
+		{
+			piMemberOffsets[p + 1] += piMemberOffsets[p];
+		}
+
+		for (v = 0; v < pstGraph->noOfVertex; v++)
+		{
+			parent = (NULL_PTR == piParentCells) ? 0 : piParentCells[v];
+			piMembers[piMemberOffsets[parent]++] = v;
+		}
+
+		for (p = noOfParentCells; p > 0; p--)
+		{
+			piMemberOffsets[p] = piMemberOffsets[p - 1];
+		}
+		piMemberOffsets[0] = 0;
+	}
+
+	for (p = 0; (p < noOfParentCells) && (OK == retVal); p++)
+	{
+		if (piMemberOffsets[p] == piMemberOffsets[p + 1])
+		{
+			continue;
+		}
+
+		head = 0;
+		tail = 0;
+		nextChild = 0;
+
+		for (i = 0; i < fanout; i++)
+		{
+			vertex = piMembers[piMemberOffsets[p]
+				+ (rand() % (piMemberOffsets[p + 1] - piMemberOffsets[p]))];
+			if (-1 == piCells[vertex])
+			{
+				piCells[vertex] = (p * fanout) + (nextChild++ % fanout);
+				piQueue[tail++] = vertex;
+			}
+		}
+
+		for (i = piMemberOffsets[p]; i < piMemberOffsets[p + 1]; i++)
+		{
+			if (-1 == piCells[piMembers[i]])
+			{
+				piCells[piMembers[i]] = (p * fanout) + (nextChild++ % fanout);
+				piQueue[tail++] = piMembers[i];
+			}
+
+			while (head < tail)
+			{
+				u = piQueue[head++];
+
+				for (e = pstGraph->piOffsets[u]; e < pstGraph->piOffsets[u + 1]; e++)
+				{
+					v = pstGraph->pstEdges[e].vertexNum;
+					if ((-1 == piCells[v])
+						&& ((NULL_PTR == piParentCells) || (piParentCells[v] == p)))
+					{
+						piCells[v] = piCells[u];
+						piQueue[tail++] = v;
+					}
+				}
+
+				for (e = pstGraph->piReverseOffsets[u]; e < pstGraph->piReverseOffsets[u + 1]; e++)
+				{
+					v = pstGraph->piTails[pstGraph->piReverseEdges[e]];
+					if ((-1 == piCells[v])
+						&& ((NULL_PTR == piParentCells) || (piParentCells[v] == p)))
+					{
+						piCells[v] = piCells[u];
+						piQueue[tail++] = v;
+					}
+				}
+			}
+		}
+	}
+
+	free(piMembers);
+	free(piMemberOffsets);
+	free(piQueue);
+
+	return retVal;
+}
+
+/* Returns an overlay section with noOfLevels nested levels, each cell split into fanout
+cells of the level below, its length in size. The reverse graph of pstGraph must be
+built. The caller frees it. NULL on failure */
+void* buildOverlaySection(ArcFlagGraph *pstGraph, int noOfLevels, int fanout, long long *size)
+{
+	OverlaySectionHeader *pstHeader = NULL_PTR;
+	int *piCells = NULL_PTR, *piParentCells = NULL_PTR;
+	int level, noOfParentCells = 1;
+
+	*size = OVERLAY_SECTION_SIZE(noOfLevels, pstGraph->noOfVertex);
+	pstHeader = (OverlaySectionHeader *)calloc(1, (size_t)*size);
+	if (NULL_PTR == pstHeader)
+	{
+		myLog(ERROR, "Failed to allocate [%lld] bytes of partition!", *size);
+		return NULL_PTR;
+	}
+
+	pstHeader->noOfLevels = noOfLevels;
+	pstHeader->noOfVertex = pstGraph->noOfVertex;
+
+	/* Top down, so that every level refines the one above */
+	for (level = noOfLevels - 1; level >= 0; level--)
+	{
+		piCells = (int *)(pstHeader + 1) + ((long long)level * pstGraph->noOfVertex);
+
+		if (OK != partitionOverlayLevel(pstGraph, piParentCells, noOfParentCells, fanout, piCells))
+		{
+			free(pstHeader);
+			return NULL_PTR;
+		}
+
+		pstHeader->aNoOfCells[level] = noOfParentCells * fanout;
+		noOfParentCells = pstHeader->aNoOfCells[level];
+		piParentCells = piCells;
+	}
+
+	return pstHeader;
+}
+
+/* Frees what the overlay allocated. The mapped topology and partition stay */
+void destroyOverlayGraph(OverlayGraph *pstOverlay)
+{
+	OverlayLevel *pstLevel = NULL_PTR;
+	int level;
+
+	for (level = 0; level < MAX_OVERLAY_LEVELS; level++)
+	{
+		pstLevel = &pstOverlay->astLevels[level];
+		free(pstLevel->piBoundaryOffsets);
+		free(pstLevel->piBoundary);
+		free(pstLevel->piBoundaryIndex);
+		free(pstLevel->pllCliqueOffsets);
+		free(pstLevel->piCliques);
+		free(pstLevel->pDirty);
+	}
+
+	free(pstOverlay->piWeights);
+	memset(pstOverlay, 0, sizeof(OverlayGraph));
+}
+
+/* Finds the boundary vertices of every cell of a level and allocates the cliques. Every
+cell starts dirty */
+int buildOverlayLevel(OverlayGraph *pstOverlay, OverlayLevel *pstLevel)
+{
+	int *piFill = NULL_PTR;
+	int c, u, v, e, noOfBoundary = 0;
+	long long noOfEntries = 0;
+
+	pstLevel->piBoundaryOffsets = (int *)calloc(pstLevel->noOfCells + 1, sizeof(int));
+	pstLevel->piBoundaryIndex = (int *)malloc(sizeof(int) * pstOverlay->noOfVertex);
+	pstLevel->pllCliqueOffsets = (long long *)malloc(sizeof(long long) * (pstLevel->noOfCells + 1));
+	pstLevel->pDirty = (char *)malloc(sizeof(char) * pstLevel->noOfCells);
+	piFill = (int *)malloc(sizeof(int) * pstLevel->noOfCells);
+
+	if ((NULL_PTR == pstLevel->piBoundaryOffsets) || (NULL_PTR == pstLevel->piBoundaryIndex)
+		|| (NULL_PTR == pstLevel->pllCliqueOffsets) || (NULL_PTR == pstLevel->pDirty)
+		|| (NULL_PTR == piFill))
+	{
+		myLog(ERROR, "Failed to allocate a level of [%d] cells!", pstLevel->noOfCells);
+		free(piFill);
+		return ERR;
+	}
+
+	/* piBoundaryIndex marks the boundary vertices first */
+	for (v = 0; v < pstOverlay->noOfVertex; v++)
+	{
+		pstLevel->piBoundaryIndex[v] = -1;
+	}
+
+	for (u = 0; u < pstOverlay->noOfVertex; u++)
+	{
+		for (e = pstOverlay->piOffsets[u]; e < pstOverlay->piOffsets[u + 1]; e++)
+		{
+			v = pstOverlay->pstEdges[e].vertexNum;
+			if (pstLevel->piCells[u] != pstLevel->piCells[v])
+			{
+				pstLevel->piBoundaryIndex[u] = 0;
+				pstLevel->piBoundaryIndex[v] = 0;
+			}
+		}
+	}
+
+	for (v = 0; v < pstOverlay->noOfVertex; v++)
+	{
+		if (-1 != pstLevel->piBoundaryIndex[v])
+		{
+			pstLevel->piBoundaryOffsets[pstLevel->piCells[v] + 1]++;
+			noOfBoundary++;
+		}
+	}
+
+	pstLevel->pllCliqueOffsets[0] = 0;
+	for (c = 0; c < pstLevel->noOfCells; c++)
+	{
+		noOfEntries += (long long)pstLevel->piBoundaryOffsets[c + 1] * pstLevel->piBoundaryOffsets[c + 1];
+		pstLevel->pllCliqueOffsets[c + 1] = noOfEntries;
+		pstLevel->piBoundaryOffsets[c + 1] += pstLevel->piBoundaryOffsets[c];
+		piFill[c] = pstLevel->piBoundaryOffsets[c];
+		pstLevel->pDirty[c] = TRUE;
+	}
+
+	pstLevel->piBoundary = (int *)malloc(sizeof(int) * (noOfBoundary + 1));
+	pstLevel->piCliques = (int *)malloc(sizeof(int) * (noOfEntries + 1));
+	if ((NULL_PTR == pstLevel->piBoundary) || (NULL_PTR == pstLevel->piCliques))
+	{
+		myLog(ERROR, "Failed to allocate [%lld] clique entries!", noOfEntries);
+		free(piFill);
+		return ERR;
+	}
+
+	for (v = 0; v < pstOverlay->noOfVertex; v++)
+	{
+		if (-1 != pstLevel->piBoundaryIndex[v])
+		{
+			c = pstLevel->piCells[v];
+			pstLevel->piBoundaryIndex[v] = piFill[c] - pstLevel->piBoundaryOffsets[c];
+			pstLevel->piBoundary[piFill[c]++] = v;
+		}
+	}
+
+	free(piFill);
+
+	return OK;
+}
+
+/* Checks the partition of an overlay section before it is used as an index: every level has
+cells, every cell id is in range, no level has more cells than the one below it and each
+cell of level l - 1 lies inside one cell of level l. Returns OK or ERR */
+int checkOverlayCells(OverlaySectionHeader *pstHeader)
+{
+	int *piCells = (int *)(pstHeader + 1), *piBelow = NULL_PTR, *piParent = NULL_PTR;
+	int level, v, cell, retVal = OK;
+
+	for (level = 0; (level < pstHeader->noOfLevels) && (OK == retVal); level++)
+	{
+		if ((pstHeader->aNoOfCells[level] <= 0)
+			|| ((level > 0) && (pstHeader->aNoOfCells[level] > pstHeader->aNoOfCells[level - 1])))
+		{
+			retVal = ERR;
+			break;
+		}
+
+		for (v = 0; v < pstHeader->noOfVertex; v++)
+		{
+			cell = piCells[((long long)level * pstHeader->noOfVertex) + v];
+			if ((cell < 0) || (cell >= pstHeader->aNoOfCells[level]))
+			{
+				retVal = ERR;
+				break;
+			}
+		}
+
+		if ((OK != retVal) || (0 == level))
+		{
+			continue;
+		}
+
+		/* piParent[c] is the cell of this level that holds cell c of the level below */
+		piBelow = piCells + ((long long)(level - 1) * pstHeader->noOfVertex);
+		piParent = (int *)malloc(sizeof(int) * pstHeader->aNoOfCells[level - 1]);
+		if (NULL_PTR == piParent)
+		{
+			myLog(ERROR, "malloc failed!");
+			return ERR;
+		}
+
+		for (cell = 0; cell < pstHeader->aNoOfCells[level - 1]; cell++)
+		{
+			piParent[cell] = -1;
+		}
+
+		for (v = 0; v < pstHeader->noOfVertex; v++)
+		{
+			cell = piCells[((long long)level * pstHeader->noOfVertex) + v];
+			if (-1 == piParent[piBelow[v]])
+			{
+				piParent[piBelow[v]] = cell;
+			}
+			else if (cell != piParent[piBelow[v]])
+			{
+				retVal = ERR;
+				break;
+			}
+		}
+
+		free(piParent);
+	}
+
+	return retVal;
+}
+
+/* Loads the overlay of an opened graph file: the CSR, a copy of the weights and the
+boundaries of every level. The cliques still have to be customized */
+int loadOverlayGraph(OverlayGraph *pstOverlay, GraphFile *pstGraphFile)
+{
+	OverlaySectionHeader *pstHeader = NULL_PTR;
+	long long size = 0;
+	int e, level;
+
+	memset(pstOverlay, 0, sizeof(OverlayGraph));
+
+	pstOverlay->noOfVertex = pstGraphFile->pstHeader->noOfVertex;
+	pstOverlay->noOfEdges = pstGraphFile->pstHeader->noOfEdges;
+	pstOverlay->piOffsets = (int *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_OFFSETS, NULL_PTR);
+	pstOverlay->pstEdges = (GraphFileEdge *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_EDGES, NULL_PTR);
+	pstHeader = (OverlaySectionHeader *)getGraphFileSection(pstGraphFile, GRAPH_SECTION_OVERLAY, &size);
+
+	if ((NULL_PTR == pstOverlay->piOffsets) || (NULL_PTR == pstOverlay->pstEdges)
+		|| (NULL_PTR == pstHeader) || (size < (long long)sizeof(OverlaySectionHeader))
+		|| (pstHeader->noOfLevels <= 0) || (pstHeader->noOfLevels > MAX_OVERLAY_LEVELS)
+		|| (pstHeader->noOfVertex != pstOverlay->noOfVertex)
+		|| (size != OVERLAY_SECTION_SIZE(pstHeader->noOfLevels, pstHeader->noOfVertex))
+		|| (OK != checkOverlayCells(pstHeader)))
+	{
+		myLog(ERROR, "Overlay section does not match the graph!");
+		return ERR;
+	}
+
+	pstOverlay->noOfLevels = pstHeader->noOfLevels;
+
+	pstOverlay->piWeights = (int *)malloc(sizeof(int) * (pstOverlay->noOfEdges + 1));
+	if (NULL_PTR == pstOverlay->piWeights)
+	{
+		myLog(ERROR, "malloc failed!");
+		return ERR;
+	}
+
+	for (e = 0; e < pstOverlay->noOfEdges; e++)
+	{
+		pstOverlay->piWeights[e] = pstOverlay->pstEdges[e].distance;
+	}
+
+	for (level = 0; level < pstOverlay->noOfLevels; level++)
+	{
+		pstOverlay->astLevels[level].noOfCells = pstHeader->aNoOfCells[level];
+		pstOverlay->astLevels[level].piCells = (int *)(pstHeader + 1)
+			+ ((long long)level * pstOverlay->noOfVertex);
+
+		if (OK != buildOverlayLevel(pstOverlay, &pstOverlay->astLevels[level]))
+		{
+			destroyOverlayGraph(pstOverlay);
+			return ERR;
+		}
+	}
+
+	return OK;
+}
+
+/* Dijkstra from the boundary vertex source inside one cell of a level. On level 0 it walks
+the edges of the cell, above it the cliques of the cells one level down plus the edges
+between them. Nothing outside the cell is touched */
+int overlayCellSearch(SsspWorkspace *pstWorkspace, OverlayGraph *pstOverlay, int level, int cell, int source)
+{
+	OverlayLevel *pstLevel = &pstOverlay->astLevels[level];
+	OverlayLevel *pstBelow = (level > 0) ? &pstOverlay->astLevels[level - 1] : NULL_PTR;
+	int *piRow = NULL_PTR;
+	int j, e, vertex, distance, nextVertex, subCell, noOfSubBoundary;
+
+	resetSsspWorkspace(pstWorkspace);
+
+	if (OK != ssspRelax(pstWorkspace, source, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		pstWorkspace->noOfSettled++;
+
+		subCell = (NULL_PTR != pstBelow) ? pstBelow->piCells[vertex] : -1;
+
+		if (NULL_PTR != pstBelow)
+		{
+			noOfSubBoundary = pstBelow->piBoundaryOffsets[subCell + 1] - pstBelow->piBoundaryOffsets[subCell];
+			piRow = pstBelow->piCliques + pstBelow->pllCliqueOffsets[subCell]
+				+ ((long long)pstBelow->piBoundaryIndex[vertex] * noOfSubBoundary);
+
+			for (j = 0; j < noOfSubBoundary; j++)
+			{
+				nextVertex = pstBelow->piBoundary[pstBelow->piBoundaryOffsets[subCell] + j];
+				if ((INFINITY == piRow[j]) || (TRUE == pstWorkspace->pSettled[nextVertex]))
+				{
+					continue;
+				}
+
+				if (OK != ssspRelax(pstWorkspace, nextVertex, distance + piRow[j]))
+				{
+					return ERR;
+				}
+			}
+		}
+
+		for (e = pstOverlay->piOffsets[vertex]; e < pstOverlay->piOffsets[vertex + 1]; e++)
+		{
+			nextVertex = pstOverlay->pstEdges[e].vertexNum;
+
+			/* Edges inside a sub cell are already in its clique */
+			if ((cell != pstLevel->piCells[nextVertex])
+				|| ((NULL_PTR != pstBelow) && (subCell == pstBelow->piCells[nextVertex]))
+				|| (TRUE == pstWorkspace->pSettled[nextVertex]))
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstOverlay->piWeights[e]))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	return OK;
+}
+
+/* Computes the clique of one cell with a search from each of its boundary vertices */
+int customizeOverlayCell(SsspWorkspace *pstWorkspace, OverlayGraph *pstOverlay, int level, int cell)
+{
+	OverlayLevel *pstLevel = &pstOverlay->astLevels[level];
+	int *piClique = pstLevel->piCliques + pstLevel->pllCliqueOffsets[cell];
+	int *piBoundary = pstLevel->piBoundary + pstLevel->piBoundaryOffsets[cell];
+	int i, j, noOfBoundary = pstLevel->piBoundaryOffsets[cell + 1] - pstLevel->piBoundaryOffsets[cell];
+
+	for (i = 0; i < noOfBoundary; i++)
+	{
+		if (OK != overlayCellSearch(pstWorkspace, pstOverlay, level, cell, piBoundary[i]))
+		{
+			return ERR;
+		}
+
+		for (j = 0; j < noOfBoundary; j++)
+		{
+			piClique[((long long)i * noOfBoundary) + j] = pstWorkspace->piDist[piBoundary[j]];
+		}
+	}
+
+	return OK;
+}
+
+/* Worker customizing cells of one level until there are none left */
+void* overlayCustomizeWorker(void *pArg)
+{
+	OverlayCustomizeCtx *pstCtx = (OverlayCustomizeCtx *)pArg;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int job;
+
+	pstWorkspace = createSsspWorkspace(pstCtx->scheme, pstCtx->pstOverlay->noOfVertex);
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+		pstCtx->hasFailed = TRUE;
+		return NULL_PTR;
+	}
+
+	while (FALSE == pstCtx->hasFailed)
+	{
+		job = __sync_fetch_and_add(&pstCtx->nextJob, 1);
+		if (job >= pstCtx->noOfJobs)
+		{
+			break;
+		}
+
+		if (OK != customizeOverlayCell(pstWorkspace, pstCtx->pstOverlay, pstCtx->level, pstCtx->piJobs[job]))
+		{
+			myLog(ERROR, "customizeOverlayCell failed for cell [%d]!", pstCtx->piJobs[job]);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+
+	return NULL_PTR;
+}
+
+/* Computes the cliques of every dirty cell, level by level from the bottom since a level
+is built from the cliques of the one below. The cells of a level are shared out among
+noOfThreads workers. Returns the number of cells customized, ERR on failure */
+int customizeOverlay(OverlayGraph *pstOverlay, int scheme, int noOfThreads)
+{
+	pthread_t aThreads[MAX_WORKER_THREADS];
+	OverlayCustomizeCtx stCtx;
+	OverlayLevel *pstLevel = NULL_PTR;
+	int i, c, level, noOfStarted, noOfCustomized = 0;
+
+	if ((noOfThreads < 1) || (noOfThreads > MAX_WORKER_THREADS))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	for (level = 0; level < pstOverlay->noOfLevels; level++)
+	{
+		pstLevel = &pstOverlay->astLevels[level];
+
+		stCtx.pstOverlay = pstOverlay;
+		stCtx.scheme = scheme;
+		stCtx.level = level;
+		stCtx.noOfJobs = 0;
+		stCtx.nextJob = 0;
+		stCtx.hasFailed = FALSE;
+		stCtx.piJobs = (int *)malloc(sizeof(int) * pstLevel->noOfCells);
+		if (NULL_PTR == stCtx.piJobs)
+		{
+			myLog(ERROR, "malloc failed!");
+			return ERR;
+		}
+
+		for (c = 0; c < pstLevel->noOfCells; c++)
+		{
+			if (TRUE == pstLevel->pDirty[c])
+			{
+				stCtx.piJobs[stCtx.noOfJobs++] = c;
+			}
+		}
+
+		noOfStarted = 0;
+		for (i = 0; (i < MIN(noOfThreads, stCtx.noOfJobs)) && (FALSE == stCtx.hasFailed); i++)
+		{
+			if (0 != pthread_create(&aThreads[i], NULL, overlayCustomizeWorker, &stCtx))
+			{
+				myLog(ERROR, "pthread_create failed for worker [%d]!", i);
+				stCtx.hasFailed = TRUE;
+				break;
+			}
+			noOfStarted++;
+		}
+
+		for (i = 0; i < noOfStarted; i++)
+		{
+			pthread_join(aThreads[i], NULL);
+		}
+
+		free(stCtx.piJobs);
+
+		if (TRUE == stCtx.hasFailed)
+		{
+			return ERR;
+		}
+
+		memset(pstLevel->pDirty, FALSE, pstLevel->noOfCells);
+		noOfCustomized += stCtx.noOfJobs;
+	}
+
+	return noOfCustomized;
+}
+
+/* Sets the weight of every edge u -> v and marks the cells whose cliques it can change:
+on each level the cell holding both ends, if there is one. Returns the number of edges
+changed, ERR on failure */
+int updateOverlayWeight(OverlayGraph *pstOverlay, int u, int v, int distance)
+{
+	OverlayLevel *pstLevel = NULL_PTR;
+	int e, level, noOfChanged = 0;
+
+	if ((u < 0) || (u >= pstOverlay->noOfVertex) || (v < 0) || (v >= pstOverlay->noOfVertex)
+		|| (distance < 0))
+	{
+		myLog(ERROR, "Invalid Input! Edge [%d] -> [%d] weight [%d]", u, v, distance);
+		return ERR;
+	}
+
+	for (e = pstOverlay->piOffsets[u]; e < pstOverlay->piOffsets[u + 1]; e++)
+	{
+		if (v == pstOverlay->pstEdges[e].vertexNum)
+		{
+			pstOverlay->piWeights[e] = distance;
+			noOfChanged++;
+		}
+	}
+
+	for (level = 0; (level < pstOverlay->noOfLevels) && (noOfChanged > 0); level++)
+	{
+		pstLevel = &pstOverlay->astLevels[level];
+		if (pstLevel->piCells[u] == pstLevel->piCells[v])
+		{
+			pstLevel->pDirty[pstLevel->piCells[u]] = TRUE;
+		}
+	}
+
+	return noOfChanged;
+}
+
+/* Highest level on which vertex is in neither the cell of source nor that of target,
+-1 if it shares its finest cell with one of them */
+int getOverlayQueryLevel(OverlayGraph *pstOverlay, int vertex, int source, int target)
+{
+	OverlayLevel *pstLevel = NULL_PTR;
+	int level;
+
+	for (level = pstOverlay->noOfLevels - 1; level >= 0; level--)
+	{
+		pstLevel = &pstOverlay->astLevels[level];
+		if ((pstLevel->piCells[vertex] != pstLevel->piCells[source])
+			&& (pstLevel->piCells[vertex] != pstLevel->piCells[target]))
+		{
+			return level;
+		}
+	}
+
+	return -1;
+}
+
+/* Dijkstra from source to target over the overlay. The cells of source and target are
+searched on the original edges. Any other cell is crossed in one step on the clique of the
+highest level which keeps source and target out of it, followed by the edges leaving it.
+Returns the distance, INFINITY if target is not reachable and ERR on failure */
+int overlayPointToPoint(SsspWorkspace *pstWorkspace, OverlayGraph *pstOverlay, int source, int target)
+{
+	OverlayLevel *pstLevel = NULL_PTR;
+	int *piRow = NULL_PTR;
+	int j, e, vertex, distance, nextVertex, level, cell, noOfBoundary;
+
+	if ((source < 0) || (source >= pstOverlay->noOfVertex)
+		|| (target < 0) || (target >= pstOverlay->noOfVertex))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	resetSsspWorkspace(pstWorkspace);
+
+	if (OK != ssspRelax(pstWorkspace, source, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		pstWorkspace->noOfSettled++;
+
+		if (target == vertex)
+		{
+			break;
+		}
+
+		/* A vertex reached from outside its cell is always on the boundary of it */
+		level = getOverlayQueryLevel(pstOverlay, vertex, source, target);
+		if ((level >= 0) && (-1 == pstOverlay->astLevels[level].piBoundaryIndex[vertex]))
+		{
+			level = -1;
+		}
+
+		cell = -1;
+		if (level >= 0)
+		{
+			pstLevel = &pstOverlay->astLevels[level];
+			cell = pstLevel->piCells[vertex];
+			noOfBoundary = pstLevel->piBoundaryOffsets[cell + 1] - pstLevel->piBoundaryOffsets[cell];
+			piRow = pstLevel->piCliques + pstLevel->pllCliqueOffsets[cell]
+				+ ((long long)pstLevel->piBoundaryIndex[vertex] * noOfBoundary);
+
+			for (j = 0; j < noOfBoundary; j++)
+			{
+				nextVertex = pstLevel->piBoundary[pstLevel->piBoundaryOffsets[cell] + j];
+				if ((INFINITY == piRow[j]) || (TRUE == pstWorkspace->pSettled[nextVertex]))
+				{
+					continue;
+				}
+
+				if (OK != ssspRelax(pstWorkspace, nextVertex, distance + piRow[j]))
+				{
+					return ERR;
+				}
+			}
+		}
+
+		for (e = pstOverlay->piOffsets[vertex]; e < pstOverlay->piOffsets[vertex + 1]; e++)
+		{
+			nextVertex = pstOverlay->pstEdges[e].vertexNum;
+			if (((level >= 0) && (cell == pstLevel->piCells[nextVertex]))
+				|| (TRUE == pstWorkspace->pSettled[nextVertex]))
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstOverlay->piWeights[e]))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	return pstWorkspace->piDist[target];
+}
+
+/* Plain Dijkstra from source to target on the current weights of the overlay */
+int overlayPlainPointToPoint(SsspWorkspace *pstWorkspace, OverlayGraph *pstOverlay, int source, int target)
+{
+	int e, vertex, distance, nextVertex;
+
+	resetSsspWorkspace(pstWorkspace);
+
+	if (OK != ssspRelax(pstWorkspace, source, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		pstWorkspace->noOfSettled++;
+
+		if (target == vertex)
+		{
+			break;
+		}
+
+		for (e = pstOverlay->piOffsets[vertex]; e < pstOverlay->piOffsets[vertex + 1]; e++)
+		{
+			nextVertex = pstOverlay->pstEdges[e].vertexNum;
+			if (TRUE == pstWorkspace->pSettled[nextVertex])
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstOverlay->piWeights[e]))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	return pstWorkspace->piDist[target];
+}
+
+/* Runs random queries with plain Dijkstra and over the overlay, checks that they agree and
+prints the average settled vertices and latency of both */
+int runOverlayQueries(SsspWorkspace *pstWorkspace, OverlayGraph *pstOverlay, int noOfQueries)
+{
+	long long startTime, plainUsec = 0, overlayUsec = 0, plainSettled = 0, overlaySettled = 0;
+	int i, source, destination, plainDistance, overlayDistance;
+
+	for (i = 0; i < noOfQueries; i++)
+	{
+		source = rand() % pstOverlay->noOfVertex;
+		destination = rand() % pstOverlay->noOfVertex;
+
+		startTime = getWallTimeUsec();
+		plainDistance = overlayPlainPointToPoint(pstWorkspace, pstOverlay, source, destination);
+		plainUsec += getWallTimeUsec() - startTime;
+		plainSettled += pstWorkspace->noOfSettled;
+
+		startTime = getWallTimeUsec();
+		overlayDistance = overlayPointToPoint(pstWorkspace, pstOverlay, source, destination);
+		overlayUsec += getWallTimeUsec() - startTime;
+		overlaySettled += pstWorkspace->noOfSettled;
+
+		if ((ERR == plainDistance) || (plainDistance != overlayDistance))
+		{
+			myLog(ERROR, "Query [%d] -> [%d]: plain [%d], overlay [%d]!",
+				source, destination, plainDistance, overlayDistance);
+			return ERR;
+		}
+	}
+
+	printf("[%d] queries\n"
+		"Plain:\tAverage settled: [%lld] Average time: [%lld] usec\n"
+		"Overlay:\tAverage settled: [%lld] Average time: [%lld] usec\n",
+		noOfQueries, plainSettled / noOfQueries, plainUsec / noOfQueries,
+		overlaySettled / noOfQueries, overlayUsec / noOfQueries);
+
+	return OK;
+}
+
+/* Applies the weight updates of a text file, one "u v weight" per line. Returns the number
+of edges changed, ERR on failure */
+int applyOverlayUpdates(OverlayGraph *pstOverlay, char *fileName)
+{
+	FILE *pFile = NULL_PTR;
+	char fileLine[128];
+	int u, v, distance, noOfChanged, total = 0;
+
+	pFile = fopen(fileName, "r");
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "Could not open [%s]!", fileName);
+		return ERR;
+	}
+
+	while (NULL_PTR != fgets(fileLine, sizeof(fileLine), pFile))
+	{
+		if (3 != sscanf(fileLine, "%d %d %d", &u, &v, &distance))
+		{
+			continue;
+		}
+
+		noOfChanged = updateOverlayWeight(pstOverlay, u, v, distance);
+		if (ERR == noOfChanged)
+		{
+			fclose(pFile);
+			return ERR;
+		}
+
+		total += noOfChanged;
+	}
+
+	fclose(pFile);
+
+	return total;
+}
+
+/* Entry function for overlay preprocessing. Partitions the binary graph file fileName
+into noOfLevels nested levels and stores the partition in it */
+int overlayPrepProc(char *fileName, char *levelsArg, char *fanoutArg)
+{
+	GraphFile *pstGraphFile = NULL_PTR;
+	ArcFlagGraph stGraph;
+	void *pSection = NULL_PTR;
+	long long size, startTime;
+	int level, noOfLevels = DEFAULT_OVERLAY_LEVELS, fanout = DEFAULT_OVERLAY_FANOUT, noOfCells = 1, retVal;
+
+	if (NULL_PTR != levelsArg)
+	{
+		noOfLevels = atoi(levelsArg);
+	}
+
+	if (NULL_PTR != fanoutArg)
+	{
+		fanout = atoi(fanoutArg);
+	}
+
+	for (level = 0; level < noOfLevels; level++)
+	{
+		noOfCells *= MAX(fanout, 1);
+	}
+
+	if ((noOfLevels <= 0) || (noOfLevels > MAX_OVERLAY_LEVELS) || (fanout < 2)
+		|| (noOfCells > MAX_LARGE_VERTEX_NUM))
+	{
+		myLog(ERROR, "Invalid Input! Levels: 1 to [%d], fanout at least 2", MAX_OVERLAY_LEVELS);
+		return ERR;
+	}
+
+	pstGraphFile = openGraphFile(fileName);
+	if ((NULL_PTR == pstGraphFile) || (OK != openArcFlagGraph(&stGraph, pstGraphFile)))
+	{
+		myLog(ERROR, "[%s] is not a binary graph file! Convert it with -g first", fileName);
+		closeGraphFile(pstGraphFile);
+		return ERR;
+	}
+
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+	startTime = getWallTimeMsec();
+
+	/* The partition grows cells over both edge directions */
+	if (OK == buildArcFlagReverse(&stGraph))
+	{
+		pSection = buildOverlaySection(&stGraph, noOfLevels, fanout, &size);
+		destroyArcFlagReverse(&stGraph);
+	}
+
+	closeGraphFile(pstGraphFile);
+
+	if (NULL_PTR == pSection)
+	{
+		myLog(ERROR, "buildOverlaySection failed!");
+		return ERR;
+	}
+
+	printf("\nPartitioned into [%d] levels of fanout [%d] in [%lld] msec\n",
+		noOfLevels, fanout, getWallTimeMsec() - startTime);
+
+	retVal = setGraphFileSection(fileName, GRAPH_SECTION_OVERLAY, pSection, size);
+	free(pSection);
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "Could not store the partition in [%s]!", fileName);
+		return ERR;
+	}
+
+	printf("Stored [%lld] bytes of partition in [%s]\n", size, fileName);
+
+	return OK;
+}
+
+/* Entry function for overlay mode. Customizes the overlay of the binary graph file fileName
+and checks random queries against plain Dijkstra. With an update file the new weights
+are applied, only the cells they touch are customized again and the queries are repeated */
+int overlayProc(int scheme, char *fileName, char *updateFileName, char *queriesArg, char *threadsArg)
+{
+	GraphFile *pstGraphFile = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	OverlayGraph stOverlay;
+	long long startTime;
+	int level, noOfCustomized, noOfChanged, noOfThreads, noOfQueries = DEFAULT_OVERLAY_QUERIES;
+	int retVal = ERR;
+
+	if (NULL_PTR != queriesArg)
+	{
+		noOfQueries = atoi(queriesArg);
+	}
+
+	if (noOfQueries <= 0)
+	{
+		myLog(ERROR, "Invalid Input! Queries must be positive");
+		return ERR;
+	}
+
+	noOfThreads = getWorkerThreadCount(threadsArg);
+
+	pstGraphFile = openGraphFile(fileName);
+	if ((NULL_PTR == pstGraphFile) || (OK != loadOverlayGraph(&stOverlay, pstGraphFile)))
+	{
+		myLog(ERROR, "[%s] has no usable overlay! Run -op on it first", fileName);
+		closeGraphFile(pstGraphFile);
+		return ERR;
+	}
+
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+	printf("\n%s: [%d] levels, cells:", schemeString[scheme], stOverlay.noOfLevels);
+	for (level = 0; level < stOverlay.noOfLevels; level++)
+	{
+		printf(" [%d] ([%d] boundary)", stOverlay.astLevels[level].noOfCells,
+			stOverlay.astLevels[level].piBoundaryOffsets[stOverlay.astLevels[level].noOfCells]);
+	}
+	printf("\n");
+
+	startTime = getWallTimeMsec();
+	noOfCustomized = customizeOverlay(&stOverlay, scheme, noOfThreads);
+
+	if (ERR == noOfCustomized)
+	{
+		myLog(ERROR, "customizeOverlay failed!");
+	}
+	else if (NULL_PTR == (pstWorkspace = createSsspWorkspace(scheme, stOverlay.noOfVertex)))
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+	}
+	else
+	{
+		printf("Customized [%d] cells in [%lld] msec with [%d] threads\n",
+			noOfCustomized, getWallTimeMsec() - startTime, noOfThreads);
+
+		retVal = runOverlayQueries(pstWorkspace, &stOverlay, noOfQueries);
+
+		if ((OK == retVal) && (NULL_PTR != updateFileName) && (0 != strcmp(updateFileName, "-")))
+		{
+			retVal = ERR;
+			noOfChanged = applyOverlayUpdates(&stOverlay, updateFileName);
+
+			startTime = getWallTimeMsec();
+			noOfCustomized = (ERR != noOfChanged) ? customizeOverlay(&stOverlay, scheme, noOfThreads) : ERR;
+
+			if (ERR != noOfCustomized)
+			{
+				printf("\nUpdated [%d] edges, customized [%d] cells again in [%lld] msec\n",
+					noOfChanged, noOfCustomized, getWallTimeMsec() - startTime);
+
+				retVal = runOverlayQueries(pstWorkspace, &stOverlay, noOfQueries);
+			}
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	destroyOverlayGraph(&stOverlay);
+	closeGraphFile(pstGraphFile);
+
+	return retVal;
+}
@@ -0,0 +1,59 @@
+/***************************************************************************************************/
+// OVERLAY.H
+// Contains the nested partition and the clique overlays of the multi-level overlay search
+/***************************************************************************************************/
+
+#ifndef __OVERLAY__
+#define __OVERLAY__
+
+#include "graphio.h"
+
+#define MAX_OVERLAY_LEVELS 4
+#define DEFAULT_OVERLAY_LEVELS 2
+#define DEFAULT_OVERLAY_FANOUT 16 // Cells a cell of the level above is split into
+#define DEFAULT_OVERLAY_QUERIES 100
+
+/* Start of the overlay section of a binary graph file. It is followed by
+int cells[noOfLevels][noOfVertex]. Level 0 is the finest, every cell of level l is a
+union of cells of level l - 1. Only the partition is stored, the cliques depend on the
+weights and are computed when the overlay is loaded */
+typedef struct OverlaySectionHeader
+{
+	int noOfLevels;
+	int noOfVertex;
+	int aNoOfCells[MAX_OVERLAY_LEVELS];
+}OverlaySectionHeader;
+
+/* One level of the overlay. The boundary vertices of a cell have an edge to or from
+another cell of the level. Each cell has a clique: the shortest distance inside the cell
+between every pair of its boundary vertices, INFINITY if there is no such path */
+typedef struct OverlayLevel
+{
+	int noOfCells;
+	int *piCells; // Cell of every vertex, points into the overlay section
+	int *piBoundaryOffsets; // Boundary vertices of cell c are piBoundary[piBoundaryOffsets[c] ...]
+	int *piBoundary;
+	int *piBoundaryIndex; // Position of a vertex in the boundary list of its cell, -1 if none
+	long long *pllCliqueOffsets; // Clique of cell c starts at piCliques[pllCliqueOffsets[c]]
+	int *piCliques; // Row major, one row per boundary vertex
+	char *pDirty; // TRUE for a cell whose clique has to be computed again
+}OverlayLevel;
+
+/* The overlay in memory. The topology comes from the mapped CSR of a graph file, the
+weights are a private copy so that they can be changed */
+typedef struct OverlayGraph
+{
+	int noOfVertex;
+	int noOfEdges;
+	int noOfLevels;
+	int *piOffsets;
+	GraphFileEdge *pstEdges;
+	int *piWeights; // Current weight of every edge
+	OverlayLevel astLevels[MAX_OVERLAY_LEVELS];
+}OverlayGraph;
+
+/* Bytes of an overlay section */
+#define OVERLAY_SECTION_SIZE(noOfLevels, noOfVertex) \
+	((long long)sizeof(OverlaySectionHeader) + ((long long)sizeof(int) * (noOfLevels) * (noOfVertex)))
+
+#endif
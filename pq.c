@@ -0,0 +1,359 @@
+/***************************************************************************************************/
+// PQ.C
+// Contains all functions of the priority queue over the binary, binomial and fibonacci heaps
+/***************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "pq.h"
+
+/* States of a vertex in pInQueue */
+#define PQ_NEVER_QUEUED 0
+#define PQ_IN_QUEUE 1
+#define PQ_REMOVED 2
+
+extern struct MinHeap* createMinHeap(int capacity);
+extern BinoHeap* binoInsert(BinoHeap **pstBinoHeapRoot, int vertex, int distance);
+extern FiboHeap* fiboInsert(FiboHeap **pstFiboHeapRoot, int vertex, int distance);
+
+/* Empties the queue and forgets every vertex. Costs O(vertices inserted since the last
+clear), so early terminated searches do not pay for the whole graph */
+void pqClear(PQueue *pstQueue)
+{
+	int i, vertex;
+
+	if (NULL_PTR != pstQueue->pstMinHeap)
+	{
+		clearMinHeap(pstQueue->pstMinHeap);
+	}
+
+	for (i = 0; i < pstQueue->noOfQueued; i++)
+	{
+		vertex = pstQueue->piQueued[i];
+
+		/* The tree links do not matter anymore, free the nodes one by one */
+		if ((BINARY_SCHEME != pstQueue->scheme)
+			&& (NULL_PTR != pstQueue->ppNode[vertex]))
+		{
+			free(pstQueue->ppNode[vertex]);
+			pstQueue->ppNode[vertex] = NULL_PTR;
+		}
+
+		pstQueue->pInQueue[vertex] = PQ_NEVER_QUEUED;
+	}
+
+	pstQueue->noOfQueued = 0;
+	pstQueue->size = 0;
+	pstQueue->pstBinoHeap = NULL_PTR;
+	pstQueue->pstFiboHeap = NULL_PTR;
+}
+
+/* Frees the queue */
+void destroyPQueue(PQueue *pstQueue)
+{
+	if (NULL_PTR == pstQueue)
+	{
+		return;
+	}
+
+	pqClear(pstQueue);
+
+	destroyMinHeap(pstQueue->pstMinHeap);
+	free(pstQueue->ppNode);
+	free(pstQueue->pInQueue);
+	free(pstQueue->piQueued);
+	free(pstQueue);
+}
+
+/* Returns an empty queue for vertices [0, noOfVertex) using the heap of the given scheme */
+PQueue* createPQueue(int scheme, int noOfVertex)
+{
+	PQueue *pstQueue = NULL_PTR;
+
+	if ((noOfVertex <= 0)
+		|| ((BINARY_SCHEME != scheme) && (BINO_SCHEME != scheme) && (FIBO_SCHEME != scheme)))
+	{
+		myLog(ERROR, "Invalid Input! Scheme: [%d] Vertices: [%d]", scheme, noOfVertex);
+		return NULL_PTR;
+	}
+
+	pstQueue = (PQueue *)calloc(1, sizeof(PQueue));
+	if (NULL_PTR == pstQueue)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstQueue->scheme = scheme;
+	pstQueue->noOfVertex = noOfVertex;
+	pstQueue->pInQueue = (char *)calloc(noOfVertex, sizeof(char));
+	pstQueue->piQueued = (int *)malloc(sizeof(int) * noOfVertex);
+
+	if (BINARY_SCHEME == scheme)
+	{
+		pstQueue->pstMinHeap = createMinHeap(noOfVertex);
+	}
+	else
+	{
+		pstQueue->ppNode = (void **)calloc(noOfVertex, sizeof(void *));
+	}
+
+	if ((NULL_PTR == pstQueue->pInQueue)
+		|| (NULL_PTR == pstQueue->piQueued)
+		|| ((BINARY_SCHEME == scheme) && (NULL_PTR == pstQueue->pstMinHeap))
+		|| ((BINARY_SCHEME != scheme) && (NULL_PTR == pstQueue->ppNode)))
+	{
+		myLog(ERROR, "Failed to allocate queue for [%d] vertices!", noOfVertex);
+		destroyPQueue(pstQueue);
+		return NULL_PTR;
+	}
+
+	return pstQueue;
+}
+
+/* Returns TRUE if there is nothing in the queue */
+int pqIsEmpty(PQueue *pstQueue)
+{
+	return (0 == pstQueue->size);
+}
+
+/* Returns TRUE if the vertex is currently in the queue */
+int pqIsInQueue(PQueue *pstQueue, int vertex)
+{
+	return (PQ_IN_QUEUE == pstQueue->pInQueue[vertex]);
+}
+
+/* Returns the key of a queued vertex */
+int pqGetKey(PQueue *pstQueue, int vertex)
+{
+	switch (pstQueue->scheme)
+	{
+		case BINARY_SCHEME:
+		{
+			return minHeapGetKey(pstQueue->pstMinHeap, vertex);
+		}
+		case BINO_SCHEME:
+		{
+			return ((BinoHeap *)pstQueue->ppNode[vertex])->key;
+		}
+		default:
+		{
+			return ((FiboHeap *)pstQueue->ppNode[vertex])->key;
+		}
+	}
+}
+
+/* Adds a vertex which is not in the queue */
+int pqInsert(PQueue *pstQueue, int vertex, int key)
+{
+	void *pNode = NULL_PTR;
+
+	if ((vertex < 0) || (vertex >= pstQueue->noOfVertex)
+		|| (PQ_IN_QUEUE == pstQueue->pInQueue[vertex]))
+	{
+		myLog(ERROR, "Invalid Input! Vertex: [%d]", vertex);
+		return ERR;
+	}
+
+	switch (pstQueue->scheme)
+	{
+		case BINARY_SCHEME:
+		{
+			if (OK != minHeapInsert(pstQueue->pstMinHeap, vertex, key))
+			{
+				myLog(ERROR, "minHeapInsert failed!");
+				return ERR;
+			}
+			break;
+		}
+		case BINO_SCHEME:
+		{
+			pNode = binoInsert(&pstQueue->pstBinoHeap, vertex, key);
+			break;
+		}
+		default:
+		{
+			pNode = fiboInsert(&pstQueue->pstFiboHeap, vertex, key);
+			break;
+		}
+	}
+
+	if (BINARY_SCHEME != pstQueue->scheme)
+	{
+		if (NULL_PTR == pNode)
+		{
+			myLog(ERROR, "Heap insert failed!");
+			return ERR;
+		}
+		pstQueue->ppNode[vertex] = pNode;
+	}
+
+	/* Remember it so that a clear does not need to scan all vertices */
+	if (PQ_NEVER_QUEUED == pstQueue->pInQueue[vertex])
+	{
+		pstQueue->piQueued[pstQueue->noOfQueued++] = vertex;
+	}
+
+	pstQueue->pInQueue[vertex] = PQ_IN_QUEUE;
+	pstQueue->size++;
+
+	return OK;
+}
+
+/* Lowers the key of a queued vertex */
+int pqDecreaseKey(PQueue *pstQueue, int vertex, int key)
+{
+	BinoHeap *pstBinoNode = NULL_PTR;
+	FiboHeap *pstFiboNode = NULL_PTR;
+
+	if ((vertex < 0) || (vertex >= pstQueue->noOfVertex)
+		|| (PQ_IN_QUEUE != pstQueue->pInQueue[vertex]))
+	{
+		myLog(ERROR, "Invalid Input! Vertex: [%d]", vertex);
+		return ERR;
+	}
+
+	switch (pstQueue->scheme)
+	{
+		case BINARY_SCHEME:
+		{
+			decreaseKey(pstQueue->pstMinHeap, vertex, key);
+			break;
+		}
+		case BINO_SCHEME:
+		{
+			pstBinoNode = (BinoHeap *)pstQueue->ppNode[vertex];
+			if (OK != binoDecreaseKey(&pstQueue->pstBinoHeap, pstBinoNode, key))
+			{
+				myLog(ERROR, "binoDecreaseKey failed!");
+				return ERR;
+			}
+
+			/* binoDecreaseKey() only moves the root when it swaps with it. A node
+			with a key below the root is always at the top level */
+			if (pstBinoNode->key < pstQueue->pstBinoHeap->key)
+			{
+				pstQueue->pstBinoHeap = pstBinoNode;
+			}
+			break;
+		}
+		default:
+		{
+			pstFiboNode = (FiboHeap *)pstQueue->ppNode[vertex];
+			if (OK != fiboDecreaseKey(&pstQueue->pstFiboHeap, pstFiboNode, key))
+			{
+				myLog(ERROR, "fiboDecreaseKey failed!");
+				return ERR;
+			}
+
+			/* Same as above when the node did not have to be cut */
+			if (pstFiboNode->key < pstQueue->pstFiboHeap->key)
+			{
+				pstQueue->pstFiboHeap = pstFiboNode;
+			}
+			break;
+		}
+	}
+
+	return OK;
+}
+
+/* Inserts the vertex or lowers its key if the new key is smaller.
+Returns TRUE if the queue changed, FALSE if not and ERR on failure */
+int pqUpdate(PQueue *pstQueue, int vertex, int key)
+{
+	if (PQ_IN_QUEUE != pstQueue->pInQueue[vertex])
+	{
+		return ((OK == pqInsert(pstQueue, vertex, key)) ? TRUE : ERR);
+	}
+
+	if (key >= pqGetKey(pstQueue, vertex))
+	{
+		return FALSE;
+	}
+
+	return ((OK == pqDecreaseKey(pstQueue, vertex, key)) ? TRUE : ERR);
+}
+
+/* Returns the vertex with the smallest key without removing it */
+int pqPeekMin(PQueue *pstQueue, int *vertex, int *key)
+{
+	if ((NULL_PTR == vertex) || (NULL_PTR == key) || (0 == pstQueue->size))
+	{
+		return ERR;
+	}
+
+	switch (pstQueue->scheme)
+	{
+		case BINARY_SCHEME:
+		{
+			return minHeapPeekMin(pstQueue->pstMinHeap, vertex, key);
+		}
+		case BINO_SCHEME:
+		{
+			*vertex = pstQueue->pstBinoHeap->vertex;
+			*key = pstQueue->pstBinoHeap->key;
+			return OK;
+		}
+		default:
+		{
+			*vertex = pstQueue->pstFiboHeap->vertex;
+			*key = pstQueue->pstFiboHeap->key;
+			return OK;
+		}
+	}
+}
+
+/* Removes the vertex with the smallest key */
+int pqRemoveMin(PQueue *pstQueue, int *vertex, int *key)
+{
+	int retVal;
+
+	if ((NULL_PTR == vertex) || (NULL_PTR == key) || (0 == pstQueue->size))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	switch (pstQueue->scheme)
+	{
+		case BINARY_SCHEME:
+		{
+			retVal = minHeapRemoveMin(pstQueue->pstMinHeap, vertex, key);
+			break;
+		}
+		case BINO_SCHEME:
+		{
+			retVal = binoRemoveMin(&pstQueue->pstBinoHeap, vertex, key);
+			break;
+		}
+		default:
+		{
+			retVal = fiboRemoveMin(&pstQueue->pstFiboHeap, vertex, key);
+			break;
+		}
+	}
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "Heap remove min failed!");
+		return ERR;
+	}
+
+	if (BINARY_SCHEME != pstQueue->scheme)
+	{
+		pstQueue->ppNode[*vertex] = NULL_PTR;
+	}
+
+	pstQueue->pInQueue[*vertex] = PQ_REMOVED;
+	pstQueue->size--;
+
+	/* The heaps leave a dangling root behind once the last node goes */
+	if (0 == pstQueue->size)
+	{
+		pstQueue->pstBinoHeap = NULL_PTR;
+		pstQueue->pstFiboHeap = NULL_PTR;
+	}
+
+	return OK;
+}
@@ -0,0 +1,28 @@
+/***************************************************************************************************/
+// PQ.H
+// Contains the priority queue used by the single source modes on top of the three heaps
+/***************************************************************************************************/
+
+#ifndef __PQ__
+#define __PQ__
+
+#include "bino.h"
+#include "fibo.h"
+
+/* A priority queue of vertices keyed by distance. scheme decides which of the heaps is used.
+Every vertex is present at most once, a smaller key for a queued vertex is a decrease key */
+typedef struct PQueue
+{
+	int scheme; // BINARY_SCHEME / BINO_SCHEME / FIBO_SCHEME
+	int noOfVertex;
+	int size; // Vertices currently in the queue
+	struct MinHeap *pstMinHeap; // BINARY_SCHEME
+	BinoHeap *pstBinoHeap; // BINO_SCHEME, the root
+	FiboHeap *pstFiboHeap; // FIBO_SCHEME, the root
+	void **ppNode; // BINO/FIBO_SCHEME: heap node of a queued vertex, NULL otherwise
+	char *pInQueue; // TRUE if the vertex is in the queue
+	int *piQueued; // Vertices inserted since the last clear, so a clear is O(inserted)
+	int noOfQueued;
+}PQueue;
+
+#endif
@@ -8,14 +8,22 @@
 
 #include <stdio.h>
 #include <time.h>
-#include "header.h"
+#include <errno.h>
+#include <sys/stat.h>
+#include "graphio.h"
 
 //Stores the number to vertices
 extern int gNoOfVertex;
 //Stores the desity of graph in percentage
 extern int gGraphDensity;
+//Seed for the random graph generator. 0 seeds from the clock
+extern unsigned int gRandomSeed;
+//Directory of the generated graph cache. NULL when graphs are not cached
+extern char *gGraphCacheDir;
 //function which allocates memory for adjlist based on number of vertices and density
 extern AdjList* initAdjList();
+extern GraphFile* openGraphFile(char *fileName);
+extern AdjList* graphFileToAdjList(GraphFile *pstGraphFile);
 
 //Output for random mode
 int gRandomModeOutput[TOTAL_SCHEMES][MAX_VALID_VERTICES][MAX_VALID_DENSITIES];
@@ -28,6 +36,111 @@ int randomWithRange(int start, int end)
 	return (start + (rand() % (end - start + 1)));
 }
 
+/* Generates a connected random graph for the current gNoOfVertex and gGraphDensity */
+AdjList* generateRandomAdjList()
+{
+	AdjList *pstAdjList = NULL_PTR;
+
+	/* Prepare Adjacency List */
+	pstAdjList = initAdjList();
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "initAdjList failed!");
+		return NULL_PTR;
+	}
+
+	/* Generate Graph */
+	if (OK != buildRandomAdjList(pstAdjList))
+	{
+		myLog(ERROR, "buildAdjList failed!");
+
+		/* deinit the adjacency list */
+		destroyAdjList(pstAdjList);
+
+		return NULL_PTR;
+	}
+
+	/* Check if the graph is disconnected. If yes, connect the graph */
+	if (OK != connectGraph(pstAdjList))
+	{
+		myLog(ERROR, "connectGraph failed!");
+
+		/* deinit the adjacency list */
+		destroyAdjList(pstAdjList);
+
+		return NULL_PTR;
+	}
+
+	return pstAdjList;
+}
+
+/* Fills fileName with the cache entry of the current graph parameters. The key is
+(generator, vertices, density, seed, weight distribution) */
+void getGraphCacheFileName(char *fileName, int size)
+{
+	(void)snprintf(fileName, size, "%s/%s_v%d_d%d_s%u_%s1-%d.djkg",
+		gGraphCacheDir, RANDOM_GENERATOR_NAME, gNoOfVertex, gGraphDensity,
+		gRandomSeed, RANDOM_WEIGHT_DIST_NAME, MAX_EDGE_COST);
+}
+
+/* Returns the graph for the current parameters. If the cache is enabled the graph is
+mmap'd from the cache, and on a miss it is generated and stored for the next run */
+AdjList* getRandomAdjList()
+{
+	char fileName[MAX_FILE_NAME_LEN];
+	GraphFile *pstGraphFile = NULL_PTR;
+	AdjList *pstAdjList = NULL_PTR;
+	int noOfVertex;
+
+	if (NULL_PTR == gGraphCacheDir)
+	{
+		return generateRandomAdjList();
+	}
+
+	getGraphCacheFileName(fileName, sizeof(fileName));
+	noOfVertex = gNoOfVertex;
+
+	pstGraphFile = openGraphFile(fileName);
+	if (NULL_PTR != pstGraphFile)
+	{
+		if (noOfVertex == pstGraphFile->pstHeader->noOfVertex)
+		{
+			pstAdjList = graphFileToAdjList(pstGraphFile);
+		}
+		closeGraphFile(pstGraphFile);
+
+		if (NULL_PTR != pstAdjList)
+		{
+			myLog(INFO, "Graph cache hit: [%s]", fileName);
+			return pstAdjList;
+		}
+
+		/* Stale or corrupt entry, regenerate it */
+		myLog(ERROR, "Ignoring invalid cache entry [%s]", fileName);
+		gNoOfVertex = noOfVertex;
+	}
+
+	myLog(INFO, "Graph cache miss: [%s]", fileName);
+
+	pstAdjList = generateRandomAdjList();
+	if (NULL_PTR == pstAdjList)
+	{
+		return NULL_PTR;
+	}
+
+	/* A failure to store only costs the next run a regeneration */
+	if ((0 != mkdir(gGraphCacheDir, 0755)) && (EEXIST != errno))
+	{
+		myLog(ERROR, "Could not create cache directory [%s]!", gGraphCacheDir);
+	}
+	else if (OK != saveAdjListToGraphFile(fileName, pstAdjList))
+	{
+		myLog(ERROR, "saveAdjListToGraphFile failed for [%s]!", fileName);
+	}
+
+	return pstAdjList;
+}
+
 int randomProc()
 {
 	AdjList *pstAdjList = NULL_PTR;
@@ -43,33 +156,11 @@ int randomProc()
 			gNoOfVertex = aValidVertices[i];
 			gGraphDensity = aValidDensities[j];
 
-			/* Prepare Adjacency List */
-			pstAdjList = initAdjList();
+			/* Generate Graph or get it from the cache */
+			pstAdjList = getRandomAdjList();
 			if (NULL_PTR == pstAdjList)
 			{
-				myLog(ERROR, "initAdjList failed!");
-				return ERR;
-			}
-
-			/* Generate Graph */
-			if (OK != buildRandomAdjList(pstAdjList))
-			{
-				myLog(ERROR, "buildAdjList failed!");
-
-				/* deinit the adjacency list */
-				destroyAdjList(pstAdjList);
-
-				return ERR;
-			}
-
-			/* Check if the graph is disconnected. If yes, connect the graph */
-			if (OK != connectGraph(pstAdjList))
-			{
-				myLog(ERROR, "connectGraph failed!");
-
-				/* deinit the adjacency list */
-				destroyAdjList(pstAdjList);
-
+				myLog(ERROR, "getRandomAdjList failed!");
 				return ERR;
 			}
 
@@ -161,3 +252,19 @@ int randomProc()
 
 	return OK;
 }
+
+/* Random mode where the generated graphs are cached in cacheDir. The cache needs a
+reproducible seed, so the clock is not used */
+int randomCachedProc(char *cacheDir)
+{
+	gGraphCacheDir = (NULL_PTR == cacheDir) ? GRAPH_CACHE_DEFAULT_DIR : cacheDir;
+
+	if (0 == gRandomSeed)
+	{
+		gRandomSeed = GRAPH_CACHE_SEED;
+	}
+
+	myLog(INFO, "Caching graphs in [%s] with seed [%u]", gGraphCacheDir, gRandomSeed);
+
+	return randomProc();
+}
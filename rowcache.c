@@ -0,0 +1,651 @@
+/***************************************************************************************************/
+// ROWCACHE.C
+// Contains all functions of the row cache: an LRU of distance rows keyed by source and graph
+// version, the cached point to point query built on it and the skewed query benchmark
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sssp.h"
+#include "stream.h"
+#include "rowcache.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern volatile int gGraphVersion;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeMsec();
+
+/* Shared by the workers of one benchmark pass. Without a cache every query is a point to
+point search with early stop */
+typedef struct RowCacheCtx
+{
+	int scheme;
+	AdjList *pstAdjList;
+	RowCache *pstCache;
+	int noOfQueries;
+	int *piSources;
+	int *piTargets;
+	int *piDistances; // Answers, in query order
+	volatile int nextQuery;
+	volatile int hasFailed;
+}RowCacheCtx;
+
+/* Frees the cache. No reader may hold a row */
+void destroyRowCache(RowCache *pstCache)
+{
+	int i;
+
+	if (NULL_PTR == pstCache)
+	{
+		return;
+	}
+
+	if (NULL_PTR != pstCache->pstEntries)
+	{
+		for (i = 0; i < pstCache->noOfRows; i++)
+		{
+			free(pstCache->pstEntries[i].piRow);
+		}
+	}
+
+	pthread_mutex_destroy(&pstCache->lock);
+	free(pstCache->pstEntries);
+	free(pstCache->piBuckets);
+	free(pstCache);
+}
+
+/* Returns a cache holding as many rows of noOfVertex distances as fit in maxBytes. Row
+buffers are allocated as the cache fills. Returns NULL on failure */
+RowCache* createRowCache(int noOfVertex, long long maxBytes)
+{
+	RowCache *pstCache = NULL_PTR;
+	long long maxRows = maxBytes / ((long long)sizeof(int) * noOfVertex);
+	int noOfBuckets = 1, i;
+
+	if ((noOfVertex <= 0) || (maxRows < 1))
+	{
+		myLog(ERROR, "[%lld] bytes do not hold one row of [%d] vertices!", maxBytes, noOfVertex);
+		return NULL_PTR;
+	}
+
+	/* No point in more rows than sources */
+	maxRows = MIN(maxRows, noOfVertex);
+
+	while (noOfBuckets < 2 * maxRows)
+	{
+		noOfBuckets *= 2;
+	}
+
+	pstCache = (RowCache *)calloc(1, sizeof(RowCache));
+	if (NULL_PTR == pstCache)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pthread_mutex_init(&pstCache->lock, NULL);
+	pstCache->noOfVertex = noOfVertex;
+	pstCache->maxRows = (int)maxRows;
+	pstCache->bucketMask = noOfBuckets - 1;
+	pstCache->head = ROW_CACHE_NONE;
+	pstCache->tail = ROW_CACHE_NONE;
+	pstCache->freeList = ROW_CACHE_NONE;
+	pstCache->piBuckets = (int *)malloc(sizeof(int) * noOfBuckets);
+	pstCache->pstEntries = (RowCacheEntry *)calloc(pstCache->maxRows, sizeof(RowCacheEntry));
+
+	if ((NULL_PTR == pstCache->piBuckets) || (NULL_PTR == pstCache->pstEntries))
+	{
+		myLog(ERROR, "Failed to allocate a cache of [%d] rows!", pstCache->maxRows);
+		destroyRowCache(pstCache);
+		return NULL_PTR;
+	}
+
+	for (i = 0; i < noOfBuckets; i++)
+	{
+		pstCache->piBuckets[i] = ROW_CACHE_NONE;
+	}
+
+	return pstCache;
+}
+
+/* Bucket of a source. Multiplicative hashing spreads runs of close sources */
+int getRowCacheBucket(RowCache *pstCache, int source)
+{
+	return (int)(((unsigned int)source * 2654435761u) >> 7) & pstCache->bucketMask;
+}
+
+/* Returns the entry of source, ROW_CACHE_NONE if it is not cached. Called under the lock */
+int findRowCacheEntry(RowCache *pstCache, int source)
+{
+	int entry;
+
+	for (entry = pstCache->piBuckets[getRowCacheBucket(pstCache, source)]; ROW_CACHE_NONE != entry;
+		entry = pstCache->pstEntries[entry].hashNext)
+	{
+		if (source == pstCache->pstEntries[entry].source)
+		{
+			break;
+		}
+	}
+
+	return entry;
+}
+
+/* Takes an entry out of the LRU list. Called under the lock */
+void unlinkRowCacheEntry(RowCache *pstCache, int entry)
+{
+	RowCacheEntry *pstEntry = &pstCache->pstEntries[entry];
+
+	if (ROW_CACHE_NONE != pstEntry->prev)
+	{
+		pstCache->pstEntries[pstEntry->prev].next = pstEntry->next;
+	}
+	else
+	{
+		pstCache->head = pstEntry->next;
+	}
+
+	if (ROW_CACHE_NONE != pstEntry->next)
+	{
+		pstCache->pstEntries[pstEntry->next].prev = pstEntry->prev;
+	}
+	else
+	{
+		pstCache->tail = pstEntry->prev;
+	}
+}
+
+/* Puts an entry at the most recently used end. Called under the lock */
+void pushRowCacheEntry(RowCache *pstCache, int entry)
+{
+	RowCacheEntry *pstEntry = &pstCache->pstEntries[entry];
+
+	pstEntry->prev = ROW_CACHE_NONE;
+	pstEntry->next = pstCache->head;
+
+	if (ROW_CACHE_NONE != pstCache->head)
+	{
+		pstCache->pstEntries[pstCache->head].prev = entry;
+	}
+	else
+	{
+		pstCache->tail = entry;
+	}
+
+	pstCache->head = entry;
+}
+
+/* Drops the row of an unpinned entry: out of its bucket and the LRU list, onto the free
+list. Called under the lock */
+void dropRowCacheEntry(RowCache *pstCache, int entry)
+{
+	int *piLink = &pstCache->piBuckets[getRowCacheBucket(pstCache, pstCache->pstEntries[entry].source)];
+
+	while (entry != *piLink)
+	{
+		piLink = &pstCache->pstEntries[*piLink].hashNext;
+	}
+
+	*piLink = pstCache->pstEntries[entry].hashNext;
+
+	unlinkRowCacheEntry(pstCache, entry);
+
+	pstCache->pstEntries[entry].source = ROW_CACHE_NONE;
+	pstCache->pstEntries[entry].next = pstCache->freeList;
+	pstCache->freeList = entry;
+}
+
+/* Looks up the row of source. On a hit the entry is pinned and its row returned, and
+entry gets what rowCacheRelease needs. A row of an older graph version is dropped and
+counts as a miss. Returns NULL on a miss */
+int* rowCacheAcquire(RowCache *pstCache, int source, int *entry)
+{
+	int *piRow = NULL_PTR;
+	int found;
+
+	pthread_mutex_lock(&pstCache->lock);
+
+	found = findRowCacheEntry(pstCache, source);
+	if ((ROW_CACHE_NONE != found) && (gGraphVersion != pstCache->pstEntries[found].version))
+	{
+		pstCache->invalidations++;
+
+		/* A pinned stale row goes when its last reader is done with it */
+		if (0 == pstCache->pstEntries[found].pinCount)
+		{
+			dropRowCacheEntry(pstCache, found);
+		}
+		found = ROW_CACHE_NONE;
+	}
+
+	if (ROW_CACHE_NONE != found)
+	{
+		pstCache->pstEntries[found].pinCount++;
+		unlinkRowCacheEntry(pstCache, found);
+		pushRowCacheEntry(pstCache, found);
+		pstCache->hits++;
+
+		piRow = pstCache->pstEntries[found].piRow;
+		*entry = found;
+	}
+	else
+	{
+		pstCache->misses++;
+	}
+
+	pthread_mutex_unlock(&pstCache->lock);
+
+	return piRow;
+}
+
+/* Unpins an entry returned by rowCacheAcquire. A row which went stale meanwhile is dropped */
+void rowCacheRelease(RowCache *pstCache, int entry)
+{
+	pthread_mutex_lock(&pstCache->lock);
+
+	pstCache->pstEntries[entry].pinCount--;
+	if ((0 == pstCache->pstEntries[entry].pinCount)
+		&& (gGraphVersion != pstCache->pstEntries[entry].version))
+	{
+		dropRowCacheEntry(pstCache, entry);
+	}
+
+	pthread_mutex_unlock(&pstCache->lock);
+}
+
+/* Returns an entry which can take a new row: a free one, a new one while under the bound,
+else the least recently used unpinned one. ROW_CACHE_NONE if every row is pinned or the
+buffer could not be allocated. Called under the lock */
+int getFreeRowCacheEntry(RowCache *pstCache)
+{
+	int entry;
+
+	if (ROW_CACHE_NONE != pstCache->freeList)
+	{
+		entry = pstCache->freeList;
+		pstCache->freeList = pstCache->pstEntries[entry].next;
+		return entry;
+	}
+
+	if (pstCache->noOfRows < pstCache->maxRows)
+	{
+		entry = pstCache->noOfRows;
+		pstCache->pstEntries[entry].piRow = (int *)malloc(sizeof(int) * pstCache->noOfVertex);
+		if (NULL_PTR == pstCache->pstEntries[entry].piRow)
+		{
+			myLog(ERROR, "malloc failed!");
+			return ROW_CACHE_NONE;
+		}
+
+		pstCache->noOfRows++;
+		return entry;
+	}
+
+	for (entry = pstCache->tail; ROW_CACHE_NONE != entry; entry = pstCache->pstEntries[entry].prev)
+	{
+		if (0 == pstCache->pstEntries[entry].pinCount)
+		{
+			pstCache->evictions++;
+			dropRowCacheEntry(pstCache, entry);
+
+			pstCache->freeList = pstCache->pstEntries[entry].next;
+			return entry;
+		}
+	}
+
+	return ROW_CACHE_NONE;
+}
+
+/* Stores a copy of the row of source computed on graph version. A row which is already
+stale, or already cached by another thread, is not stored. Caching is best effort, so
+running out of rows is not a failure */
+void rowCachePut(RowCache *pstCache, int source, int version, int *piRow)
+{
+	RowCacheEntry *pstEntry = NULL_PTR;
+	int entry, bucket;
+
+	pthread_mutex_lock(&pstCache->lock);
+
+	entry = findRowCacheEntry(pstCache, source);
+	if ((ROW_CACHE_NONE != entry) && (0 == pstCache->pstEntries[entry].pinCount)
+		&& (gGraphVersion != pstCache->pstEntries[entry].version))
+	{
+		dropRowCacheEntry(pstCache, entry);
+		entry = ROW_CACHE_NONE;
+	}
+
+	if ((version != gGraphVersion) || (ROW_CACHE_NONE != entry)
+		|| (ROW_CACHE_NONE == (entry = getFreeRowCacheEntry(pstCache))))
+	{
+		pthread_mutex_unlock(&pstCache->lock);
+		return;
+	}
+
+	pstEntry = &pstCache->pstEntries[entry];
+	pstEntry->source = source;
+	pstEntry->version = version;
+	pstEntry->pinCount = 0;
+	(void)memcpy(pstEntry->piRow, piRow, sizeof(int) * pstCache->noOfVertex);
+
+	bucket = getRowCacheBucket(pstCache, source);
+	pstEntry->hashNext = pstCache->piBuckets[bucket];
+	pstCache->piBuckets[bucket] = entry;
+	pushRowCacheEntry(pstCache, entry);
+
+	pthread_mutex_unlock(&pstCache->lock);
+}
+
+/* Returns the distance from source to target, answered from the cached row of source if
+there is a fresh one. Otherwise the whole row is computed and cached. INFINITY if target is
+not reachable and ERR on failure */
+int ssspCachedPointToPoint(RowCache *pstCache, SsspWorkspace *pstWorkspace, AdjList *pstAdjList,
+	int source, int target)
+{
+	int *piRow = NULL_PTR;
+	int entry, distance, version;
+
+	if ((target < 0) || (target >= pstCache->noOfVertex))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	piRow = rowCacheAcquire(pstCache, source, &entry);
+	if (NULL_PTR != piRow)
+	{
+		distance = piRow[target];
+		rowCacheRelease(pstCache, entry);
+		return distance;
+	}
+
+	/* Read before the search, so a change during it leaves the row stale */
+	version = gGraphVersion;
+
+	if (OK != ssspComputeRow(pstWorkspace, pstAdjList, source))
+	{
+		myLog(ERROR, "ssspComputeRow failed!");
+		return ERR;
+	}
+
+	rowCachePut(pstCache, source, version, pstWorkspace->piDist);
+
+	return pstWorkspace->piDist[target];
+}
+
+/* Worker loop. Takes the next query until all are answered */
+void* rowCacheWorker(void *pArg)
+{
+	RowCacheCtx *pstCtx = (RowCacheCtx *)pArg;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int query, distance;
+
+	pstWorkspace = createSsspWorkspace(pstCtx->scheme, gNoOfVertex);
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+		pstCtx->hasFailed = TRUE;
+		return NULL_PTR;
+	}
+
+	while (FALSE == pstCtx->hasFailed)
+	{
+		query = __sync_fetch_and_add(&pstCtx->nextQuery, 1);
+		if (query >= pstCtx->noOfQueries)
+		{
+			break;
+		}
+
+		if (NULL_PTR == pstCtx->pstCache)
+		{
+			distance = ssspPointToPoint(pstWorkspace, pstCtx->pstAdjList,
+				pstCtx->piSources[query], pstCtx->piTargets[query]);
+		}
+		else
+		{
+			distance = ssspCachedPointToPoint(pstCtx->pstCache, pstWorkspace, pstCtx->pstAdjList,
+				pstCtx->piSources[query], pstCtx->piTargets[query]);
+		}
+
+		if (ERR == distance)
+		{
+			myLog(ERROR, "Query [%d] failed!", query);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+
+		pstCtx->piDistances[query] = distance;
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+
+	return NULL_PTR;
+}
+
+/* Answers every query of pstCtx with noOfThreads workers into piDistances, through
+pstCache unless it is NULL. Returns the
+time taken in msec, INVALID_TIME on failure */
+int runRowCacheQueries(RowCacheCtx *pstCtx, int *piDistances, RowCache *pstCache, int noOfThreads)
+{
+	pthread_t aThreads[MAX_WORKER_THREADS];
+	long long startTime;
+	int i, noOfStarted = 0;
+
+	pstCtx->pstCache = pstCache;
+	pstCtx->piDistances = piDistances;
+	pstCtx->nextQuery = 0;
+	pstCtx->hasFailed = FALSE;
+
+	startTime = getWallTimeMsec();
+
+	for (i = 0; i < noOfThreads; i++)
+	{
+		if (0 != pthread_create(&aThreads[i], NULL, rowCacheWorker, pstCtx))
+		{
+			myLog(ERROR, "pthread_create failed for worker [%d]!", i);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+		noOfStarted++;
+	}
+
+	for (i = 0; i < noOfStarted; i++)
+	{
+		pthread_join(aThreads[i], NULL);
+	}
+
+	if (TRUE == pstCtx->hasFailed)
+	{
+		return INVALID_TIME;
+	}
+
+	return (int)(getWallTimeMsec() - startTime);
+}
+
+/* Sets the weights given as "u v weight" lines in fileName. Returns the number of edges
+changed, ERR on failure */
+int applyAdjListUpdates(AdjList *pstAdjList, char *fileName)
+{
+	FILE *pFile = NULL_PTR;
+	char fileLine[128];
+	int u, v, distance, found, total = 0;
+
+	pFile = fopen(fileName, "r");
+	if (NULL_PTR == pFile)
+	{
+		myLog(ERROR, "Could not open [%s]!", fileName);
+		return ERR;
+	}
+
+	while (NULL_PTR != fgets(fileLine, sizeof(fileLine), pFile))
+	{
+		if (3 != sscanf(fileLine, "%d %d %d", &u, &v, &distance))
+		{
+			continue;
+		}
+
+		found = setAdjListWeight(pstAdjList, u, v, distance);
+		if (ERR == found)
+		{
+			fclose(pFile);
+			return ERR;
+		}
+
+		total += found;
+	}
+
+	fclose(pFile);
+
+	return total;
+}
+
+/* Runs the queries once without and once with the cache, and checks that the answers
+match. The cache keeps its rows from earlier rounds */
+int runRowCacheRound(RowCacheCtx *pstCtx, RowCache *pstCache, int noOfThreads, int *piExpected,
+	int *piAnswers)
+{
+	long long hits = pstCache->hits, misses = pstCache->misses;
+	long long evictions = pstCache->evictions, invalidations = pstCache->invalidations;
+	int plainMsec, cachedMsec, i, noOfMismatches = 0;
+
+	plainMsec = runRowCacheQueries(pstCtx, piExpected, NULL_PTR, noOfThreads);
+	if (INVALID_TIME == plainMsec)
+	{
+		return ERR;
+	}
+
+	cachedMsec = runRowCacheQueries(pstCtx, piAnswers, pstCache, noOfThreads);
+	if (INVALID_TIME == cachedMsec)
+	{
+		return ERR;
+	}
+
+	for (i = 0; i < pstCtx->noOfQueries; i++)
+	{
+		noOfMismatches += (piExpected[i] != piAnswers[i]);
+	}
+
+	hits = pstCache->hits - hits;
+	misses = pstCache->misses - misses;
+
+	printf("Graph version [%d]: plain [%d] msec, cached [%d] msec\n"
+		"Hits [%lld] misses [%lld] hit rate [%.1f%%], evicted [%lld], stale [%lld], rows [%d]\n",
+		gGraphVersion, plainMsec, cachedMsec, hits, misses,
+		(hits + misses > 0) ? ((100.0 * hits) / (hits + misses)) : 0.0,
+		pstCache->evictions - evictions, pstCache->invalidations - invalidations, pstCache->noOfRows);
+
+	if (noOfMismatches > 0)
+	{
+		myLog(ERROR, "[%d] cached answers differ from the plain search!", noOfMismatches);
+		return ERR;
+	}
+
+	return OK;
+}
+
+/* Entry function for the row cache mode. Answers queries whose sources mostly come from a
+small hot set, with plain point to point searches and through a cache of cacheMB. With an
+update file the weights are changed afterwards and the queries repeated on the same cache */
+int rowCacheProc(int scheme, char *fileName, char *queriesArg, char *cacheArg,
+	char *threadsArg, char *updateFile)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	RowCache *pstCache = NULL_PTR;
+	RowCacheCtx stCtx;
+	int aHotSources[ROW_CACHE_HOT_SOURCES];
+	int *piExpected = NULL_PTR, *piAnswers = NULL_PTR;
+	int i, noOfQueries = DEFAULT_ROW_CACHE_QUERIES, cacheMb = DEFAULT_ROW_CACHE_MB;
+	int noOfThreads, noOfChanged, retVal = OK;
+
+	if (NULL_PTR != queriesArg)
+	{
+		noOfQueries = atoi(queriesArg);
+	}
+
+	if (NULL_PTR != cacheArg)
+	{
+		cacheMb = atoi(cacheArg);
+	}
+
+	if ((noOfQueries <= 0) || (cacheMb <= 0))
+	{
+		myLog(ERROR, "Invalid Input! Queries and cache size must be positive");
+		return ERR;
+	}
+
+	noOfThreads = getWorkerThreadCount(threadsArg);
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	(void)memset(&stCtx, 0, sizeof(stCtx));
+	stCtx.scheme = scheme;
+	stCtx.pstAdjList = pstAdjList;
+	stCtx.noOfQueries = noOfQueries;
+	stCtx.piSources = (int *)malloc(sizeof(int) * noOfQueries);
+	stCtx.piTargets = (int *)malloc(sizeof(int) * noOfQueries);
+	piAnswers = (int *)malloc(sizeof(int) * noOfQueries);
+	piExpected = (int *)malloc(sizeof(int) * noOfQueries);
+	pstCache = createRowCache(gNoOfVertex, (long long)cacheMb * 1024 * 1024);
+
+	if ((NULL_PTR == stCtx.piSources) || (NULL_PTR == stCtx.piTargets)
+		|| (NULL_PTR == piAnswers) || (NULL_PTR == piExpected) || (NULL_PTR == pstCache))
+	{
+		myLog(ERROR, "Failed to allocate [%d] queries!", noOfQueries);
+		retVal = ERR;
+	}
+
+	if (OK == retVal)
+	{
+		srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+		for (i = 0; i < ROW_CACHE_HOT_SOURCES; i++)
+		{
+			aHotSources[i] = rand() % gNoOfVertex;
+		}
+
+		for (i = 0; i < noOfQueries; i++)
+		{
+			stCtx.piSources[i] = (rand() % 100 < ROW_CACHE_HOT_PERCENT)
+				? aHotSources[rand() % ROW_CACHE_HOT_SOURCES] : (rand() % gNoOfVertex);
+			stCtx.piTargets[i] = rand() % gNoOfVertex;
+		}
+
+		printf("\n%s: [%d] queries, [%d%%] from [%d] hot sources, [%d] threads, cache [%d] MB ([%d] rows)\n",
+			schemeString[scheme], noOfQueries, ROW_CACHE_HOT_PERCENT, ROW_CACHE_HOT_SOURCES,
+			noOfThreads, cacheMb, pstCache->maxRows);
+
+		retVal = runRowCacheRound(&stCtx, pstCache, noOfThreads, piExpected, piAnswers);
+	}
+
+	if ((OK == retVal) && (NULL_PTR != updateFile))
+	{
+		noOfChanged = applyAdjListUpdates(pstAdjList, updateFile);
+		if (ERR == noOfChanged)
+		{
+			retVal = ERR;
+		}
+		else
+		{
+			printf("[%d] weights changed\n", noOfChanged);
+			retVal = runRowCacheRound(&stCtx, pstCache, noOfThreads, piExpected, piAnswers);
+		}
+	}
+
+	destroyRowCache(pstCache);
+	free(piExpected);
+	free(stCtx.piSources);
+	free(stCtx.piTargets);
+	free(piAnswers);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
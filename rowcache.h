@@ -0,0 +1,50 @@
+/***************************************************************************************************/
+// ROWCACHE.H
+// Contains the LRU cache of distance rows for repeated sources
+/***************************************************************************************************/
+
+#ifndef __ROWCACHE__
+#define __ROWCACHE__
+
+#include <pthread.h>
+#include "header.h"
+
+#define DEFAULT_ROW_CACHE_MB 64
+#define DEFAULT_ROW_CACHE_QUERIES 10000
+#define ROW_CACHE_HOT_SOURCES 100 // Sources which get most of the benchmark queries
+#define ROW_CACHE_HOT_PERCENT 90
+#define ROW_CACHE_NONE -1 // End of the LRU, bucket and free lists
+
+/* One cached row. An entry is in the hash and the LRU list while it holds a row */
+typedef struct RowCacheEntry
+{
+	int source;
+	int version; // gGraphVersion when the row was computed. Stale once they differ
+	int pinCount; // Readers using piRow. A pinned entry is never evicted or reused
+	int prev; // LRU list, most recently used first
+	int next; // LRU list, or the free list
+	int hashNext; // Next entry of the same bucket
+	int *piRow;
+}RowCacheEntry;
+
+/* The cache. Every field is guarded by lock. A hit pins the entry, so the row can be read
+after the lock is released while other threads look up and insert */
+typedef struct RowCache
+{
+	pthread_mutex_t lock;
+	int noOfVertex;
+	int maxRows; // From the memory bound
+	int noOfRows; // Entries holding a row buffer so far
+	int bucketMask; // Buckets are a power of two
+	int *piBuckets;
+	RowCacheEntry *pstEntries;
+	int head;
+	int tail;
+	int freeList; // Entries with a buffer but no row
+	long long hits;
+	long long misses;
+	long long evictions;
+	long long invalidations; // Rows dropped because the graph changed
+}RowCache;
+
+#endif
@@ -0,0 +1,355 @@
+/***************************************************************************************************/
+// SHMPUB.C
+// Contains all functions for publishing the distance matrix through POSIX shared memory
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shmpub.h"
+
+extern int gNoOfVertex;
+extern int dist[MAX_VERTEX_NUM][MAX_VERTEX_NUM];
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+
+/* Copies dist[][] into the named segment, creating or growing it if needed. Readers that
+already have the segment mapped see the generation go odd while the copy is in progress */
+int publishDistMatrix(char *shmName, int scheme, int timeMsec)
+{
+	DistShmHeader *pstShmHeader = NULL_PTR;
+	struct stat stShmStat;
+	long long segmentSize;
+	unsigned int generation;
+	int shmFd, i;
+
+	if (NULL_PTR == shmName)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	segmentSize = DIST_SHM_SIZE(gNoOfVertex);
+
+	shmFd = shm_open(shmName, O_CREAT | O_RDWR, 0644);
+	if (shmFd < 0)
+	{
+		myLog(ERROR, "shm_open of [%s] failed!", shmName);
+		return ERR;
+	}
+
+	/* Only ever grow the segment, readers may still have the old size mapped */
+	if (0 != fstat(shmFd, &stShmStat))
+	{
+		myLog(ERROR, "fstat of [%s] failed!", shmName);
+		close(shmFd);
+		return ERR;
+	}
+
+	if (stShmStat.st_size < segmentSize)
+	{
+		if (0 != ftruncate(shmFd, segmentSize))
+		{
+			myLog(ERROR, "Could not size [%s] to [%lld] bytes!", shmName, segmentSize);
+			close(shmFd);
+			return ERR;
+		}
+	}
+	else
+	{
+		segmentSize = stShmStat.st_size;
+	}
+
+	pstShmHeader = (DistShmHeader *)mmap(NULL, (size_t)segmentSize,
+		PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+	close(shmFd);
+	if (MAP_FAILED == (void *)pstShmHeader)
+	{
+		myLog(ERROR, "mmap of [%s] failed!", shmName);
+		return ERR;
+	}
+
+	/* A fresh segment is all zeros, which is a valid even generation */
+	if (DIST_SHM_MAGIC != pstShmHeader->magic)
+	{
+		pstShmHeader->generation = 0;
+		pstShmHeader->version = DIST_SHM_VERSION;
+		__sync_synchronize();
+		pstShmHeader->magic = DIST_SHM_MAGIC;
+	}
+
+	/* Enter the write side of the seqlock */
+	generation = pstShmHeader->generation;
+	if (generation & 1)
+	{
+		/* A previous publisher died half way. Its data is garbage anyway */
+		generation++;
+	}
+	pstShmHeader->generation = generation + 1;
+	__sync_synchronize();
+
+	pstShmHeader->noOfVertex = gNoOfVertex;
+	pstShmHeader->scheme = scheme;
+	pstShmHeader->timeMsec = timeMsec;
+	pstShmHeader->segmentSize = segmentSize;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		(void)memcpy(DIST_SHM_ROW(pstShmHeader, i), dist[i], sizeof(int) * gNoOfVertex);
+	}
+
+	/* Leave the write side, the new matrix becomes visible as a whole */
+	__sync_synchronize();
+	pstShmHeader->generation = generation + 2;
+
+	myLog(INFO, "Published [%d]x[%d] distance matrix to [%s], generation [%u]",
+		gNoOfVertex, gNoOfVertex, shmName, generation + 2);
+
+	(void)munmap(pstShmHeader, (size_t)segmentSize);
+
+	return OK;
+}
+
+/* Maps the named segment read-only. size gets the mapped length which a reader should
+compare against segmentSize to find out if the publisher grew the segment */
+DistShmHeader* openDistShm(char *shmName, long long *size)
+{
+	DistShmHeader *pstShmHeader = NULL_PTR;
+	struct stat stShmStat;
+	int shmFd;
+
+	if ((NULL_PTR == shmName) || (NULL_PTR == size))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return NULL_PTR;
+	}
+
+	shmFd = shm_open(shmName, O_RDONLY, 0);
+	if (shmFd < 0)
+	{
+		myLog(ERROR, "Segment [%s] is not published!", shmName);
+		return NULL_PTR;
+	}
+
+	if ((0 != fstat(shmFd, &stShmStat))
+		|| (stShmStat.st_size < (off_t)sizeof(DistShmHeader)))
+	{
+		myLog(ERROR, "Segment [%s] is too small!", shmName);
+		close(shmFd);
+		return NULL_PTR;
+	}
+
+	*size = stShmStat.st_size;
+	pstShmHeader = (DistShmHeader *)mmap(NULL, (size_t)*size, PROT_READ, MAP_SHARED, shmFd, 0);
+	close(shmFd);
+	if (MAP_FAILED == (void *)pstShmHeader)
+	{
+		myLog(ERROR, "mmap of [%s] failed!", shmName);
+		return NULL_PTR;
+	}
+
+	if (DIST_SHM_MAGIC != pstShmHeader->magic)
+	{
+		myLog(ERROR, "Segment [%s] has not been published yet!", shmName);
+		(void)munmap(pstShmHeader, (size_t)*size);
+		return NULL_PTR;
+	}
+
+	return pstShmHeader;
+}
+
+/* Unmaps a segment returned by openDistShm() */
+void closeDistShm(DistShmHeader *pstShmHeader, long long size)
+{
+	if (NULL_PTR != pstShmHeader)
+	{
+		(void)munmap(pstShmHeader, (size_t)size);
+	}
+}
+
+/* Start of a read. Waits until no publish is in progress and returns the generation */
+unsigned int distShmReadBegin(DistShmHeader *pstShmHeader)
+{
+	unsigned int generation;
+
+	while ((generation = pstShmHeader->generation) & 1)
+	{
+		(void)usleep(100);
+	}
+
+	__sync_synchronize();
+
+	return generation;
+}
+
+/* End of a read. Returns TRUE if everything read since distShmReadBegin() belongs to
+that generation, FALSE if the reader has to retry */
+int distShmReadValid(DistShmHeader *pstShmHeader, unsigned int generation)
+{
+	__sync_synchronize();
+
+	return (generation == pstShmHeader->generation);
+}
+
+/* A consumer: prints the published matrix. Also serves as an example for other readers.
+The header and the matrix are copied out under the seqlock and only printed once the copy
+is known to be of one generation */
+int printDistShm(char *shmName)
+{
+	DistShmHeader *pstShmHeader = NULL_PTR;
+	long long size;
+	unsigned int generation;
+	int i, j, noOfVertex, scheme, timeMsec, capacity = 0, *piMatrix = NULL_PTR, *piRow;
+
+	if (NULL_PTR == shmName)
+	{
+		shmName = DIST_SHM_DEFAULT_NAME;
+	}
+
+	pstShmHeader = openDistShm(shmName, &size);
+	if (NULL_PTR == pstShmHeader)
+	{
+		myLog(ERROR, "openDistShm failed!");
+		return ERR;
+	}
+
+	while (TRUE)
+	{
+		generation = distShmReadBegin(pstShmHeader);
+
+		/* The publisher grew the segment past our mapping, map it again */
+		if (pstShmHeader->segmentSize > size)
+		{
+			closeDistShm(pstShmHeader, size);
+			pstShmHeader = openDistShm(shmName, &size);
+			if (NULL_PTR == pstShmHeader)
+			{
+				myLog(ERROR, "openDistShm failed!");
+				free(piMatrix);
+				return ERR;
+			}
+			continue;
+		}
+
+		noOfVertex = pstShmHeader->noOfVertex;
+		scheme = pstShmHeader->scheme;
+		timeMsec = pstShmHeader->timeMsec;
+
+		/* A publish may have changed noOfVertex since segmentSize was read. Never read rows
+		past the mapping, a torn header just means reading again */
+		if ((noOfVertex < 0) || (DIST_SHM_SIZE(noOfVertex) > size))
+		{
+			if (TRUE == distShmReadValid(pstShmHeader, generation))
+			{
+				myLog(ERROR, "Segment [%s] claims [%d] vertices but maps only [%lld] bytes!",
+					shmName, noOfVertex, size);
+				closeDistShm(pstShmHeader, size);
+				free(piMatrix);
+				return ERR;
+			}
+			continue;
+		}
+
+		if (noOfVertex > capacity)
+		{
+			free(piMatrix);
+			piMatrix = (int *)malloc(sizeof(int) * noOfVertex * noOfVertex);
+			if (NULL_PTR == piMatrix)
+			{
+				myLog(ERROR, "malloc failed!");
+				closeDistShm(pstShmHeader, size);
+				return ERR;
+			}
+			capacity = noOfVertex;
+		}
+
+		(void)memcpy(piMatrix, DIST_SHM_ROW(pstShmHeader, 0), sizeof(int) * noOfVertex * noOfVertex);
+
+		if (TRUE == distShmReadValid(pstShmHeader, generation))
+		{
+			break;
+		}
+
+		myLog(INFO, "Generation changed while reading, reading again");
+	}
+
+	closeDistShm(pstShmHeader, size);
+
+	printf("\nGeneration: [%u] Scheme: [%s] Time: [%d] msec\n", generation,
+		((scheme >= 0) && (scheme < TOTAL_SCHEMES)) ? schemeString[scheme] : "UNKNOWN", timeMsec);
+
+	printf("\nNodes");
+	for (i = 0; i < noOfVertex; i++)
+	{
+		printf("\t%d", i);
+	}
+	printf("\n");
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		piRow = piMatrix + ((long long)i * noOfVertex);
+
+		printf("\n%d   |\t", i);
+		for (j = 0; j < noOfVertex; j++)
+		{
+			if (INFINITY == piRow[j])
+			{
+				printf("-\t");
+			}
+			else
+			{
+				printf("%d\t", piRow[j]);
+			}
+		}
+	}
+	printf("\n\n");
+
+	free(piMatrix);
+
+	return OK;
+}
+
+/* Entry function for publish mode. Runs the scheme on the graph in fileName and publishes
+the result under shmName */
+int publishProc(int scheme, char *fileName, char *shmName)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	int timeMsec;
+
+	if (NULL_PTR == shmName)
+	{
+		shmName = DIST_SHM_DEFAULT_NAME;
+	}
+
+	/* The schemes fill the static dist[][] */
+	pstAdjList = loadAdjListFromFile(fileName, MAX_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	timeMsec = runSchemeOnAdjList(scheme, pstAdjList);
+	destroyAdjList(pstAdjList);
+
+	if (INVALID_TIME == timeMsec)
+	{
+		myLog(ERROR, "runSchemeOnAdjList failed!");
+		return ERR;
+	}
+
+	if (OK != publishDistMatrix(shmName, scheme, timeMsec))
+	{
+		myLog(ERROR, "publishDistMatrix failed!");
+		return ERR;
+	}
+
+	printf("Published [%d] vertices from %s to [%s]\n",
+		gNoOfVertex, schemeString[scheme], shmName);
+
+	return OK;
+}
@@ -0,0 +1,39 @@
+/***************************************************************************************************/
+// SHMPUB.H
+// Contains the layout of the distance matrix published through POSIX shared memory
+/***************************************************************************************************/
+
+#ifndef __SHMPUB__
+#define __SHMPUB__
+
+#include "header.h"
+
+#define DIST_SHM_DEFAULT_NAME "/dijkstra_dist"
+#define DIST_SHM_MAGIC 0x534B4A44 // "DJKS"
+#define DIST_SHM_VERSION 1
+
+/* The segment is this header followed by int dist[noOfVertex][noOfVertex] in row major order.
+generation works as a seqlock: the publisher makes it odd before touching the matrix and
+even again once the matrix is complete. A reader takes a snapshot of an even generation,
+copies what it needs out of the segment and only uses the copy if the generation did not
+move in the meantime */
+typedef struct DistShmHeader
+{
+	int magic;
+	int version;
+	volatile unsigned int generation;
+	int noOfVertex;
+	int scheme; // BINARY_SCHEME / BINO_SCHEME / FIBO_SCHEME
+	int timeMsec; // Time taken by the scheme for this generation
+	long long segmentSize; // Bytes mapped by the publisher
+}DistShmHeader;
+
+/* Bytes of a segment holding a noOfVertex x noOfVertex matrix */
+#define DIST_SHM_SIZE(noOfVertex) \
+	((long long)sizeof(DistShmHeader) + ((long long)sizeof(int) * (noOfVertex) * (noOfVertex)))
+
+/* Address of a row of the published matrix */
+#define DIST_SHM_ROW(pstShmHeader, row) \
+	((int *)((char *)(pstShmHeader) + sizeof(DistShmHeader)) + ((long long)(row) * (pstShmHeader)->noOfVertex))
+
+#endif
@@ -161,6 +161,85 @@ int isInMinHeap(struct MinHeap *minHeap, int v)
    return 0;
 }
 
+// Inserts vertex v with the given dist at the bottom of the heap and moves it up.
+// Used when the heap is filled on demand instead of with all vertices upfront
+int minHeapInsert(struct MinHeap* minHeap, int v, int dist)
+{
+    struct MinHeapNode* minHeapNode;
+
+    if (minHeap->size >= minHeap->capacity)
+        return ERR;
+
+    minHeapNode = newMinHeapNode(v, dist);
+    if (NULL == minHeapNode)
+        return ERR;
+
+    minHeap->array[minHeap->size] = minHeapNode;
+    minHeap->pos[v] = minHeap->size;
+    ++minHeap->size;
+
+    // Same sift up as a decrease key from the current value
+    decreaseKey(minHeap, v, dist);
+
+    return OK;
+}
+
+// Removes the minimum node and hands out its vertex and dist, like binoRemoveMin()
+int minHeapRemoveMin(struct MinHeap* minHeap, int *vertex, int *distance)
+{
+    struct MinHeapNode* minHeapNode = extractMin(minHeap);
+
+    if (NULL == minHeapNode)
+        return ERR;
+
+    *vertex = minHeapNode->v;
+    *distance = minHeapNode->dist;
+    free(minHeapNode);
+
+    return OK;
+}
+
+// Returns the minimum node without removing it
+int minHeapPeekMin(struct MinHeap* minHeap, int *vertex, int *distance)
+{
+    if (isEmpty(minHeap))
+        return ERR;
+
+    *vertex = minHeap->array[0]->v;
+    *distance = minHeap->array[0]->dist;
+
+    return OK;
+}
+
+// Returns the dist of a vertex which is in the heap
+int minHeapGetKey(struct MinHeap* minHeap, int v)
+{
+    return minHeap->array[minHeap->pos[v]]->dist;
+}
+
+// Frees the nodes still in the heap and makes it empty
+void clearMinHeap(struct MinHeap* minHeap)
+{
+    int i;
+
+    for (i = 0; i < minHeap->size; ++i)
+        free(minHeap->array[i]);
+
+    minHeap->size = 0;
+}
+
+// Frees the heap and the nodes still in it
+void destroyMinHeap(struct MinHeap* minHeap)
+{
+    if (NULL == minHeap)
+        return;
+
+    clearMinHeap(minHeap);
+    free(minHeap->pos);
+    free(minHeap->array);
+    free(minHeap);
+}
+
 int binaryProc()
 {
 	int v1, v2, distance;
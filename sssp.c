@@ -0,0 +1,837 @@
+/***************************************************************************************************/
+// SSSP.C
+// Contains the single source shortest path engine shared by the binary, binomial and
+// fibonacci schemes. The distances go to a per workspace row instead of dist[][]
+/***************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "stream.h"
+#include "sssp.h"
+
+extern int gNoOfVertex;
+extern char *schemeString[TOTAL_SCHEMES];
+extern PQueue* createPQueue(int scheme, int noOfVertex);
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern AdjList* buildReverseAdjList(AdjList *pstAdjList);
+extern long long getWallTimeMsec();
+extern long long getWallTimeUsec();
+
+/* Frees the workspace */
+void destroySsspWorkspace(SsspWorkspace *pstWorkspace)
+{
+	if (NULL_PTR == pstWorkspace)
+	{
+		return;
+	}
+
+	destroyPQueue(pstWorkspace->pstQueue);
+	free(pstWorkspace->piDist);
+	free(pstWorkspace->pSettled);
+	free(pstWorkspace->piTouched);
+	free(pstWorkspace->piPredecessor);
+	free(pstWorkspace->pdPathCount);
+	free(pstWorkspace);
+}
+
+/* Returns a workspace for searches on a graph with noOfVertex vertices */
+SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex)
+{
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int i;
+
+	pstWorkspace = (SsspWorkspace *)calloc(1, sizeof(SsspWorkspace));
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstWorkspace->scheme = scheme;
+	pstWorkspace->noOfVertex = noOfVertex;
+	pstWorkspace->piDist = (int *)malloc(sizeof(int) * noOfVertex);
+	pstWorkspace->pSettled = (char *)calloc(noOfVertex, sizeof(char));
+	pstWorkspace->piTouched = (int *)malloc(sizeof(int) * noOfVertex);
+	pstWorkspace->pstQueue = createPQueue(scheme, noOfVertex);
+
+	if ((NULL_PTR == pstWorkspace->piDist)
+		|| (NULL_PTR == pstWorkspace->pSettled)
+		|| (NULL_PTR == pstWorkspace->piTouched)
+		|| (NULL_PTR == pstWorkspace->pstQueue))
+	{
+		myLog(ERROR, "Failed to allocate workspace for [%d] vertices!", noOfVertex);
+		destroySsspWorkspace(pstWorkspace);
+		return NULL_PTR;
+	}
+
+	for (i = 0; i < noOfVertex; i++)
+	{
+		pstWorkspace->piDist[i] = INFINITY;
+	}
+
+	return pstWorkspace;
+}
+
+/* Makes the following searches record the predecessor of every vertex they improve, so
+that their paths can be rebuilt. Costs one int per vertex. Returns OK or ERR */
+int ssspEnablePredecessors(SsspWorkspace *pstWorkspace)
+{
+	if (NULL_PTR == pstWorkspace->piPredecessor)
+	{
+		pstWorkspace->piPredecessor = (int *)malloc(sizeof(int) * pstWorkspace->noOfVertex);
+		if (NULL_PTR == pstWorkspace->piPredecessor)
+		{
+			myLog(ERROR, "malloc failed!");
+			return ERR;
+		}
+	}
+
+	return OK;
+}
+
+/* Makes the following searches count the shortest paths to every vertex, as a double since
+the counts grow exponentially on grids. A vertex gets the count of its settled neighbour
+when that neighbour improves it, and adds it when the neighbour ties. Together with the
+final distances this gives the shortest path DAG: (u, v) is on it if d(u) + w(u, v) = d(v).
+Costs one double per vertex. Returns OK or ERR */
+int ssspEnablePathCounts(SsspWorkspace *pstWorkspace)
+{
+	if (NULL_PTR == pstWorkspace->pdPathCount)
+	{
+		pstWorkspace->pdPathCount = (double *)malloc(sizeof(double) * pstWorkspace->noOfVertex);
+		if (NULL_PTR == pstWorkspace->pdPathCount)
+		{
+			myLog(ERROR, "malloc failed!");
+			return ERR;
+		}
+	}
+
+	return OK;
+}
+
+/* Turns the following searches into A* searches with the given potential. NULL goes
+back to plain Dijkstra */
+void ssspSetPotential(SsspWorkspace *pstWorkspace, SSSP_POTENTIAL_FN pfnPotential, void *pPotentialCtx)
+{
+	pstWorkspace->pfnPotential = pfnPotential;
+	pstWorkspace->pPotentialCtx = pPotentialCtx;
+}
+
+/* Puts the workspace back to its initial state. Only the touched entries are reset */
+void resetSsspWorkspace(SsspWorkspace *pstWorkspace)
+{
+	int i, vertex;
+
+	for (i = 0; i < pstWorkspace->noOfTouched; i++)
+	{
+		vertex = pstWorkspace->piTouched[i];
+		pstWorkspace->piDist[vertex] = INFINITY;
+		pstWorkspace->pSettled[vertex] = FALSE;
+	}
+
+	pstWorkspace->noOfTouched = 0;
+	pstWorkspace->noOfSettled = 0;
+
+	pqClear(pstWorkspace->pstQueue);
+}
+
+/* Sets the tentative distance of a vertex and queues it. Returns ERR on failure */
+int ssspRelax(SsspWorkspace *pstWorkspace, int vertex, int distance)
+{
+	if (distance >= pstWorkspace->piDist[vertex])
+	{
+		return OK;
+	}
+
+	if (INFINITY == pstWorkspace->piDist[vertex])
+	{
+		pstWorkspace->piTouched[pstWorkspace->noOfTouched++] = vertex;
+	}
+
+	pstWorkspace->piDist[vertex] = distance;
+
+	/* A* orders the queue by the distance plus the bound on the rest of the way */
+	if (NULL_PTR != pstWorkspace->pfnPotential)
+	{
+		distance += pstWorkspace->pfnPotential(pstWorkspace->pPotentialCtx, vertex);
+	}
+
+	if (ERR == pqUpdate(pstWorkspace->pstQueue, vertex, distance))
+	{
+		myLog(ERROR, "pqUpdate failed for vertex [%d]!", vertex);
+		return ERR;
+	}
+
+	return OK;
+}
+
+/* Settles the closest queued vertex and relaxes its edges. vertex gets the settled vertex.
+If pstOpposite is given it is a search over the reverse graph and every relaxed edge which
+reaches a vertex it has touched is offered to pstMeeting */
+int ssspSettleNext(SsspWorkspace *pstWorkspace, AdjList *pstAdjList,
+	SsspWorkspace *pstOpposite, SsspMeeting *pstMeeting, int *vertex)
+{
+	AdjList *pstListTraverser = NULL_PTR;
+	int closestVertex, distance, nextVertex, oppositeDistance;
+
+	if (OK != pqRemoveMin(pstWorkspace->pstQueue, &closestVertex, &distance))
+	{
+		myLog(ERROR, "pqRemoveMin failed!");
+		return ERR;
+	}
+
+	/* The key may include a potential */
+	distance = pstWorkspace->piDist[closestVertex];
+
+	pstWorkspace->pSettled[closestVertex] = TRUE;
+	pstWorkspace->noOfSettled++;
+	*vertex = closestVertex;
+
+	/* Relax the edges of the settled vertex. The weights come from the list, not
+	from dist[][] */
+	for (pstListTraverser = pstAdjList[closestVertex].next; NULL_PTR != pstListTraverser;
+		pstListTraverser = pstListTraverser->next)
+	{
+		nextVertex = pstListTraverser->vertexNum;
+
+		if (NULL_PTR != pstOpposite)
+		{
+			oppositeDistance = pstOpposite->piDist[nextVertex];
+			if ((INFINITY != oppositeDistance)
+				&& (distance + pstListTraverser->distance + oppositeDistance < pstMeeting->bestDistance))
+			{
+				pstMeeting->bestDistance = distance + pstListTraverser->distance + oppositeDistance;
+				pstMeeting->meetingVertex = nextVertex;
+			}
+		}
+
+		if (TRUE == pstWorkspace->pSettled[nextVertex])
+		{
+			continue;
+		}
+
+		if ((NULL_PTR != pstWorkspace->piPredecessor)
+			&& (distance + pstListTraverser->distance < pstWorkspace->piDist[nextVertex]))
+		{
+			pstWorkspace->piPredecessor[nextVertex] = closestVertex;
+		}
+
+		if (NULL_PTR != pstWorkspace->pdPathCount)
+		{
+			if (distance + pstListTraverser->distance < pstWorkspace->piDist[nextVertex])
+			{
+				pstWorkspace->pdPathCount[nextVertex] = pstWorkspace->pdPathCount[closestVertex];
+			}
+			else if (distance + pstListTraverser->distance == pstWorkspace->piDist[nextVertex])
+			{
+				pstWorkspace->pdPathCount[nextVertex] += pstWorkspace->pdPathCount[closestVertex];
+			}
+		}
+
+		if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstListTraverser->distance))
+		{
+			return ERR;
+		}
+	}
+
+	return OK;
+}
+
+/* Dijkstra from source. Stops as soon as target is settled, so only piDist[target] and the
+distances of the settled vertices are final. With SSSP_NO_TARGET every reachable vertex
+is settled */
+int ssspSearch(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int source, int target)
+{
+	int closestVertex;
+
+	if ((NULL_PTR == pstWorkspace) || (NULL_PTR == pstAdjList)
+		|| (source < 0) || (source >= pstWorkspace->noOfVertex)
+		|| (target < SSSP_NO_TARGET) || (target >= pstWorkspace->noOfVertex))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	resetSsspWorkspace(pstWorkspace);
+
+	if (OK != ssspRelax(pstWorkspace, source, 0))
+	{
+		return ERR;
+	}
+
+	if (NULL_PTR != pstWorkspace->pdPathCount)
+	{
+		pstWorkspace->pdPathCount[source] = 1;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != ssspSettleNext(pstWorkspace, pstAdjList, NULL_PTR, NULL_PTR, &closestVertex))
+		{
+			return ERR;
+		}
+
+		/* Nothing that is still in the queue can make the target closer */
+		if (target == closestVertex)
+		{
+			break;
+		}
+	}
+
+	return OK;
+}
+
+/* Bidirectional Dijkstra from source over pstAdjList and from target over its reverse
+pstReverseList. The side with the smaller queue minimum goes next, and the search stops
+once the two minimums add up to at least the best meeting. Returns the distance,
+INFINITY if target is not reachable and ERR on failure. The settled vertices of both
+sides are in the two workspaces, which must not have a potential */
+int ssspBidirectional(SsspWorkspace *pstForward, SsspWorkspace *pstBackward, AdjList *pstAdjList,
+	AdjList *pstReverseList, int source, int target, SsspMeeting *pstMeeting)
+{
+	int forwardKey, backwardKey, vertex;
+
+	if ((NULL_PTR == pstForward) || (NULL_PTR == pstBackward) || (NULL_PTR == pstAdjList)
+		|| (NULL_PTR == pstReverseList) || (NULL_PTR == pstMeeting)
+		|| (NULL_PTR != pstForward->pfnPotential) || (NULL_PTR != pstBackward->pfnPotential)
+		|| (source < 0) || (source >= pstForward->noOfVertex)
+		|| (target < 0) || (target >= pstForward->noOfVertex))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	resetSsspWorkspace(pstForward);
+	resetSsspWorkspace(pstBackward);
+
+	pstMeeting->bestDistance = (source == target) ? 0 : INFINITY;
+	pstMeeting->meetingVertex = (source == target) ? source : -1;
+
+	if ((OK != ssspRelax(pstForward, source, 0)) || (OK != ssspRelax(pstBackward, target, 0)))
+	{
+		return ERR;
+	}
+
+	while (TRUE)
+	{
+		/* An empty side has nothing left to offer */
+		if ((OK != pqPeekMin(pstForward->pstQueue, &vertex, &forwardKey))
+			|| (OK != pqPeekMin(pstBackward->pstQueue, &vertex, &backwardKey)))
+		{
+			break;
+		}
+
+		if (forwardKey + backwardKey >= pstMeeting->bestDistance)
+		{
+			break;
+		}
+
+		if (forwardKey <= backwardKey)
+		{
+			if (OK != ssspSettleNext(pstForward, pstAdjList, pstBackward, pstMeeting, &vertex))
+			{
+				return ERR;
+			}
+		}
+		else if (OK != ssspSettleNext(pstBackward, pstReverseList, pstForward, pstMeeting, &vertex))
+		{
+			return ERR;
+		}
+	}
+
+	return pstMeeting->bestDistance;
+}
+
+/* Computes the distances from source to every vertex into pstWorkspace->piDist */
+int ssspComputeRow(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int source)
+{
+	return ssspSearch(pstWorkspace, pstAdjList, source, SSSP_NO_TARGET);
+}
+
+/* Returns the distance from source to target, INFINITY if target is not reachable and
+ERR on failure */
+int ssspPointToPoint(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int source, int target)
+{
+	if ((target < 0) || (OK != ssspSearch(pstWorkspace, pstAdjList, source, target)))
+	{
+		myLog(ERROR, "ssspSearch failed!");
+		return ERR;
+	}
+
+	return pstWorkspace->piDist[target];
+}
+
+/* Rebuilds the path of the last search from source to target into piPath, source first,
+by walking the predecessors back from target: O(path length). Target must be settled, or
+at least reached. Returns the number of vertices on the path, 0 if target was not reached
+and ERR if the search did not record predecessors */
+int ssspGetPath(SsspWorkspace *pstWorkspace, int source, int target, int *piPath)
+{
+	int vertex, length = 0, i, swap;
+
+	if ((NULL_PTR == pstWorkspace->piPredecessor) || (NULL_PTR == piPath))
+	{
+		myLog(ERROR, "Predecessors are not enabled!");
+		return ERR;
+	}
+
+	if (INFINITY == pstWorkspace->piDist[target])
+	{
+		return 0;
+	}
+
+	for (vertex = target; (source != vertex) && (length < pstWorkspace->noOfVertex);
+		vertex = pstWorkspace->piPredecessor[vertex])
+	{
+		piPath[length++] = vertex;
+	}
+
+	if (source != vertex)
+	{
+		myLog(ERROR, "No predecessor chain from [%d] back to [%d]!", target, source);
+		return ERR;
+	}
+	piPath[length++] = source;
+
+	for (i = 0; i < length / 2; i++)
+	{
+		swap = piPath[i];
+		piPath[i] = piPath[length - 1 - i];
+		piPath[length - 1 - i] = swap;
+	}
+
+	return length;
+}
+
+/* Range query: settles the vertices within radius of source, closest first, and stops at
+the first vertex beyond it. piVertices gets them in that order and their distances are in
+pstWorkspace->piDist. Returns how many there are, ERR on failure */
+int ssspRangeSearch(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int source, int radius,
+	int *piVertices)
+{
+	int closestVertex, noOfFound = 0;
+
+	if ((NULL_PTR == piVertices) || (radius < 0)
+		|| (OK != ssspSearch(pstWorkspace, pstAdjList, source, source)))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	/* The search stopped right after settling the source */
+	piVertices[noOfFound++] = source;
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != ssspSettleNext(pstWorkspace, pstAdjList, NULL_PTR, NULL_PTR, &closestVertex))
+		{
+			return ERR;
+		}
+
+		/* Everything still queued is at least as far */
+		if (pstWorkspace->piDist[closestVertex] > radius)
+		{
+			break;
+		}
+
+		piVertices[noOfFound++] = closestVertex;
+	}
+
+	return noOfFound;
+}
+
+/* k nearest query: settles vertices closest first until k vertices other than source are
+settled. piVertices gets them in that order and their distances are in
+pstWorkspace->piDist. Returns how many there are, fewer than k if fewer are reachable and
+ERR on failure */
+int ssspNearestSearch(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int source, int k,
+	int *piVertices)
+{
+	int closestVertex, noOfFound = 0;
+
+	if ((NULL_PTR == piVertices) || (k < 0)
+		|| (OK != ssspSearch(pstWorkspace, pstAdjList, source, source)))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	while ((noOfFound < k) && (FALSE == pqIsEmpty(pstWorkspace->pstQueue)))
+	{
+		if (OK != ssspSettleNext(pstWorkspace, pstAdjList, NULL_PTR, NULL_PTR, &closestVertex))
+		{
+			return ERR;
+		}
+
+		piVertices[noOfFound++] = closestVertex;
+	}
+
+	return noOfFound;
+}
+
+/* Multi source Dijkstra: every source is queued at distance 0, so one search gives each
+vertex its distance to the closest source. piOwner[v] gets that source, taken over from the
+predecessor when v is settled, and -1 if v is not reachable. Sources have no predecessor.
+Predecessors must be enabled. Returns OK or ERR */
+int ssspMultiSourceSearch(SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int *piSources,
+	int noOfSources, int *piOwner)
+{
+	int i, closestVertex;
+
+	if ((NULL_PTR == pstWorkspace) || (NULL_PTR == pstAdjList) || (NULL_PTR == piSources)
+		|| (NULL_PTR == piOwner) || (NULL_PTR == pstWorkspace->piPredecessor))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	resetSsspWorkspace(pstWorkspace);
+
+	for (i = 0; i < pstWorkspace->noOfVertex; i++)
+	{
+		piOwner[i] = -1;
+	}
+
+	for (i = 0; i < noOfSources; i++)
+	{
+		if ((piSources[i] < 0) || (piSources[i] >= pstWorkspace->noOfVertex))
+		{
+			myLog(ERROR, "Source [%d] out of range!", piSources[i]);
+			return ERR;
+		}
+
+		if (OK != ssspRelax(pstWorkspace, piSources[i], 0))
+		{
+			return ERR;
+		}
+
+		piOwner[piSources[i]] = piSources[i];
+		pstWorkspace->piPredecessor[piSources[i]] = -1;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != ssspSettleNext(pstWorkspace, pstAdjList, NULL_PTR, NULL_PTR, &closestVertex))
+		{
+			return ERR;
+		}
+
+		/* The predecessor was settled before, so its owner is final */
+		if (-1 != pstWorkspace->piPredecessor[closestVertex])
+		{
+			piOwner[closestVertex] = piOwner[pstWorkspace->piPredecessor[closestVertex]];
+		}
+	}
+
+	return OK;
+}
+
+/* Entry function for query mode. Prints the row of source, or only the distance and the
+path to destination when one is given. The point to point search stops at the destination */
+int ssspQueryProc(int scheme, char *fileName, char *sourceArg, char *destinationArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	NamedRowSink stNamedSink;
+	long long startTime, timeUsec;
+	int *piPath = NULL_PTR;
+	int i, source, destination = SSSP_NO_TARGET, pathLength, retVal = OK;
+
+	if (NULL_PTR == sourceArg)
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	source = atoi(sourceArg);
+	if (NULL_PTR != destinationArg)
+	{
+		destination = atoi(destinationArg);
+	}
+
+	if ((source < 0) || (source >= gNoOfVertex)
+		|| (((NULL_PTR != destinationArg) && ((destination < 0) || (destination >= gNoOfVertex)))))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", gNoOfVertex);
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	/* A point to point query also prints its path */
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	if ((NULL_PTR == pstWorkspace) || ((SSSP_NO_TARGET != destination)
+		&& ((OK != ssspEnablePredecessors(pstWorkspace))
+		|| (NULL_PTR == (piPath = (int *)malloc(sizeof(int) * gNoOfVertex))))))
+	{
+		myLog(ERROR, "Failed to allocate the search!");
+		destroySsspWorkspace(pstWorkspace);
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	startTime = getWallTimeUsec();
+	retVal = ssspSearch(pstWorkspace, pstAdjList, source, destination);
+	timeUsec = getWallTimeUsec() - startTime;
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "ssspSearch failed!");
+	}
+	else if (SSSP_NO_TARGET == destination)
+	{
+		(void)openNamedRowSink(&stNamedSink, ROW_SINK_STDOUT_NAME);
+		retVal = stNamedSink.stSink.pfnSink(stNamedSink.stSink.pSinkCtx, source,
+			pstWorkspace->piDist, gNoOfVertex);
+	}
+	else if (INFINITY == pstWorkspace->piDist[destination])
+	{
+		printf("%d -> %d: -\n", source, destination);
+	}
+	else if (ERR == (pathLength = ssspGetPath(pstWorkspace, source, destination, piPath)))
+	{
+		retVal = ERR;
+	}
+	else
+	{
+		printf("%d -> %d: %d\nPath:", source, destination, pstWorkspace->piDist[destination]);
+		for (i = 0; i < pathLength; i++)
+		{
+			printf(" %d", piPath[i]);
+		}
+		printf("\n");
+	}
+
+	if (OK == retVal)
+	{
+		printf("\n%s: Settled: [%d] of [%d] Time: [%lld] usec\n", schemeString[scheme],
+			pstWorkspace->noOfSettled, gNoOfVertex, timeUsec);
+	}
+
+	free(piPath);
+	destroySsspWorkspace(pstWorkspace);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
+
+/* Entry function for bidirectional mode. Answers source -> destination with the plain and
+the bidirectional search on the same heap and prints the settled vertices of both */
+int bidirectionalProc(int scheme, char *fileName, char *sourceArg, char *destinationArg)
+{
+	AdjList *pstAdjList = NULL_PTR, *pstReverseList = NULL_PTR;
+	SsspWorkspace *pstForward = NULL_PTR, *pstBackward = NULL_PTR;
+	SsspMeeting stMeeting;
+	long long startTime, plainUsec, bidiUsec;
+	int source, destination, plainDistance, bidiDistance, plainSettled, retVal = OK;
+
+	if ((NULL_PTR == sourceArg) || (NULL_PTR == destinationArg))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	source = atoi(sourceArg);
+	destination = atoi(destinationArg);
+	if ((source < 0) || (source >= gNoOfVertex) || (destination < 0) || (destination >= gNoOfVertex))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", gNoOfVertex);
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	startTime = getWallTimeMsec();
+	pstReverseList = buildReverseAdjList(pstAdjList);
+	pstForward = createSsspWorkspace(scheme, gNoOfVertex);
+	pstBackward = createSsspWorkspace(scheme, gNoOfVertex);
+	if ((NULL_PTR == pstReverseList) || (NULL_PTR == pstForward) || (NULL_PTR == pstBackward))
+	{
+		myLog(ERROR, "Failed to set up the searches!");
+		retVal = ERR;
+	}
+	else
+	{
+		printf("\nReverse graph built in [%lld] msec\n", getWallTimeMsec() - startTime);
+
+		startTime = getWallTimeUsec();
+		plainDistance = ssspPointToPoint(pstForward, pstAdjList, source, destination);
+		plainUsec = getWallTimeUsec() - startTime;
+		plainSettled = pstForward->noOfSettled;
+
+		startTime = getWallTimeUsec();
+		bidiDistance = ssspBidirectional(pstForward, pstBackward, pstAdjList, pstReverseList,
+			source, destination, &stMeeting);
+		bidiUsec = getWallTimeUsec() - startTime;
+
+		if ((ERR == plainDistance) || (ERR == bidiDistance))
+		{
+			myLog(ERROR, "Search failed!");
+			retVal = ERR;
+		}
+		else if (INFINITY == bidiDistance)
+		{
+			printf("%d -> %d: -\n", source, destination);
+		}
+		else
+		{
+			printf("%d -> %d: %d\n", source, destination, bidiDistance);
+		}
+
+		if (OK == retVal)
+		{
+			if (plainDistance != bidiDistance)
+			{
+				myLog(ERROR, "Plain search found [%d], bidirectional [%d]!", plainDistance, bidiDistance);
+				retVal = ERR;
+			}
+
+			printf("\n%s:\n"
+				"Plain:\t\tSettled: [%d] Time: [%lld] usec\n"
+				"Bidirectional:\tSettled: [%d] (forward [%d] backward [%d]) Time: [%lld] usec\n",
+				schemeString[scheme], plainSettled, plainUsec,
+				pstForward->noOfSettled + pstBackward->noOfSettled,
+				pstForward->noOfSettled, pstBackward->noOfSettled, bidiUsec);
+		}
+	}
+
+	destroySsspWorkspace(pstForward);
+	destroySsspWorkspace(pstBackward);
+	if (NULL_PTR != pstReverseList)
+	{
+		destroyAdjList(pstReverseList);
+	}
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
+
+/* Entry function for local query mode. Prints the vertices within bound of source for
+"range", or the bound nearest vertices for "nearest", closest first. Both stop the search
+at the bound, and are checked against the full row of source */
+int localQueryProc(int scheme, char *fileName, char *sourceArg, char *typeArg, char *boundArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR, *pstFull = NULL_PTR;
+	int *piVertices = NULL_PTR;
+	long long startTime, localUsec, fullUsec;
+	int i, source, bound, isRange, noOfFound, noOfExpected = 0, lastDistance, retVal = ERR;
+
+	if ((NULL_PTR == typeArg) || (NULL_PTR == boundArg))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	isRange = (0 == strcmp(typeArg, "range")) ? TRUE : FALSE;
+	source = atoi(sourceArg);
+	bound = atoi(boundArg);
+
+	if (((FALSE == isRange) && (0 != strcmp(typeArg, "nearest"))) || (bound < 0))
+	{
+		myLog(ERROR, "Invalid Input! Query: range or nearest, with a bound of at least 0");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	pstFull = createSsspWorkspace(scheme, gNoOfVertex);
+	piVertices = (int *)malloc(sizeof(int) * gNoOfVertex);
+
+	if ((source < 0) || (source >= gNoOfVertex))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", gNoOfVertex);
+	}
+	else if ((NULL_PTR == pstWorkspace) || (NULL_PTR == pstFull) || (NULL_PTR == piVertices))
+	{
+		myLog(ERROR, "Failed to allocate the searches!");
+	}
+	else
+	{
+		startTime = getWallTimeUsec();
+		noOfFound = (TRUE == isRange)
+			? ssspRangeSearch(pstWorkspace, pstAdjList, source, bound, piVertices)
+			: ssspNearestSearch(pstWorkspace, pstAdjList, source, bound, piVertices);
+		localUsec = getWallTimeUsec() - startTime;
+
+		startTime = getWallTimeUsec();
+		retVal = ssspComputeRow(pstFull, pstAdjList, source);
+		fullUsec = getWallTimeUsec() - startTime;
+
+		if ((ERR == noOfFound) || (OK != retVal))
+		{
+			myLog(ERROR, "Search failed!");
+			retVal = ERR;
+		}
+	}
+
+	if (OK == retVal)
+	{
+		for (i = 0; i < noOfFound; i++)
+		{
+			printf("%d: %d\n", piVertices[i], pstWorkspace->piDist[piVertices[i]]);
+		}
+
+		/* The full row must hold the same number of vertices in range, and for nearest
+		no other vertex closer than the last one found */
+		lastDistance = (noOfFound > 0) ? pstWorkspace->piDist[piVertices[noOfFound - 1]] : 0;
+		for (i = 0; i < gNoOfVertex; i++)
+		{
+			if (TRUE == isRange)
+			{
+				noOfExpected += (pstFull->piDist[i] <= bound);
+			}
+			else if (i != source)
+			{
+				noOfExpected += (pstFull->piDist[i] < lastDistance);
+			}
+		}
+
+		for (i = 0; i < noOfFound; i++)
+		{
+			if (pstFull->piDist[piVertices[i]] != pstWorkspace->piDist[piVertices[i]])
+			{
+				noOfExpected = ERR;
+			}
+		}
+
+		printf("\n%s: [%d] vertices\n"
+			"Bounded:\tSettled: [%d] Time: [%lld] usec\n"
+			"Full:\t\tSettled: [%d] Time: [%lld] usec\n",
+			schemeString[scheme], noOfFound, pstWorkspace->noOfSettled, localUsec,
+			pstFull->noOfSettled, fullUsec);
+
+		/* Nearest may leave out ties of its last distance, but nothing closer */
+		if ((ERR == noOfExpected) || ((TRUE == isRange) && (noOfExpected != noOfFound))
+			|| ((FALSE == isRange) && (noOfExpected >= MAX(noOfFound, 1))))
+		{
+			myLog(ERROR, "The bounded search differs from the full row!");
+			retVal = ERR;
+		}
+	}
+
+	free(piVertices);
+	destroySsspWorkspace(pstWorkspace);
+	destroySsspWorkspace(pstFull);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
@@ -0,0 +1,45 @@
+/***************************************************************************************************/
+// SSSP.H
+// Contains the workspace of the single source shortest path engine
+/***************************************************************************************************/
+
+#ifndef __SSSP__
+#define __SSSP__
+
+#include "pq.h"
+
+/* Target of a search which has to settle every reachable vertex */
+#define SSSP_NO_TARGET -1
+
+/* A lower bound on the distance from vertex to the target of an A* search. It must be
+consistent (bound(u) <= w(u, v) + bound(v) for every edge), so that a settled vertex stays
+settled */
+typedef int (*SSSP_POTENTIAL_FN)(void *pPotentialCtx, int vertex);
+
+/* Everything one single source search needs apart from the graph. A worker keeps one of
+these and reuses it for every source, so the working memory is O(V) per worker */
+typedef struct SsspWorkspace
+{
+	int scheme; // Heap used by the search
+	int noOfVertex;
+	int *piDist; // Distance from the source, INFINITY if not reached
+	char *pSettled; // TRUE once the distance is final
+	int *piTouched; // Vertices with a finite distance, so that a reset is O(touched)
+	int noOfTouched;
+	int noOfSettled; // Vertices settled by the last search
+	PQueue *pstQueue; // Keyed by distance, plus the potential if there is one
+	SSSP_POTENTIAL_FN pfnPotential; // NULL for plain Dijkstra
+	void *pPotentialCtx;
+	int *piPredecessor; // Vertex each one was last improved from. NULL unless enabled
+	double *pdPathCount; // Number of shortest paths from the source, final once settled. NULL unless enabled
+}SsspWorkspace;
+
+/* Where a forward and a backward search meet. bestDistance is the shortest s-t path seen
+so far through meetingVertex, INFINITY and -1 until the searches touch */
+typedef struct SsspMeeting
+{
+	int bestDistance;
+	int meetingVertex;
+}SsspMeeting;
+
+#endif
@@ -0,0 +1,353 @@
+/***************************************************************************************************/
+// STREAM.C
+// Contains all functions for the streaming all pairs mode. Every source is solved into a
+// per worker row which is handed to a sink and then dropped, so no V x V matrix is kept
+/***************************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sssp.h"
+#include "stream.h"
+
+extern int gNoOfVertex;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeMsec();
+
+/* Shared by the workers of one streaming run */
+typedef struct StreamCtx
+{
+	int scheme;
+	AdjList *pstAdjList;
+	RowSink *pstSink;
+	volatile int nextSource; // Next source to hand out
+	volatile int hasFailed;
+}StreamCtx;
+
+/* Sink which only keeps totals over all rows */
+int aggregateRowSink(void *pSinkCtx, int source, int *piRow, int noOfVertex)
+{
+	RowAggregate *pstAggregate = (RowAggregate *)pSinkCtx;
+	long long reachable = 0, total = 0;
+	int i, maxDistance = 0;
+
+	(void)source;
+
+	/* Reduce the row outside the lock */
+	for (i = 0; i < noOfVertex; i++)
+	{
+		if (INFINITY != piRow[i])
+		{
+			reachable++;
+			total += piRow[i];
+			maxDistance = MAX(maxDistance, piRow[i]);
+		}
+	}
+
+	pthread_mutex_lock(&pstAggregate->lock);
+	pstAggregate->noOfRows++;
+	pstAggregate->reachablePairs += reachable;
+	pstAggregate->unreachablePairs += (noOfVertex - reachable);
+	pstAggregate->totalDistance += total;
+	pstAggregate->maxDistance = MAX(pstAggregate->maxDistance, maxDistance);
+	pthread_mutex_unlock(&pstAggregate->lock);
+
+	return OK;
+}
+
+/* Sink which writes the row to a file or a pipe, as text or as a binary record */
+int fileRowSink(void *pSinkCtx, int source, int *piRow, int noOfVertex)
+{
+	RowFileSink *pstFileSink = (RowFileSink *)pSinkCtx;
+	int i, retVal = OK;
+
+	pthread_mutex_lock(&pstFileSink->lock);
+
+	if (TRUE == pstFileSink->isText)
+	{
+		fprintf(pstFileSink->pFile, "%d   |\t", source);
+		for (i = 0; i < noOfVertex; i++)
+		{
+			if (INFINITY == piRow[i])
+			{
+				fprintf(pstFileSink->pFile, "-\t");
+			}
+			else
+			{
+				fprintf(pstFileSink->pFile, "%d\t", piRow[i]);
+			}
+		}
+		fprintf(pstFileSink->pFile, "\n");
+	}
+	else if ((1 != fwrite(&source, sizeof(int), 1, pstFileSink->pFile))
+		|| (noOfVertex != (int)fwrite(piRow, sizeof(int), noOfVertex, pstFileSink->pFile)))
+	{
+		myLog(ERROR, "Could not write row [%d]!", source);
+		retVal = ERR;
+	}
+
+	pthread_mutex_unlock(&pstFileSink->lock);
+
+	return retVal;
+}
+
+/* Worker loop. Takes the next source until all are done */
+void* streamWorker(void *pArg)
+{
+	StreamCtx *pstCtx = (StreamCtx *)pArg;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int source;
+
+	pstWorkspace = createSsspWorkspace(pstCtx->scheme, gNoOfVertex);
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+		pstCtx->hasFailed = TRUE;
+		return NULL_PTR;
+	}
+
+	while (FALSE == pstCtx->hasFailed)
+	{
+		source = __sync_fetch_and_add(&pstCtx->nextSource, 1);
+		if (source >= gNoOfVertex)
+		{
+			break;
+		}
+
+		if (OK != ssspComputeRow(pstWorkspace, pstCtx->pstAdjList, source))
+		{
+			myLog(ERROR, "ssspComputeRow failed for source [%d]!", source);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+
+		if (OK != pstCtx->pstSink->pfnSink(pstCtx->pstSink->pSinkCtx, source,
+			pstWorkspace->piDist, gNoOfVertex))
+		{
+			myLog(ERROR, "Sink failed for source [%d]!", source);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+
+	return NULL_PTR;
+}
+
+/* Solves every source with noOfThreads workers and streams the rows to the sink.
+Returns the wall clock time taken in msec */
+int runStreamingScheme(int scheme, AdjList *pstAdjList, RowSink *pstSink, int noOfThreads)
+{
+	pthread_t aThreads[MAX_WORKER_THREADS];
+	StreamCtx stCtx;
+	long long startTime;
+	int i, noOfStarted = 0;
+
+	if ((NULL_PTR == pstAdjList) || (NULL_PTR == pstSink) || (NULL_PTR == pstSink->pfnSink)
+		|| (noOfThreads < 1) || (noOfThreads > MAX_WORKER_THREADS))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return INVALID_TIME;
+	}
+
+	stCtx.scheme = scheme;
+	stCtx.pstAdjList = pstAdjList;
+	stCtx.pstSink = pstSink;
+	stCtx.nextSource = 0;
+	stCtx.hasFailed = FALSE;
+
+	startTime = getWallTimeMsec();
+
+	for (i = 0; i < noOfThreads; i++)
+	{
+		if (0 != pthread_create(&aThreads[i], NULL, streamWorker, &stCtx))
+		{
+			myLog(ERROR, "pthread_create failed for worker [%d]!", i);
+			stCtx.hasFailed = TRUE;
+			break;
+		}
+		noOfStarted++;
+	}
+
+	for (i = 0; i < noOfStarted; i++)
+	{
+		pthread_join(aThreads[i], NULL);
+	}
+
+	if (TRUE == stCtx.hasFailed)
+	{
+		return INVALID_TIME;
+	}
+
+	return (int)(getWallTimeMsec() - startTime);
+}
+
+/* Number of workers from the command line. Defaults to the online CPUs, clamped to
+[1, MAX_WORKER_THREADS] */
+int getWorkerThreadCount(char *threadsArg)
+{
+	int noOfThreads;
+
+	noOfThreads = (NULL_PTR != threadsArg) ? atoi(threadsArg) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	noOfThreads = MAX(1, noOfThreads);
+	if (noOfThreads > MAX_WORKER_THREADS)
+	{
+		noOfThreads = MAX_WORKER_THREADS;
+	}
+
+	return noOfThreads;
+}
+
+/* Takes the next vertex of a "v[,v...]" list off *ppCursor and steps past the ',' after it.
+Returns ERR unless the entry has digits, is in [0, noOfVertex) and is followed by ',' and
+another entry or by the end of the list */
+int nextListVertex(char **ppCursor, int noOfVertex, int *pVertex)
+{
+	char *pEnd = NULL_PTR;
+	long vertex;
+
+	vertex = strtol(*ppCursor, &pEnd, 10);
+	if ((pEnd == *ppCursor) || ((',' != *pEnd) && ('\0' != *pEnd))
+		|| ((',' == *pEnd) && ('\0' == *(pEnd + 1))))
+	{
+		myLog(ERROR, "Malformed vertex list at [%s]!", *ppCursor);
+		return ERR;
+	}
+
+	if ((vertex < 0) || (vertex >= noOfVertex))
+	{
+		myLog(ERROR, "Vertex [%ld] is out of range!", vertex);
+		return ERR;
+	}
+
+	*pVertex = (int)vertex;
+	*ppCursor = (',' == *pEnd) ? (pEnd + 1) : pEnd;
+
+	return OK;
+}
+
+/* Sets up the sink named sinkName: "agg" (default) for totals only, "-" for text rows on
+stdout or a file name for binary row records */
+int openNamedRowSink(NamedRowSink *pstNamedSink, char *sinkName)
+{
+	(void)memset(pstNamedSink, 0, sizeof(NamedRowSink));
+	pthread_mutex_init(&pstNamedSink->stAggregate.lock, NULL);
+	pthread_mutex_init(&pstNamedSink->stFileSink.lock, NULL);
+
+	pstNamedSink->sinkName = (NULL_PTR != sinkName) ? sinkName : ROW_SINK_AGGREGATE_NAME;
+
+	if (0 == strcmp(pstNamedSink->sinkName, ROW_SINK_AGGREGATE_NAME))
+	{
+		pstNamedSink->stSink.pfnSink = aggregateRowSink;
+		pstNamedSink->stSink.pSinkCtx = &pstNamedSink->stAggregate;
+		return OK;
+	}
+
+	pstNamedSink->stFileSink.isText = (0 == strcmp(pstNamedSink->sinkName, ROW_SINK_STDOUT_NAME));
+	pstNamedSink->stFileSink.pFile = (TRUE == pstNamedSink->stFileSink.isText)
+		? stdout : fopen(pstNamedSink->sinkName, "wb");
+	if (NULL_PTR == pstNamedSink->stFileSink.pFile)
+	{
+		myLog(ERROR, "Could not open [%s] for writing!", pstNamedSink->sinkName);
+		return ERR;
+	}
+
+	pstNamedSink->stSink.pfnSink = fileRowSink;
+	pstNamedSink->stSink.pSinkCtx = &pstNamedSink->stFileSink;
+
+	return OK;
+}
+
+/* Closes the file of a file sink. Returns ERR if the rows could not be flushed */
+int closeNamedRowSink(NamedRowSink *pstNamedSink)
+{
+	int retVal = OK;
+
+	if ((NULL_PTR != pstNamedSink->stFileSink.pFile) && (FALSE == pstNamedSink->stFileSink.isText))
+	{
+		if (0 != fclose(pstNamedSink->stFileSink.pFile))
+		{
+			myLog(ERROR, "Could not flush [%s]!", pstNamedSink->sinkName);
+			retVal = ERR;
+		}
+	}
+
+	pstNamedSink->stFileSink.pFile = NULL_PTR;
+
+	return retVal;
+}
+
+/* Where summaries go. stderr when the rows themselves are on stdout */
+FILE* getNamedRowSinkSummaryFile(NamedRowSink *pstNamedSink)
+{
+	return (TRUE == pstNamedSink->stFileSink.isText) ? stderr : stdout;
+}
+
+/* Prints the totals of an aggregating sink. Other sinks have nothing to print */
+void printNamedRowSinkTotals(NamedRowSink *pstNamedSink)
+{
+	RowAggregate *pstAggregate = &pstNamedSink->stAggregate;
+
+	if (pstNamedSink->stSink.pSinkCtx != pstAggregate)
+	{
+		return;
+	}
+
+	printf("Rows: [%d] Reachable pairs: [%lld] Unreachable pairs: [%lld]\n"
+		"Average distance: [%lld] Diameter: [%d]\n",
+		pstAggregate->noOfRows, pstAggregate->reachablePairs, pstAggregate->unreachablePairs,
+		(pstAggregate->reachablePairs ? (pstAggregate->totalDistance / pstAggregate->reachablePairs) : 0),
+		pstAggregate->maxDistance);
+}
+
+/* Entry function for streaming all pairs mode. See openNamedRowSink() for sinkName */
+int streamProc(int scheme, char *fileName, char *sinkName, char *threadsArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	NamedRowSink stNamedSink;
+	int noOfThreads, timeMsec;
+
+	noOfThreads = getWorkerThreadCount(threadsArg);
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	if (OK != openNamedRowSink(&stNamedSink, sinkName))
+	{
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	myLog(INFO, "Streaming [%d] rows with [%d] workers to [%s]",
+		gNoOfVertex, noOfThreads, stNamedSink.sinkName);
+
+	timeMsec = runStreamingScheme(scheme, pstAdjList, &stNamedSink.stSink, noOfThreads);
+
+	if ((OK != closeNamedRowSink(&stNamedSink)) && (INVALID_TIME != timeMsec))
+	{
+		timeMsec = INVALID_TIME;
+	}
+
+	destroyAdjList(pstAdjList);
+
+	if (INVALID_TIME == timeMsec)
+	{
+		myLog(ERROR, "runStreamingScheme failed!");
+		return ERR;
+	}
+
+	fprintf(getNamedRowSinkSummaryFile(&stNamedSink),
+		"\n%s: [%d] vertices, [%d] workers, [%d] msec\n",
+		schemeString[scheme], gNoOfVertex, noOfThreads, timeMsec);
+
+	printNamedRowSinkTotals(&stNamedSink);
+
+	return OK;
+}
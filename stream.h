@@ -0,0 +1,59 @@
+/***************************************************************************************************/
+// STREAM.H
+// Contains the row sinks of the streaming all pairs mode
+/***************************************************************************************************/
+
+#ifndef __STREAM__
+#define __STREAM__
+
+#include <stdio.h>
+#include <pthread.h>
+#include "header.h"
+
+#define MAX_WORKER_THREADS 64
+
+/* Names of the built in sinks on the command line. Anything else is a file name */
+#define ROW_SINK_AGGREGATE_NAME "agg"
+#define ROW_SINK_STDOUT_NAME "-"
+
+/* Called once per source with the finished row. The row belongs to the calling worker and
+is overwritten by its next source, so a sink must copy what it wants to keep. Sinks are
+called from several workers at once */
+typedef int (*ROW_SINK_FN)(void *pSinkCtx, int source, int *piRow, int noOfVertex);
+
+typedef struct RowSink
+{
+	ROW_SINK_FN pfnSink;
+	void *pSinkCtx;
+}RowSink;
+
+/* Context of the aggregating sink */
+typedef struct RowAggregate
+{
+	pthread_mutex_t lock;
+	int noOfRows;
+	long long reachablePairs;
+	long long unreachablePairs;
+	long long totalDistance;
+	int maxDistance; // The diameter once every row is in
+}RowAggregate;
+
+/* Context of the text and binary file sinks. A binary record is the source followed by
+noOfVertex distances, all native ints. Records come in completion order */
+typedef struct RowFileSink
+{
+	pthread_mutex_t lock;
+	FILE *pFile;
+	int isText;
+}RowFileSink;
+
+/* A sink picked by name on the command line, together with the contexts it may use */
+typedef struct NamedRowSink
+{
+	char *sinkName;
+	RowSink stSink;
+	RowAggregate stAggregate;
+	RowFileSink stFileSink;
+}NamedRowSink;
+
+#endif
@@ -0,0 +1,486 @@
+/***************************************************************************************************/
+// TZ.C
+// Contains all functions of the Thorup-Zwick oracle: sampling the levels, the pivots, the
+// clusters and bunches built with pruned Dijkstra runs, the query and the stretch benchmark
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "sssp.h"
+#include "tz.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern AdjList* buildUndirectedAdjList(AdjList *pstAdjList);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeMsec();
+extern long long getWallTimeUsec();
+
+/* Frees the oracle */
+void destroyTzOracle(TzOracle *pstOracle)
+{
+	int i;
+
+	if (NULL_PTR == pstOracle)
+	{
+		return;
+	}
+
+	if (NULL_PTR != pstOracle->ppstBunches)
+	{
+		for (i = 0; i < pstOracle->noOfVertex; i++)
+		{
+			free(pstOracle->ppstBunches[i]);
+		}
+	}
+
+	free(pstOracle->ppstBunches);
+	free(pstOracle->piBunchSizes);
+	free(pstOracle->piBunchCapacity);
+	free(pstOracle->piLevel);
+	free(pstOracle->piPivots);
+	free(pstOracle->piPivotDist);
+	free(pstOracle);
+}
+
+/* Picks the levels. Each vertex of A_(i - 1) stays in A_i with probability n^(-1/k).
+An empty A_(k - 1) would make the top bunches the whole graph, so it is sampled again */
+int sampleTzLevels(TzOracle *pstOracle)
+{
+	double probability = pow((double)pstOracle->noOfVertex, -1.0 / pstOracle->noOfLevels);
+	int i, v, noOfTop = 0, noOfTries;
+
+	for (noOfTries = 0; (noOfTries < MAX_TZ_SAMPLINGS) && (0 == noOfTop); noOfTries++)
+	{
+		noOfTop = (1 == pstOracle->noOfLevels) ? pstOracle->noOfVertex : 0;
+
+		for (v = 0; v < pstOracle->noOfVertex; v++)
+		{
+			pstOracle->piLevel[v] = 0;
+			for (i = 1; i < pstOracle->noOfLevels; i++)
+			{
+				if ((double)rand() / ((double)RAND_MAX + 1) >= probability)
+				{
+					break;
+				}
+				pstOracle->piLevel[v] = i;
+			}
+
+			noOfTop += (pstOracle->noOfLevels - 1 == pstOracle->piLevel[v]);
+		}
+	}
+
+	if (0 == noOfTop)
+	{
+		myLog(ERROR, "Level [%d] stayed empty!", pstOracle->noOfLevels - 1);
+		return ERR;
+	}
+
+	return OK;
+}
+
+/* Dijkstra from every vertex of A_level at once. Each vertex gets the distance to the
+closest of them and which one it is */
+int computeTzPivots(TzOracle *pstOracle, SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int level)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	int *piPivots = pstOracle->piPivots + ((long long)level * pstOracle->noOfVertex);
+	int *piPivotDist = pstOracle->piPivotDist + ((long long)level * pstOracle->noOfVertex);
+	int v, vertex, distance, nextVertex;
+
+	resetSsspWorkspace(pstWorkspace);
+
+	for (v = 0; v < pstOracle->noOfVertex; v++)
+	{
+		piPivots[v] = -1;
+		piPivotDist[v] = INFINITY;
+
+		if ((pstOracle->piLevel[v] >= level) && (OK != ssspRelax(pstWorkspace, v, 0)))
+		{
+			return ERR;
+		}
+
+		if (pstOracle->piLevel[v] >= level)
+		{
+			piPivots[v] = v;
+		}
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		piPivotDist[vertex] = distance;
+
+		for (pstTraverser = pstAdjList[vertex].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			nextVertex = pstTraverser->vertexNum;
+			if ((TRUE == pstWorkspace->pSettled[nextVertex])
+				|| (distance + pstTraverser->distance >= pstWorkspace->piDist[nextVertex]))
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstTraverser->distance))
+			{
+				return ERR;
+			}
+
+			piPivots[nextVertex] = piPivots[vertex];
+		}
+	}
+
+	return OK;
+}
+
+/* Adds w at distance to the bunch of vertex */
+int addToTzBunch(TzOracle *pstOracle, int vertex, int w, int distance)
+{
+	TzBunchEntry *pstBunch = NULL_PTR;
+	int capacity;
+
+	if (pstOracle->piBunchSizes[vertex] == pstOracle->piBunchCapacity[vertex])
+	{
+		capacity = (0 == pstOracle->piBunchCapacity[vertex]) ? 4 : (2 * pstOracle->piBunchCapacity[vertex]);
+		pstBunch = (TzBunchEntry *)realloc(pstOracle->ppstBunches[vertex], sizeof(TzBunchEntry) * capacity);
+		if (NULL_PTR == pstBunch)
+		{
+			myLog(ERROR, "realloc failed!");
+			return ERR;
+		}
+
+		pstOracle->ppstBunches[vertex] = pstBunch;
+		pstOracle->piBunchCapacity[vertex] = capacity;
+	}
+
+	pstOracle->ppstBunches[vertex][pstOracle->piBunchSizes[vertex]].vertex = w;
+	pstOracle->ppstBunches[vertex][pstOracle->piBunchSizes[vertex]].distance = distance;
+	pstOracle->piBunchSizes[vertex]++;
+	pstOracle->noOfBunchEntries++;
+
+	return OK;
+}
+
+/* Grows the cluster of w, a vertex of A_i - A_(i + 1): Dijkstra from w which only keeps a
+vertex v while d(w, v) < d(A_(i + 1), v). Every vertex of the cluster gets w in its bunch */
+int growTzCluster(TzOracle *pstOracle, SsspWorkspace *pstWorkspace, AdjList *pstAdjList, int w)
+{
+	AdjList *pstTraverser = NULL_PTR;
+	int *piBound = pstOracle->piPivotDist + ((long long)(pstOracle->piLevel[w] + 1) * pstOracle->noOfVertex);
+	int vertex, distance, nextVertex;
+
+	resetSsspWorkspace(pstWorkspace);
+
+	if (OK != ssspRelax(pstWorkspace, w, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		pstWorkspace->noOfSettled++;
+
+		if (OK != addToTzBunch(pstOracle, vertex, w, distance))
+		{
+			return ERR;
+		}
+
+		for (pstTraverser = pstAdjList[vertex].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			nextVertex = pstTraverser->vertexNum;
+
+			/* The pruning that keeps the clusters small */
+			if ((TRUE == pstWorkspace->pSettled[nextVertex])
+				|| (distance + pstTraverser->distance >= piBound[nextVertex]))
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstTraverser->distance))
+			{
+				return ERR;
+			}
+		}
+	}
+
+	return OK;
+}
+
+/* qsort comparator for bunch entries */
+int compareTzBunchEntries(const void *pLeft, const void *pRight)
+{
+	int left = ((TzBunchEntry *)pLeft)->vertex, right = ((TzBunchEntry *)pRight)->vertex;
+
+	return (left > right) - (left < right);
+}
+
+/* Builds the oracle with k levels on the undirected adj list. The Dijkstra runs use the
+heap of scheme. Returns NULL on failure */
+TzOracle* buildTzOracle(int scheme, AdjList *pstAdjList, int noOfLevels)
+{
+	TzOracle *pstOracle = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int i, v, retVal = OK;
+
+	pstOracle = (TzOracle *)calloc(1, sizeof(TzOracle));
+	if (NULL_PTR == pstOracle)
+	{
+		myLog(ERROR, "calloc failed!");
+		return NULL_PTR;
+	}
+
+	pstOracle->noOfVertex = gNoOfVertex;
+	pstOracle->noOfLevels = noOfLevels;
+	pstOracle->piLevel = (int *)malloc(sizeof(int) * gNoOfVertex);
+	pstOracle->piPivots = (int *)malloc(sizeof(int) * (noOfLevels + 1) * gNoOfVertex);
+	pstOracle->piPivotDist = (int *)malloc(sizeof(int) * (noOfLevels + 1) * gNoOfVertex);
+	pstOracle->ppstBunches = (TzBunchEntry **)calloc(gNoOfVertex, sizeof(TzBunchEntry *));
+	pstOracle->piBunchSizes = (int *)calloc(gNoOfVertex, sizeof(int));
+	pstOracle->piBunchCapacity = (int *)calloc(gNoOfVertex, sizeof(int));
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+
+	if ((NULL_PTR == pstOracle->piLevel) || (NULL_PTR == pstOracle->piPivots)
+		|| (NULL_PTR == pstOracle->piPivotDist) || (NULL_PTR == pstOracle->ppstBunches)
+		|| (NULL_PTR == pstOracle->piBunchSizes) || (NULL_PTR == pstOracle->piBunchCapacity)
+		|| (NULL_PTR == pstWorkspace))
+	{
+		myLog(ERROR, "Failed to allocate the oracle for [%d] vertices!", gNoOfVertex);
+		retVal = ERR;
+	}
+	else if (OK != sampleTzLevels(pstOracle))
+	{
+		retVal = ERR;
+	}
+
+	/* A_k is empty: nothing bounds the clusters of the top level */
+	for (v = 0; (v < gNoOfVertex) && (OK == retVal); v++)
+	{
+		pstOracle->piPivots[((long long)noOfLevels * gNoOfVertex) + v] = -1;
+		pstOracle->piPivotDist[((long long)noOfLevels * gNoOfVertex) + v] = INFINITY;
+	}
+
+	for (i = 0; (i < noOfLevels) && (OK == retVal); i++)
+	{
+		retVal = computeTzPivots(pstOracle, pstWorkspace, pstAdjList, i);
+	}
+
+	for (v = 0; (v < gNoOfVertex) && (OK == retVal); v++)
+	{
+		retVal = growTzCluster(pstOracle, pstWorkspace, pstAdjList, v);
+	}
+
+	for (v = 0; (v < gNoOfVertex) && (OK == retVal); v++)
+	{
+		qsort(pstOracle->ppstBunches[v], pstOracle->piBunchSizes[v], sizeof(TzBunchEntry),
+			compareTzBunchEntries);
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+
+	if (OK != retVal)
+	{
+		destroyTzOracle(pstOracle);
+		return NULL_PTR;
+	}
+
+	return pstOracle;
+}
+
+/* Returns d(w, vertex) if w is in the bunch of vertex, INFINITY if not */
+int findInTzBunch(TzOracle *pstOracle, int vertex, int w)
+{
+	TzBunchEntry *pstBunch = pstOracle->ppstBunches[vertex];
+	int low = 0, high = pstOracle->piBunchSizes[vertex] - 1, middle;
+
+	while (low <= high)
+	{
+		middle = (low + high) / 2;
+		if (w == pstBunch[middle].vertex)
+		{
+			return pstBunch[middle].distance;
+		}
+
+		if (w < pstBunch[middle].vertex)
+		{
+			high = middle - 1;
+		}
+		else
+		{
+			low = middle + 1;
+		}
+	}
+
+	return INFINITY;
+}
+
+/* Estimates d(u, v) within a factor 2k - 1. Climbs the levels, swapping the ends each time,
+until the pivot of one end is in the bunch of the other. INFINITY if they are not
+connected */
+int tzQuery(TzOracle *pstOracle, int u, int v)
+{
+	int w = u, level = 0, swap, distance;
+
+	while (INFINITY == (distance = findInTzBunch(pstOracle, v, w)))
+	{
+		level++;
+		if (level >= pstOracle->noOfLevels)
+		{
+			return INFINITY;
+		}
+
+		swap = u;
+		u = v;
+		v = swap;
+
+		w = pstOracle->piPivots[((long long)level * pstOracle->noOfVertex) + u];
+		if (-1 == w)
+		{
+			return INFINITY;
+		}
+	}
+
+	return pstOracle->piPivotDist[((long long)level * pstOracle->noOfVertex) + u] + distance;
+}
+
+/* Entry function for the approximate oracle mode. Builds the oracle with k levels for the
+graph in fileName taken as undirected, then compares random queries with the exact
+distances and prints the observed stretch and the size of the bunches */
+int tzProc(int scheme, char *fileName, char *levelsArg, char *queriesArg)
+{
+	AdjList *pstAdjList = NULL_PTR, *pstUndirected = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	TzOracle *pstOracle = NULL_PTR;
+	long long startTime, oracleUsec = 0, sizeBound;
+	double stretch, maxStretch = 1, totalStretch = 0;
+	int i, source, destination, exact, estimate, noOfCompared = 0, noOfViolations = 0;
+	int noOfLevels = DEFAULT_TZ_LEVELS, noOfQueries = DEFAULT_TZ_QUERIES, retVal = OK;
+
+	if (NULL_PTR != levelsArg)
+	{
+		noOfLevels = atoi(levelsArg);
+	}
+
+	if (NULL_PTR != queriesArg)
+	{
+		noOfQueries = atoi(queriesArg);
+	}
+
+	if ((noOfLevels <= 0) || (noOfLevels > MAX_TZ_LEVELS) || (noOfQueries <= 0))
+	{
+		myLog(ERROR, "Invalid Input! Levels: 1 to [%d], queries must be positive", MAX_TZ_LEVELS);
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	/* The stretch bound only holds for undirected distances */
+	pstUndirected = buildUndirectedAdjList(pstAdjList);
+	destroyAdjList(pstAdjList);
+
+	if (NULL_PTR == pstUndirected)
+	{
+		myLog(ERROR, "buildUndirectedAdjList failed!");
+		return ERR;
+	}
+
+	srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+
+	startTime = getWallTimeMsec();
+	pstOracle = buildTzOracle(scheme, pstUndirected, noOfLevels);
+
+	if (NULL_PTR == pstOracle)
+	{
+		myLog(ERROR, "buildTzOracle failed!");
+		destroyAdjList(pstUndirected);
+		return ERR;
+	}
+
+	sizeBound = (long long)(noOfLevels * pow((double)gNoOfVertex, 1.0 + (1.0 / noOfLevels)));
+
+	printf("\n%s: [%d] levels, built in [%lld] msec\n"
+		"Bunch entries: [%lld] ([%lld] bytes), k * n^(1 + 1/k): [%lld], n^2: [%lld]\n",
+		schemeString[scheme], noOfLevels, getWallTimeMsec() - startTime,
+		pstOracle->noOfBunchEntries, pstOracle->noOfBunchEntries * (long long)sizeof(TzBunchEntry),
+		sizeBound, (long long)gNoOfVertex * gNoOfVertex);
+
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	if (NULL_PTR == pstWorkspace)
+	{
+		myLog(ERROR, "createSsspWorkspace failed!");
+		retVal = ERR;
+	}
+
+	for (i = 0; (i < noOfQueries) && (OK == retVal); i++)
+	{
+		source = rand() % gNoOfVertex;
+		destination = rand() % gNoOfVertex;
+
+		startTime = getWallTimeUsec();
+		estimate = tzQuery(pstOracle, source, destination);
+		oracleUsec += getWallTimeUsec() - startTime;
+
+		exact = ssspPointToPoint(pstWorkspace, pstUndirected, source, destination);
+		if (ERR == exact)
+		{
+			retVal = ERR;
+			break;
+		}
+
+		if ((INFINITY == exact) || (0 == exact))
+		{
+			noOfViolations += (estimate != exact);
+			continue;
+		}
+
+		stretch = (double)estimate / exact;
+		noOfViolations += ((estimate < exact) || (estimate > (long long)((2 * noOfLevels) - 1) * exact));
+		maxStretch = MAX(maxStretch, stretch);
+		totalStretch += stretch;
+		noOfCompared++;
+	}
+
+	if (OK == retVal)
+	{
+		printf("[%d] queries, [%lld] usec per query\n"
+			"Stretch: average [%.3f] max [%.3f] bound [%d], [%d] outside the bound\n",
+			noOfQueries, oracleUsec / noOfQueries,
+			(noOfCompared > 0) ? (totalStretch / noOfCompared) : 1.0, maxStretch,
+			(2 * noOfLevels) - 1, noOfViolations);
+
+		if (noOfViolations > 0)
+		{
+			myLog(ERROR, "[%d] estimates broke the stretch bound!", noOfViolations);
+			retVal = ERR;
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	destroyTzOracle(pstOracle);
+	destroyAdjList(pstUndirected);
+
+	return retVal;
+}
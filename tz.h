@@ -0,0 +1,40 @@
+/***************************************************************************************************/
+// TZ.H
+// Contains the Thorup-Zwick approximate distance oracle
+/***************************************************************************************************/
+
+#ifndef __TZ__
+#define __TZ__
+
+#include "header.h"
+
+#define MAX_TZ_LEVELS 16
+#define DEFAULT_TZ_LEVELS 3 // Stretch 2k - 1 = 5
+#define DEFAULT_TZ_QUERIES 1000
+#define MAX_TZ_SAMPLINGS 100 // Tries to get a non empty top level
+
+/* A vertex w of the bunch of v together with d(w, v) */
+typedef struct TzBunchEntry
+{
+	int vertex;
+	int distance;
+}TzBunchEntry;
+
+/* The oracle for a graph taken as undirected. A_0 is every vertex, A_i keeps each vertex
+of A_(i - 1) with probability n^(-1/k), A_k is empty. The bunch of v holds every w of
+A_i - A_(i + 1) with d(w, v) < d(A_(i + 1), v), sorted by w. The expected size of all
+bunches is O(k n^(1 + 1/k)) */
+typedef struct TzOracle
+{
+	int noOfVertex;
+	int noOfLevels; // k
+	int *piLevel; // Highest i with the vertex in A_i
+	int *piPivots; // piPivots[(i * noOfVertex) + v] = p_i(v), the closest vertex of A_i, -1 if none
+	int *piPivotDist; // d(A_i, v) in the same layout, INFINITY if A_i is out of reach
+	TzBunchEntry **ppstBunches;
+	int *piBunchSizes;
+	int *piBunchCapacity;
+	long long noOfBunchEntries;
+}TzOracle;
+
+#endif
@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <time.h>
 #include "bino.h"
 #include "fibo.h"
 
@@ -105,6 +106,76 @@ int copyFromAdjListToDist(AdjList *pstAdjList)
 	return OK;
 }
 
+/* Returns a monotonic wall clock in msec. clock() adds up the CPU time of all threads,
+which is not what the multi threaded modes want to report */
+long long getWallTimeMsec()
+{
+	struct timespec stTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &stTime);
+
+	return (((long long)stTime.tv_sec * MSEC_PER_SEC) + (stTime.tv_nsec / 1000000));
+}
+
+/* Same as getWallTimeMsec() in usec, for timing single queries */
+long long getWallTimeUsec()
+{
+	struct timespec stTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &stTime);
+
+	return (((long long)stTime.tv_sec * 1000000) + (stTime.tv_nsec / 1000));
+}
+
+/* Maps the scheme character of the command line to the scheme. ERR if it is not one */
+int getSchemeFromChar(char schemeChar)
+{
+	switch (schemeChar)
+	{
+		case 's':
+		{
+			return BINARY_SCHEME;
+		}
+		case 'b':
+		{
+			return BINO_SCHEME;
+		}
+		case 'f':
+		{
+			return FIBO_SCHEME;
+		}
+		default:
+		{
+			return ERR;
+		}
+	}
+}
+
+/* Runs the given all pairs scheme and returns the time taken in msec */
+int runSchemeOnAdjList(int scheme, AdjList *pstAdjList)
+{
+	switch (scheme)
+	{
+		case BINARY_SCHEME:
+		{
+			return runBinaryScheme(pstAdjList);
+		}
+		case BINO_SCHEME:
+		{
+			return runBinoScheme(pstAdjList);
+		}
+		case FIBO_SCHEME:
+		{
+			return runFiboScheme(pstAdjList);
+		}
+		default:
+		{
+			myLog(ERROR, "Invalid scheme: [%d]", scheme);
+			return INVALID_TIME;
+		}
+	}
+}
+
 /* Prints the distance matrix */
 void printDistMatrix()
 {
@@ -0,0 +1,344 @@
+/***************************************************************************************************/
+// VORONOI.C
+// Contains all functions for the nearest facility (graph Voronoi) mode. One multi source
+// search labels every vertex with its closest facility
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sssp.h"
+#include "stream.h"
+#include "voronoi.h"
+
+extern int gNoOfVertex;
+extern unsigned int gRandomSeed;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeMsec();
+extern int nextListVertex(char **ppCursor, int noOfVertex, int *pVertex);
+
+/* Appends the vertices of a "v[,v...]" list to *ppiFacilities, growing it as needed.
+Returns OK or ERR */
+int appendVoronoiFacilities(char *list, int **ppiFacilities, int *pNoOfFacilities, int *pCapacity)
+{
+	int *piResized = NULL_PTR;
+	int vertex;
+
+	while ('\0' != *list)
+	{
+		if (OK != nextListVertex(&list, gNoOfVertex, &vertex))
+		{
+			return ERR;
+		}
+
+		if (*pNoOfFacilities == *pCapacity)
+		{
+			*pCapacity = MAX(16, *pCapacity * 2);
+			piResized = (int *)realloc(*ppiFacilities, sizeof(int) * (*pCapacity));
+			if (NULL_PTR == piResized)
+			{
+				myLog(ERROR, "realloc failed!");
+				return ERR;
+			}
+			*ppiFacilities = piResized;
+		}
+
+		(*ppiFacilities)[(*pNoOfFacilities)++] = vertex;
+	}
+
+	return OK;
+}
+
+/* The facilities named on the command line: a "v[,v...]" list, "random:N" for N random
+vertices, or else a file with a list per line. Blank lines of the file are skipped, any
+other line must be a valid list. Returns the facilities or NULL_PTR on bad input */
+int* loadVoronoiFacilities(char *facilitiesArg, int *pNoOfFacilities)
+{
+	FILE *pFile = NULL_PTR;
+	char fileLine[1024], *pCount = NULL_PTR, *pEnd = NULL_PTR;
+	int *piFacilities = NULL_PTR;
+	int i, length, capacity = 0, retVal = OK;
+
+	*pNoOfFacilities = 0;
+
+	if (0 == strncmp(facilitiesArg, VORONOI_RANDOM_PREFIX, strlen(VORONOI_RANDOM_PREFIX)))
+	{
+		pCount = facilitiesArg + strlen(VORONOI_RANDOM_PREFIX);
+		capacity = (int)strtol(pCount, &pEnd, 10);
+		if ((pEnd == pCount) || ('\0' != *pEnd) || (capacity <= 0))
+		{
+			myLog(ERROR, "Invalid Input! Expected random:N with a positive N");
+			return NULL_PTR;
+		}
+
+		piFacilities = (int *)malloc(sizeof(int) * capacity);
+		if (NULL_PTR == piFacilities)
+		{
+			myLog(ERROR, "malloc failed!");
+			return NULL_PTR;
+		}
+
+		srand((0 == gRandomSeed) ? (unsigned int)time(NULL) : gRandomSeed);
+		for (i = 0; i < capacity; i++)
+		{
+			piFacilities[i] = rand() % gNoOfVertex;
+		}
+
+		*pNoOfFacilities = capacity;
+		return piFacilities;
+	}
+
+	if ((facilitiesArg[0] >= '0') && (facilitiesArg[0] <= '9'))
+	{
+		retVal = appendVoronoiFacilities(facilitiesArg, &piFacilities, pNoOfFacilities, &capacity);
+	}
+	else
+	{
+		pFile = fopen(facilitiesArg, "r");
+		if (NULL_PTR == pFile)
+		{
+			myLog(ERROR, "Could not open [%s]!", facilitiesArg);
+			return NULL_PTR;
+		}
+
+		while ((OK == retVal) && (NULL_PTR != fgets(fileLine, sizeof(fileLine), pFile)))
+		{
+			length = (int)strlen(fileLine);
+			while ((length > 0) && ((' ' == fileLine[length - 1]) || ('\t' == fileLine[length - 1])
+				|| ('\r' == fileLine[length - 1]) || ('\n' == fileLine[length - 1])))
+			{
+				fileLine[--length] = '\0';
+			}
+
+			if (0 != length)
+			{
+				retVal = appendVoronoiFacilities(fileLine, &piFacilities, pNoOfFacilities, &capacity);
+			}
+		}
+
+		fclose(pFile);
+	}
+
+	if ((OK == retVal) && (0 == *pNoOfFacilities))
+	{
+		myLog(ERROR, "No facilities in [%s]!", facilitiesArg);
+		retVal = ERR;
+	}
+
+	if (OK != retVal)
+	{
+		myLog(ERROR, "Invalid facilities [%s]!", facilitiesArg);
+		free(piFacilities);
+		piFacilities = NULL_PTR;
+	}
+
+	return piFacilities;
+}
+
+/* Writes the owner and the distance of every vertex, "v: owner distance" or "v: -" */
+int writeVoronoiLabels(FILE *pFile, int *piOwner, int *piDist)
+{
+	int i;
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		if (-1 == piOwner[i])
+		{
+			fprintf(pFile, "%d: -\n", i);
+		}
+		else
+		{
+			fprintf(pFile, "%d: %d %d\n", i, piOwner[i], piDist[i]);
+		}
+	}
+
+	return (0 == ferror(pFile)) ? OK : ERR;
+}
+
+/* The old way: a full search per facility and the minimum over their rows. Counts the
+vertices whose distance differs, or whose owner is not at that distance. *piMsec gets the
+time. Returns the count, ERR on failure */
+int checkVoronoiLabels(int scheme, AdjList *pstAdjList, int *piFacilities, int noOfFacilities,
+	int *piOwner, int *piDist, int *piMsec)
+{
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	int *piMin = NULL_PTR, *piOwnerDist = NULL_PTR;
+	long long startTime;
+	int i, j, noOfWrong = 0;
+
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	piMin = (int *)malloc(sizeof(int) * gNoOfVertex);
+	piOwnerDist = (int *)malloc(sizeof(int) * gNoOfVertex);
+
+	if ((NULL_PTR == pstWorkspace) || (NULL_PTR == piMin) || (NULL_PTR == piOwnerDist))
+	{
+		myLog(ERROR, "Failed to allocate the check!");
+		destroySsspWorkspace(pstWorkspace);
+		free(piMin);
+		free(piOwnerDist);
+		return ERR;
+	}
+
+	for (i = 0; i < gNoOfVertex; i++)
+	{
+		piMin[i] = INFINITY;
+		piOwnerDist[i] = INFINITY;
+	}
+
+	startTime = getWallTimeMsec();
+	for (i = 0; (i < noOfFacilities) && (ERR != noOfWrong); i++)
+	{
+		if (OK != ssspComputeRow(pstWorkspace, pstAdjList, piFacilities[i]))
+		{
+			myLog(ERROR, "ssspComputeRow failed for facility [%d]!", piFacilities[i]);
+			noOfWrong = ERR;
+			break;
+		}
+
+		for (j = 0; j < gNoOfVertex; j++)
+		{
+			piMin[j] = MIN(piMin[j], pstWorkspace->piDist[j]);
+			if (piOwner[j] == piFacilities[i])
+			{
+				piOwnerDist[j] = pstWorkspace->piDist[j];
+			}
+		}
+	}
+	*piMsec = (int)(getWallTimeMsec() - startTime);
+
+	for (i = 0; (i < gNoOfVertex) && (ERR != noOfWrong); i++)
+	{
+		noOfWrong += (piMin[i] != piDist[i])
+			|| ((-1 != piOwner[i]) && (piOwnerDist[i] != piDist[i]));
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	free(piMin);
+	free(piOwnerDist);
+
+	return noOfWrong;
+}
+
+/* Entry function for nearest facility mode. Labels every vertex with the closest of the
+facilities (see loadVoronoiFacilities()) and the distance to it, in one search. The cells
+are summed up and the labels written to stdout for "-" or to outName */
+int voronoiProc(int scheme, char *fileName, char *facilitiesArg, char *outName)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	SsspWorkspace *pstWorkspace = NULL_PTR;
+	FILE *pFile = NULL_PTR;
+	int *piFacilities = NULL_PTR, *piOwner = NULL_PTR, *piCellSizes = NULL_PTR;
+	long long startTime;
+	int i, noOfFacilities = 0, noOfCells = 0, minCell = INFINITY, maxCell = 0, noOfUnreached = 0;
+	int timeMsec, checkMsec = 0, noOfWrong = 0, retVal = OK;
+
+	outName = (NULL_PTR != outName) ? outName : VORONOI_OUTPUT_NONE_NAME;
+
+	if ((NULL_PTR == facilitiesArg) || ('\0' == *facilitiesArg))
+	{
+		myLog(ERROR, "Invalid Input!");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	piFacilities = loadVoronoiFacilities(facilitiesArg, &noOfFacilities);
+	if (NULL_PTR == piFacilities)
+	{
+		myLog(ERROR, "loadVoronoiFacilities failed!");
+		destroyAdjList(pstAdjList);
+		return ERR;
+	}
+
+	pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+	piOwner = (int *)malloc(sizeof(int) * gNoOfVertex);
+	piCellSizes = (int *)calloc(gNoOfVertex, sizeof(int));
+
+	if ((NULL_PTR == pstWorkspace) || (NULL_PTR == piOwner)
+		|| (NULL_PTR == piCellSizes) || (OK != ssspEnablePredecessors(pstWorkspace)))
+	{
+		myLog(ERROR, "Failed to allocate the search!");
+		retVal = ERR;
+	}
+
+	if (OK == retVal)
+	{
+		startTime = getWallTimeMsec();
+		retVal = ssspMultiSourceSearch(pstWorkspace, pstAdjList, piFacilities, noOfFacilities, piOwner);
+		timeMsec = (int)(getWallTimeMsec() - startTime);
+	}
+
+	if ((OK == retVal) && (0 != strcmp(outName, VORONOI_OUTPUT_NONE_NAME)))
+	{
+		pFile = (0 == strcmp(outName, ROW_SINK_STDOUT_NAME)) ? stdout : fopen(outName, "w");
+		if ((NULL_PTR == pFile) || (OK != writeVoronoiLabels(pFile, piOwner, pstWorkspace->piDist)))
+		{
+			myLog(ERROR, "Could not write the labels to [%s]!", outName);
+			retVal = ERR;
+		}
+
+		if ((NULL_PTR != pFile) && (stdout != pFile))
+		{
+			fclose(pFile);
+		}
+	}
+
+	if (OK == retVal)
+	{
+		for (i = 0; i < gNoOfVertex; i++)
+		{
+			if (-1 == piOwner[i])
+			{
+				noOfUnreached++;
+				continue;
+			}
+			piCellSizes[piOwner[i]]++;
+		}
+
+		for (i = 0; i < gNoOfVertex; i++)
+		{
+			if (piCellSizes[i] > 0)
+			{
+				noOfCells++;
+				minCell = MIN(minCell, piCellSizes[i]);
+				maxCell = MAX(maxCell, piCellSizes[i]);
+			}
+		}
+
+		printf("\n%s: [%d] facilities, [%d] cells, [%d] msec, [%d] vertices settled\n"
+			"Cell sizes: smallest [%d] largest [%d] average [%d], [%d] vertices unreached\n",
+			schemeString[scheme], noOfFacilities, noOfCells, timeMsec, pstWorkspace->noOfSettled,
+			(noOfCells > 0) ? minCell : 0, maxCell,
+			(noOfCells > 0) ? ((gNoOfVertex - noOfUnreached) / noOfCells) : 0, noOfUnreached);
+
+		if (noOfFacilities <= VORONOI_CHECKED_FACILITIES)
+		{
+			noOfWrong = checkVoronoiLabels(scheme, pstAdjList, piFacilities, noOfFacilities,
+				piOwner, pstWorkspace->piDist, &checkMsec);
+
+			printf("One search per facility: [%d] msec, [%d] labels differ\n", checkMsec, noOfWrong);
+
+			if (0 != noOfWrong)
+			{
+				myLog(ERROR, "checkVoronoiLabels failed!");
+				retVal = ERR;
+			}
+		}
+	}
+
+	destroySsspWorkspace(pstWorkspace);
+	free(piFacilities);
+	free(piOwner);
+	free(piCellSizes);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
@@ -0,0 +1,15 @@
+/***************************************************************************************************/
+// VORONOI.H
+// Contains the limits of the nearest facility (graph Voronoi) mode
+/***************************************************************************************************/
+
+#ifndef __VORONOI__
+#define __VORONOI__
+
+#include "header.h"
+
+#define VORONOI_CHECKED_FACILITIES 100 // Up to this many, one full search per facility checks the labels
+#define VORONOI_OUTPUT_NONE_NAME "none" // Only the totals are printed
+#define VORONOI_RANDOM_PREFIX "random:" // "random:N" picks N random facilities instead of a list
+
+#endif
@@ -0,0 +1,616 @@
+/***************************************************************************************************/
+// YEN.C
+// Contains all functions for the k shortest loopless paths mode (Yen's algorithm). The spur
+// searches of one round are spread over worker threads which keep their workspaces
+// for the whole run
+/***************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "sssp.h"
+#include "stream.h"
+#include "yen.h"
+
+extern int gNoOfVertex;
+extern char *schemeString[TOTAL_SCHEMES];
+extern AdjList* loadAdjListFromFile(char *fileName, int maxVertexNum);
+extern SsspWorkspace* createSsspWorkspace(int scheme, int noOfVertex);
+extern long long getWallTimeUsec();
+
+/* Shared by the workers of one run. A round takes the spur vertices of the last accepted
+path, one per task */
+typedef struct YenCtx
+{
+	AdjList *pstAdjList;
+	int target;
+	YenPathList *pstAccepted;
+	YenPathList *pstCandidates; // Guarded by lock
+	pthread_mutex_t lock;
+	int bound; // Longest candidate which can still be among the k paths, for this round
+	volatile int nextSpur;
+	volatile int hasFailed;
+}YenCtx;
+
+/* State one worker keeps over all rounds */
+typedef struct YenWorker
+{
+	YenCtx *pstCtx;
+	SsspWorkspace *pstWorkspace; // Records predecessors
+	int *piBlocked; // piBlocked[v] == stamp for the root vertices of the current spur
+	int stamp;
+	int *piBlockedNext; // Vertices the spur may not go to first
+	int *piPath;
+	long long noOfSearches;
+	long long noOfSettled;
+}YenWorker;
+
+/* Frees the paths of a list */
+void destroyYenPathList(YenPathList *pstList)
+{
+	int i;
+
+	for (i = 0; i < pstList->noOfPaths; i++)
+	{
+		free(pstList->pstPaths[i].piVertices);
+		free(pstList->pstPaths[i].piPrefix);
+	}
+
+	free(pstList->pstPaths);
+	(void)memset(pstList, 0, sizeof(YenPathList));
+}
+
+/* Appends a path to a list, which takes over its arrays. Returns OK or ERR */
+int addYenPath(YenPathList *pstList, YenPath *pstPath)
+{
+	YenPath *pstPaths = NULL_PTR;
+	int capacity;
+
+	if (pstList->noOfPaths == pstList->capacity)
+	{
+		capacity = (0 == pstList->capacity) ? 16 : (2 * pstList->capacity);
+		pstPaths = (YenPath *)realloc(pstList->pstPaths, sizeof(YenPath) * capacity);
+		if (NULL_PTR == pstPaths)
+		{
+			myLog(ERROR, "realloc failed!");
+			return ERR;
+		}
+
+		pstList->pstPaths = pstPaths;
+		pstList->capacity = capacity;
+	}
+
+	pstList->pstPaths[pstList->noOfPaths++] = *pstPath;
+
+	return OK;
+}
+
+/* Returns TRUE if the list holds the same path */
+int hasYenPath(YenPathList *pstList, YenPath *pstPath)
+{
+	int i;
+
+	for (i = 0; i < pstList->noOfPaths; i++)
+	{
+		if ((pstList->pstPaths[i].distance == pstPath->distance)
+			&& (pstList->pstPaths[i].noOfVertices == pstPath->noOfVertices)
+			&& (0 == memcmp(pstList->pstPaths[i].piVertices, pstPath->piVertices,
+			sizeof(int) * pstPath->noOfVertices)))
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/* Dijkstra from spur to target which skips the blocked vertices and, on the first step,
+the blocked next vertices. It gives up once the closest queued vertex is further than
+maxDistance. Returns the distance, INFINITY if target was not reached and ERR on failure */
+int yenSpurSearch(YenWorker *pstWorker, AdjList *pstAdjList, int spur, int target,
+	int noOfBlockedNext, int maxDistance)
+{
+	SsspWorkspace *pstWorkspace = pstWorker->pstWorkspace;
+	AdjList *pstTraverser = NULL_PTR;
+	int i, vertex, distance, nextVertex, isBlocked;
+
+	resetSsspWorkspace(pstWorkspace);
+	if (OK != ssspRelax(pstWorkspace, spur, 0))
+	{
+		return ERR;
+	}
+
+	while (FALSE == pqIsEmpty(pstWorkspace->pstQueue))
+	{
+		if (OK != pqRemoveMin(pstWorkspace->pstQueue, &vertex, &distance))
+		{
+			myLog(ERROR, "pqRemoveMin failed!");
+			return ERR;
+		}
+
+		if (distance > maxDistance)
+		{
+			break;
+		}
+
+		pstWorkspace->pSettled[vertex] = TRUE;
+		pstWorkspace->noOfSettled++;
+
+		if (target == vertex)
+		{
+			return distance;
+		}
+
+		for (pstTraverser = pstAdjList[vertex].next; NULL_PTR != pstTraverser;
+			pstTraverser = pstTraverser->next)
+		{
+			nextVertex = pstTraverser->vertexNum;
+			if ((TRUE == pstWorkspace->pSettled[nextVertex])
+				|| (pstWorker->stamp == pstWorker->piBlocked[nextVertex])
+				|| (distance + pstTraverser->distance >= pstWorkspace->piDist[nextVertex]))
+			{
+				continue;
+			}
+
+			/* The edges the accepted paths with the same root take out of the spur */
+			isBlocked = FALSE;
+			for (i = 0; (spur == vertex) && (i < noOfBlockedNext); i++)
+			{
+				isBlocked |= (nextVertex == pstWorker->piBlockedNext[i]);
+			}
+
+			if (TRUE == isBlocked)
+			{
+				continue;
+			}
+
+			if (OK != ssspRelax(pstWorkspace, nextVertex, distance + pstTraverser->distance))
+			{
+				return ERR;
+			}
+			pstWorkspace->piPredecessor[nextVertex] = vertex;
+		}
+	}
+
+	return INFINITY;
+}
+
+/* Finds the spur path which leaves the last accepted path at its spurIndex-th vertex. The
+root is the path up to there: its other vertices are blocked, and so is the next edge of
+every accepted path with the same root. A new path goes to the candidates */
+int runYenSpur(YenWorker *pstWorker, int spurIndex)
+{
+	YenCtx *pstCtx = pstWorker->pstCtx;
+	YenPath *pstLast = &pstCtx->pstAccepted->pstPaths[pstCtx->pstAccepted->noOfPaths - 1];
+	YenPath *pstAccepted = NULL_PTR;
+	YenPath stPath;
+	int i, spur = pstLast->piVertices[spurIndex], rootDistance = pstLast->piPrefix[spurIndex];
+	int spurDistance, spurLength, noOfBlockedNext = 0, retVal = OK;
+
+	pstWorker->stamp++;
+	for (i = 0; i < spurIndex; i++)
+	{
+		pstWorker->piBlocked[pstLast->piVertices[i]] = pstWorker->stamp;
+	}
+
+	for (i = 0; i < pstCtx->pstAccepted->noOfPaths; i++)
+	{
+		pstAccepted = &pstCtx->pstAccepted->pstPaths[i];
+		if ((pstAccepted->noOfVertices > spurIndex + 1)
+			&& (0 == memcmp(pstAccepted->piVertices, pstLast->piVertices, sizeof(int) * (spurIndex + 1))))
+		{
+			pstWorker->piBlockedNext[noOfBlockedNext++] = pstAccepted->piVertices[spurIndex + 1];
+		}
+	}
+
+	/* Prune with the bound of the round */
+	spurDistance = yenSpurSearch(pstWorker, pstCtx->pstAdjList, spur, pstCtx->target, noOfBlockedNext,
+		(INFINITY == pstCtx->bound) ? INFINITY : (pstCtx->bound - rootDistance));
+	pstWorker->noOfSearches++;
+	pstWorker->noOfSettled += pstWorker->pstWorkspace->noOfSettled;
+
+	if ((ERR == spurDistance) || (INFINITY == spurDistance))
+	{
+		return (ERR == spurDistance) ? ERR : OK;
+	}
+
+	spurLength = ssspGetPath(pstWorker->pstWorkspace, spur, pstCtx->target, pstWorker->piPath);
+	if (ERR == spurLength)
+	{
+		return ERR;
+	}
+
+	stPath.noOfVertices = spurIndex + spurLength;
+	stPath.distance = rootDistance + spurDistance;
+	stPath.piVertices = (int *)malloc(sizeof(int) * stPath.noOfVertices);
+	stPath.piPrefix = (int *)malloc(sizeof(int) * stPath.noOfVertices);
+
+	if ((NULL_PTR == stPath.piVertices) || (NULL_PTR == stPath.piPrefix))
+	{
+		myLog(ERROR, "malloc failed!");
+		free(stPath.piVertices);
+		free(stPath.piPrefix);
+		return ERR;
+	}
+
+	(void)memcpy(stPath.piVertices, pstLast->piVertices, sizeof(int) * spurIndex);
+	(void)memcpy(stPath.piPrefix, pstLast->piPrefix, sizeof(int) * spurIndex);
+	for (i = 0; i < spurLength; i++)
+	{
+		stPath.piVertices[spurIndex + i] = pstWorker->piPath[i];
+		stPath.piPrefix[spurIndex + i] = rootDistance + pstWorker->pstWorkspace->piDist[pstWorker->piPath[i]];
+	}
+
+	pthread_mutex_lock(&pstCtx->lock);
+	if (TRUE == hasYenPath(pstCtx->pstCandidates, &stPath))
+	{
+		retVal = FALSE;
+	}
+	else
+	{
+		retVal = addYenPath(pstCtx->pstCandidates, &stPath);
+	}
+	pthread_mutex_unlock(&pstCtx->lock);
+
+	if (OK != retVal)
+	{
+		free(stPath.piVertices);
+		free(stPath.piPrefix);
+	}
+
+	return (ERR == retVal) ? ERR : OK;
+}
+
+/* Worker loop. Takes the next spur vertex of the round until all are done */
+void* yenWorker(void *pArg)
+{
+	YenWorker *pstWorker = (YenWorker *)pArg;
+	YenCtx *pstCtx = pstWorker->pstCtx;
+	int spurIndex, noOfSpurs;
+
+	noOfSpurs = pstCtx->pstAccepted->pstPaths[pstCtx->pstAccepted->noOfPaths - 1].noOfVertices - 1;
+
+	while (FALSE == pstCtx->hasFailed)
+	{
+		spurIndex = __sync_fetch_and_add(&pstCtx->nextSpur, 1);
+		if (spurIndex >= noOfSpurs)
+		{
+			break;
+		}
+
+		if (OK != runYenSpur(pstWorker, spurIndex))
+		{
+			myLog(ERROR, "runYenSpur failed for spur [%d]!", spurIndex);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+	}
+
+	return NULL_PTR;
+}
+
+/* Returns the longest distance a new candidate may have and still be one of the
+noOfNeeded paths still to accept: the noOfNeeded-th shortest candidate, INFINITY if there
+are not that many */
+int getYenBound(YenPathList *pstCandidates, int noOfNeeded, int *piScratch)
+{
+	int i, j, swap;
+
+	if (pstCandidates->noOfPaths < noOfNeeded)
+	{
+		return INFINITY;
+	}
+
+	for (i = 0; i < pstCandidates->noOfPaths; i++)
+	{
+		piScratch[i] = pstCandidates->pstPaths[i].distance;
+	}
+
+	/* Partial selection sort, noOfNeeded is small */
+	for (i = 0; i < noOfNeeded; i++)
+	{
+		for (j = i + 1; j < pstCandidates->noOfPaths; j++)
+		{
+			if (piScratch[j] < piScratch[i])
+			{
+				swap = piScratch[i];
+				piScratch[i] = piScratch[j];
+				piScratch[j] = swap;
+			}
+		}
+	}
+
+	return piScratch[noOfNeeded - 1];
+}
+
+/* Runs the spur searches of one round over the workers. Returns OK or ERR */
+int runYenRound(YenCtx *pstCtx, YenWorker *pstWorkers, int noOfThreads)
+{
+	pthread_t aThreads[MAX_WORKER_THREADS];
+	int i, noOfStarted = 0;
+
+	pstCtx->nextSpur = 0;
+
+	for (i = 0; i < noOfThreads; i++)
+	{
+		if (0 != pthread_create(&aThreads[i], NULL, yenWorker, &pstWorkers[i]))
+		{
+			myLog(ERROR, "pthread_create failed for worker [%d]!", i);
+			pstCtx->hasFailed = TRUE;
+			break;
+		}
+		noOfStarted++;
+	}
+
+	for (i = 0; i < noOfStarted; i++)
+	{
+		pthread_join(aThreads[i], NULL);
+	}
+
+	return (TRUE == pstCtx->hasFailed) ? ERR : OK;
+}
+
+/* Finds the shortest path with the first worker and accepts it. Returns OK, or ERR on
+failure. No path is accepted if target is not reachable */
+int findFirstYenPath(YenCtx *pstCtx, YenWorker *pstWorker, int source)
+{
+	YenPath stPath;
+	int i, distance;
+
+	/* Nothing blocked: a fresh stamp matches no vertex */
+	pstWorker->stamp++;
+	distance = yenSpurSearch(pstWorker, pstCtx->pstAdjList, source, pstCtx->target, 0, INFINITY);
+	if ((ERR == distance) || (INFINITY == distance))
+	{
+		return (ERR == distance) ? ERR : OK;
+	}
+
+	stPath.noOfVertices = ssspGetPath(pstWorker->pstWorkspace, source, pstCtx->target, pstWorker->piPath);
+	stPath.distance = distance;
+	stPath.piVertices = (int *)malloc(sizeof(int) * MAX(stPath.noOfVertices, 1));
+	stPath.piPrefix = (int *)malloc(sizeof(int) * MAX(stPath.noOfVertices, 1));
+
+	if ((ERR == stPath.noOfVertices) || (NULL_PTR == stPath.piVertices) || (NULL_PTR == stPath.piPrefix))
+	{
+		myLog(ERROR, "Failed to store the shortest path!");
+		free(stPath.piVertices);
+		free(stPath.piPrefix);
+		return ERR;
+	}
+
+	for (i = 0; i < stPath.noOfVertices; i++)
+	{
+		stPath.piVertices[i] = pstWorker->piPath[i];
+		stPath.piPrefix[i] = pstWorker->pstWorkspace->piDist[pstWorker->piPath[i]];
+	}
+
+	if (OK != addYenPath(pstCtx->pstAccepted, &stPath))
+	{
+		free(stPath.piVertices);
+		free(stPath.piPrefix);
+		return ERR;
+	}
+
+	return OK;
+}
+
+/* Checks that a path is loopless, starts and ends right, and that its edges add up to its
+distance. Returns TRUE if so */
+int isValidYenPath(AdjList *pstAdjList, YenPath *pstPath, int source, int target, char *pSeen)
+{
+	int i, isValid = TRUE;
+
+	isValid = (pstPath->piVertices[0] == source) && (pstPath->piVertices[pstPath->noOfVertices - 1] == target)
+		&& (getBatchPathDistance(pstAdjList, pstPath->piVertices, pstPath->noOfVertices) == pstPath->distance);
+
+	for (i = 0; i < pstPath->noOfVertices; i++)
+	{
+		isValid = isValid && (FALSE == pSeen[pstPath->piVertices[i]]);
+		pSeen[pstPath->piVertices[i]] = TRUE;
+	}
+
+	for (i = 0; i < pstPath->noOfVertices; i++)
+	{
+		pSeen[pstPath->piVertices[i]] = FALSE;
+	}
+
+	return isValid;
+}
+
+/* Entry function for k shortest paths mode. Prints the k shortest loopless paths from
+source to destination in the graph in fileName, with the time each one took */
+int yenProc(int scheme, char *fileName, char *sourceArg, char *destinationArg, char *kArg,
+	char *threadsArg)
+{
+	AdjList *pstAdjList = NULL_PTR;
+	YenWorker aWorkers[MAX_WORKER_THREADS];
+	YenPathList stAccepted, stCandidates, stEarlier;
+	YenPath *pstPath = NULL_PTR;
+	YenCtx stCtx;
+	char *pSeen = NULL_PTR;
+	int *piScratch = NULL_PTR;
+	long long startTime, roundUsec, totalUsec = 0, noOfSearches = 0, noOfSettled = 0, searches;
+	int i, j, best, source, noOfPaths = DEFAULT_YEN_PATHS, noOfThreads, noOfInvalid = 0, retVal = OK;
+
+	if (NULL_PTR != kArg)
+	{
+		noOfPaths = atoi(kArg);
+	}
+
+	source = atoi(sourceArg);
+	noOfThreads = getWorkerThreadCount(threadsArg);
+
+	if (noOfPaths <= 0)
+	{
+		myLog(ERROR, "Invalid Input! k must be positive");
+		return ERR;
+	}
+
+	pstAdjList = loadAdjListFromFile(fileName, MAX_LARGE_VERTEX_NUM);
+	if (NULL_PTR == pstAdjList)
+	{
+		myLog(ERROR, "loadAdjListFromFile failed!");
+		return ERR;
+	}
+
+	(void)memset(aWorkers, 0, sizeof(aWorkers));
+	(void)memset(&stAccepted, 0, sizeof(stAccepted));
+	(void)memset(&stCandidates, 0, sizeof(stCandidates));
+	(void)memset(&stEarlier, 0, sizeof(stEarlier));
+	(void)memset(&stCtx, 0, sizeof(stCtx));
+	pthread_mutex_init(&stCtx.lock, NULL);
+	stCtx.pstAdjList = pstAdjList;
+	stCtx.target = atoi(destinationArg);
+	stCtx.pstAccepted = &stAccepted;
+	stCtx.pstCandidates = &stCandidates;
+
+	if ((source < 0) || (source >= gNoOfVertex) || (stCtx.target < 0) || (stCtx.target >= gNoOfVertex))
+	{
+		myLog(ERROR, "Vertex out of range! Vertices: [%d]", gNoOfVertex);
+		retVal = ERR;
+	}
+
+	for (i = 0; (i < noOfThreads) && (OK == retVal); i++)
+	{
+		aWorkers[i].pstCtx = &stCtx;
+		aWorkers[i].pstWorkspace = createSsspWorkspace(scheme, gNoOfVertex);
+		aWorkers[i].piBlocked = (int *)calloc(gNoOfVertex, sizeof(int));
+		aWorkers[i].piBlockedNext = (int *)malloc(sizeof(int) * noOfPaths);
+		aWorkers[i].piPath = (int *)malloc(sizeof(int) * gNoOfVertex);
+
+		if ((NULL_PTR == aWorkers[i].pstWorkspace) || (NULL_PTR == aWorkers[i].piBlocked)
+			|| (NULL_PTR == aWorkers[i].piBlockedNext) || (NULL_PTR == aWorkers[i].piPath)
+			|| (OK != ssspEnablePredecessors(aWorkers[i].pstWorkspace)))
+		{
+			myLog(ERROR, "Failed to allocate worker [%d]!", i);
+			retVal = ERR;
+		}
+	}
+
+	pSeen = (char *)calloc(gNoOfVertex, sizeof(char));
+	if ((OK == retVal) && (NULL_PTR == pSeen))
+	{
+		myLog(ERROR, "calloc failed!");
+		retVal = ERR;
+	}
+
+	if (OK == retVal)
+	{
+		startTime = getWallTimeUsec();
+		retVal = findFirstYenPath(&stCtx, &aWorkers[0], source);
+		totalUsec = getWallTimeUsec() - startTime;
+
+		if ((OK == retVal) && (0 == stAccepted.noOfPaths))
+		{
+			printf("%d -> %d: -\n", source, stCtx.target);
+		}
+		else if (OK == retVal)
+		{
+			printf("\n%s: [%d] paths from [%d] to [%d], [%d] threads\n"
+				"k 1: [%d] with [%d] vertices, [%lld] usec\n",
+				schemeString[scheme], noOfPaths, source, stCtx.target, noOfThreads,
+				stAccepted.pstPaths[0].distance, stAccepted.pstPaths[0].noOfVertices, totalUsec);
+		}
+	}
+
+	for (i = 1; (i < noOfPaths) && (OK == retVal) && (stAccepted.noOfPaths == i); i++)
+	{
+		startTime = getWallTimeUsec();
+
+		free(piScratch);
+		piScratch = (int *)malloc(sizeof(int) * MAX(stCandidates.noOfPaths, 1));
+		if (NULL_PTR == piScratch)
+		{
+			myLog(ERROR, "malloc failed!");
+			retVal = ERR;
+			break;
+		}
+
+		stCtx.bound = getYenBound(&stCandidates, noOfPaths - i, piScratch);
+		retVal = runYenRound(&stCtx, aWorkers, noOfThreads);
+		if ((OK != retVal) || (0 == stCandidates.noOfPaths))
+		{
+			break;
+		}
+
+		/* The shortest candidate is the next path */
+		best = 0;
+		for (j = 1; j < stCandidates.noOfPaths; j++)
+		{
+			best = (stCandidates.pstPaths[j].distance < stCandidates.pstPaths[best].distance) ? j : best;
+		}
+
+		retVal = addYenPath(&stAccepted, &stCandidates.pstPaths[best]);
+		stCandidates.pstPaths[best] = stCandidates.pstPaths[--stCandidates.noOfPaths];
+
+		roundUsec = getWallTimeUsec() - startTime;
+		totalUsec += roundUsec;
+
+		searches = noOfSearches;
+		noOfSearches = 0;
+		for (j = 0; j < noOfThreads; j++)
+		{
+			noOfSearches += aWorkers[j].noOfSearches;
+		}
+
+		pstPath = &stAccepted.pstPaths[i];
+		printf("k %d: [%d] with [%d] vertices, [%lld] usec, [%lld] spur searches, bound [%d]\n", i + 1,
+			pstPath->distance, pstPath->noOfVertices, roundUsec, noOfSearches - searches, stCtx.bound);
+	}
+
+	if ((OK == retVal) && (stAccepted.noOfPaths > 0))
+	{
+		for (i = 0; i < stAccepted.noOfPaths; i++)
+		{
+			pstPath = &stAccepted.pstPaths[i];
+			printf("%d: %d Path:", i + 1, pstPath->distance);
+			for (j = 0; j < pstPath->noOfVertices; j++)
+			{
+				printf(" %d", pstPath->piVertices[j]);
+			}
+			printf("\n");
+
+			/* The earlier paths, to check this one is new */
+			stEarlier.pstPaths = stAccepted.pstPaths;
+			stEarlier.noOfPaths = i;
+
+			noOfInvalid += (FALSE == isValidYenPath(pstAdjList, pstPath, source, stCtx.target, pSeen))
+				|| ((i > 0) && (pstPath->distance < stAccepted.pstPaths[i - 1].distance))
+				|| (TRUE == hasYenPath(&stEarlier, pstPath));
+		}
+
+		for (j = 0; j < noOfThreads; j++)
+		{
+			noOfSettled += aWorkers[j].noOfSettled;
+		}
+
+		printf("\n[%d] paths in [%lld] usec, [%.1f] paths per sec, [%lld] spur searches settling [%lld] vertices\n",
+			stAccepted.noOfPaths, totalUsec,
+			(totalUsec > 0) ? ((1000000.0 * stAccepted.noOfPaths) / totalUsec) : 0.0,
+			noOfSearches, noOfSettled);
+
+		if (noOfInvalid > 0)
+		{
+			myLog(ERROR, "[%d] paths are not valid loopless paths in order!", noOfInvalid);
+			retVal = ERR;
+		}
+	}
+
+	for (i = 0; i < noOfThreads; i++)
+	{
+		destroySsspWorkspace(aWorkers[i].pstWorkspace);
+		free(aWorkers[i].piBlocked);
+		free(aWorkers[i].piBlockedNext);
+		free(aWorkers[i].piPath);
+	}
+
+	pthread_mutex_destroy(&stCtx.lock);
+	destroyYenPathList(&stAccepted);
+	destroyYenPathList(&stCandidates);
+	free(piScratch);
+	free(pSeen);
+	destroyAdjList(pstAdjList);
+
+	return retVal;
+}
@@ -0,0 +1,30 @@
+/***************************************************************************************************/
+// YEN.H
+// Contains the paths of the k shortest loopless paths mode
+/***************************************************************************************************/
+
+#ifndef __YEN__
+#define __YEN__
+
+#include "header.h"
+
+#define DEFAULT_YEN_PATHS 10
+
+/* A loopless path. piPrefix[i] is the distance from the first vertex to piVertices[i] */
+typedef struct YenPath
+{
+	int noOfVertices;
+	int distance;
+	int *piVertices;
+	int *piPrefix;
+}YenPath;
+
+/* Growable list of paths, for the accepted paths and for the candidates */
+typedef struct YenPathList
+{
+	YenPath *pstPaths;
+	int noOfPaths;
+	int capacity;
+}YenPathList;
+
+#endif